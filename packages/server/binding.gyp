@@ -7,7 +7,28 @@
         "src/native/orderbook.cpp",
         "src/native/aggregator.cpp",
         "src/native/vwaf.cpp",
-        "src/native/wall_detector.cpp"
+        "src/native/wall_detector.cpp",
+        "src/native/matching_engine.cpp",
+        "src/native/risk_engine.cpp",
+        "src/native/shared_mirror.cpp",
+        "src/native/snapshot_diff.cpp",
+        "src/native/symbol_registry.cpp",
+        "src/native/simd_depth.cpp",
+        "src/native/sequence_guard.cpp",
+        "src/native/book_checksum.cpp",
+        "src/native/clock.cpp",
+        "src/native/book_journal.cpp",
+        "src/native/journal_replay.cpp",
+        "src/native/state_snapshot.cpp",
+        "src/native/depth_history.cpp",
+        "src/native/candle_engine.cpp",
+        "src/native/trade_flow.cpp",
+        "src/native/trade_tape.cpp",
+        "src/native/pg_copy.cpp",
+        "src/native/book_signals.cpp",
+        "src/native/bbo_tracker.cpp",
+        "src/native/lead_lag.cpp",
+        "src/native/wall_tracker.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -26,6 +47,9 @@
           "AdditionalOptions": [ "/std:c++17", "/O2" ]
         }
       },
+      "conditions": [
+        [ "OS=='linux'", { "libraries": [ "-lrt" ] } ]
+      ],
       "xcode_settings": {
         "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
         "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
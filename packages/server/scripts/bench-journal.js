@@ -0,0 +1,30 @@
+import bindings from 'bindings';
+import { mkdtempSync, rmSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+
+const core = bindings('terminus_core');
+
+const events = Number(process.argv[2] ?? 2_000_000);
+const dir = mkdtempSync(join(tmpdir(), 'terminus-journal-'));
+
+console.log('--- Native Book Journal Benchmark ---');
+console.log(`Events: ${events.toLocaleString()} deltas (1-4 levels per side, 3 exchanges) → ${dir}`);
+
+// Warm-up pass so page faults on the ring and first segment don't skew the run
+core.benchJournal(dir, 100_000);
+
+const r = core.benchJournal(dir, events);
+console.log(`Throughput: ${Math.round(r.events_per_sec).toLocaleString()} events/sec sustained (${r.mb_per_sec.toFixed(1)} MB/s to disk)`);
+console.log(`Producer:   ${Math.round(r.produce_per_sec).toLocaleString()} events/sec  p50=${r.p50_ns}ns  p99=${r.p99_ns}ns  p99.9=${r.p999_ns}ns`);
+console.log(`Records:    ${r.bytes_per_event.toFixed(1)} bytes/event  segments=${r.segments}  ring peak=${r.ring_peak.toLocaleString()}B  dropped=${r.dropped}`);
+
+rmSync(dir, { recursive: true, force: true });
+
+if (r.dropped === 0 && r.events_per_sec > 500_000) {
+    console.log('✅ > 500k journaled events/sec, nothing dropped');
+} else {
+    console.log('⚠️ Journal fell behind');
+}
+
+console.log('--- DONE ---');
@@ -0,0 +1,24 @@
+import bindings from 'bindings';
+
+const core = bindings('terminus_core');
+
+const ops = Number(process.argv[2] ?? 1_000_000);
+
+console.log('--- Internal Matching Engine Benchmark ---');
+console.log(`Ops: ${ops.toLocaleString()} (75% limit / 25% cancel)`);
+
+// Warm-up pass so page faults on the order slab don't skew the run
+core.benchMatching(100_000);
+
+const r = core.benchMatching(ops);
+console.log(`Throughput: ${Math.round(r.orders_per_sec).toLocaleString()} orders/sec`);
+console.log(`Latency:    p50=${r.p50_ns}ns  p99=${r.p99_ns}ns  p99.9=${r.p999_ns}ns  max=${r.max_ns}ns`);
+console.log(`Fills:      ${r.fills.toLocaleString()}   resting at end: ${r.resting.toLocaleString()}`);
+
+if (r.orders_per_sec > 1_000_000) {
+    console.log('✅ > 1M orders/sec');
+} else {
+    console.log('⚠️ Below 1M orders/sec');
+}
+
+console.log('--- DONE ---');
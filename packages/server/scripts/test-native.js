@@ -1,4 +1,7 @@
 import bindings from 'bindings';
+import { mkdtempSync, readdirSync, rmSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
 
 const core = bindings('terminus_core');
 
@@ -23,13 +26,589 @@ if (filtered.length === input.length) {
     console.log('✅ Kalman 1D output length matches');
 }
 
+// Internal matching: two asks at 101 fill in arrival order, the taker's
+// remainder rests at its limit, and a cancel pulls it; a live order's
+// id can't be reused
+core.submitOrder(1, 10, 'sell', 101, 3);
+core.submitOrder(2, 11, 'sell', 101, 2);
+core.submitOrder(3, 12, 'sell', 102, 5);
+const take = core.submitOrder(4, 20, 'buy', 101, 7);
+const rested = core.getMatchingBook('buy', 101);
+const cancelled = core.cancelOrder(4);
+const cancelledAgain = core.cancelOrder(4);
+const afterCancel = core.getMatchingBook('buy', 101);
+const partial = core.submitOrder(5, 21, 'buy', 102, 2);
+const askLeft = core.getMatchingBook('sell', 102);
+console.log(`Matching: ${take.status} fills=${take.fills.map(f => `${f.maker}x${f.qty}@${f.price}`).join(',')} ` +
+    `rested=${rested.depth} cancel=${cancelled},${cancelledAgain} ask102=${askLeft.depth}`);
+if (take.status === 'partial' && take.fills.length === 2 &&
+    take.fills[0].maker === 1 && take.fills[0].qty === 3 && take.fills[1].maker === 2 && take.fills[1].qty === 2 &&
+    take.fills.every(f => f.price === 101 && f.side === 'buy' && f.takerAccount === 20) &&
+    rested.depth === 2 && rested.bestBid === 101 && rested.bestAsk === 102 &&
+    cancelled && !cancelledAgain && afterCancel.depth === 0 && afterCancel.bestBid === 0 &&
+    partial.status === 'filled' && partial.fills[0].maker === 3 && askLeft.depth === 3 &&
+    core.submitOrder(3, 13, 'sell', 103, 1).status === 'rejected' && core.submitOrder(6, 21, 'buy', 100, 0).status === 'rejected') {
+    console.log('✅ Matching engine checks passed');
+} else {
+    console.log('❌ Matching engine checks failed');
+}
+core.cancelOrder(3);
+
+// Risk booking: both sides of every fill move positions; selling 2 of
+// account 20's 5 @101 at 103 realises 2 × 2 on its 1000000 wallet
+core.submitOrder(7, 30, 'buy', 103, 2);
+core.submitOrder(8, 20, 'sell', 103, 2);
+const taker = core.getRiskAccount(20), maker = core.getRiskAccount(10), buyer = core.getRiskAccount(30);
+console.log(`Risk: taker=${JSON.stringify(taker)} maker=${JSON.stringify(maker)} buyer=${JSON.stringify(buyer)}`);
+if (taker?.position === 3 && taker.entryPrice === 101 && taker.balance === 1000004 && !taker.frozen &&
+    maker?.position === -3 && maker.entryPrice === 101 && buyer?.position === 2 && buyer.entryPrice === 103 &&
+    core.getRiskAccount(99) === null) {
+    console.log('✅ Risk booking checks passed');
+} else {
+    console.log('❌ Risk booking checks failed');
+}
+
 // Test Orderbook structure (Aggregated Snapshot)
 console.log('Testing GetAggregated...');
-const snap = core.getAggregated();
+const btc = core.registerSymbol('BTCUSDT');
+const snap = core.getAggregated(btc);
 console.log('Snapshot keys:', Object.keys(snap));
 console.log('Snapshot best_bid:', snap.best_bid);
 if (snap.hasOwnProperty('bids') && snap.hasOwnProperty('asks')) {
     console.log('✅ Aggregated structure valid');
 }
 
+// Version-gated reads: nothing new since a version → null; a delta
+// publishes a fresh snapshot under a higher version
+const mir = core.registerSymbol('MIRUSDT');
+core.initSnapshot(mir, 'binance', [['10', '1']], [['11', '1']]);
+const m1 = core.getAggregatedIfNewer(mir, 0);
+const mSame = core.getAggregatedIfNewer(mir, m1.version);
+core.applyDelta(mir, 'binance', [['10.5', '2']], []);
+const m2 = core.getAggregatedIfNewer(mir, m1.version);
+console.log(`Mirror: v${m1?.version} bid=${m1?.best_bid} same=${mSame} v${m2?.version} bid=${m2?.best_bid}`);
+if (m1 && m1.best_bid === 10 && mSame === null && m2 && m2.version > m1.version && m2.best_bid === 10.5 &&
+    core.getAggregatedIfNewer(mir, m2.version) === null) {
+    console.log('✅ State mirror checks passed');
+} else {
+    console.log('❌ State mirror checks failed');
+}
+core.clearSymbol(mir);
+
+// Shared-memory mirror: two symbols publish into their own segments and
+// each reader keeps returning its own symbol's book
+const shmA = core.registerSymbol('SHAUSDT'), shmB = core.registerSymbol('SHBUSDT');
+const shmName = (tag) => `/terminus_test_${process.pid}_${tag}`;
+const shmOpen = core.enableSharedMirror(shmA, shmName('a')) && core.enableSharedMirror(shmB, shmName('b'));
+core.initSnapshot(shmA, 'binance', [['20', '1']], [['21', '1']]);
+core.initSnapshot(shmB, 'binance', [['30', '1']], [['31', '1']]);
+core.getAggregatedIfNewer(shmA, 0);
+core.getAggregatedIfNewer(shmB, 0);
+const readerA = core.attachSharedMirror(shmName('a')), readerB = core.attachSharedMirror(shmName('b'));
+const rA1 = core.readSharedMirror(readerA, 0), rB1 = core.readSharedMirror(readerB, 0);
+core.applyDelta(shmA, 'binance', [['20.5', '1']], []);
+core.getAggregatedIfNewer(shmA, 0);
+const rA2 = core.readSharedMirror(readerA, rA1?.version), rB2 = core.readSharedMirror(readerB, rB1?.version);
+console.log(`Shared mirror: a=${rA1?.best_bid}→${rA2?.best_bid} b=${rB1?.best_bid}→${rB2?.best_bid ?? 'unchanged'}`);
+if (shmOpen && readerA !== null && readerB !== null && readerA !== readerB &&
+    rA1?.best_bid === 20 && rB1?.best_bid === 30 && rA2?.best_bid === 20.5 && rA2.version > rA1.version && rB2 === null &&
+    core.readSharedMirror(readerB, 0)?.best_bid === 30 && core.attachSharedMirror(shmName('missing')) === null) {
+    console.log('✅ Shared mirror checks passed');
+} else {
+    console.log('❌ Shared mirror checks failed');
+}
+core.detachSharedMirror(readerA);
+core.detachSharedMirror(readerB);
+core.clearSymbol(shmA);
+core.clearSymbol(shmB);
+
+// Diffed broadcasts: each version ships only what moved since the
+// client's, removed levels as qty 0; once a removal it hasn't seen ages
+// out of the tombstone window, a client gets the whole book again
+const dif = core.registerSymbol('DIFUSDT');
+core.initSnapshot(dif, 'binance', [['10', '1'], ['9', '1']], [['11', '1']]);
+const d1 = core.getAggregatedDiff(dif, 0);
+core.applyDelta(dif, 'binance', [['9.5', '2']], []);
+const d2 = core.getAggregatedDiff(dif, d1.version);
+core.applyDelta(dif, 'binance', [['9', '0']], [['11', '3']]);
+const d3 = core.getAggregatedDiff(dif, d2.version);
+const d13 = core.getAggregatedDiff(dif, d1.version);
+const dNone = core.getAggregatedDiff(dif, d3.version);
+for (let i = 0; i < 300; i++) {
+    core.applyDelta(dif, 'binance', [], [['12', String(1 + (i % 2))]]);
+    core.getAggregatedDiff(dif, 0);
+}
+const dStale = core.getAggregatedDiff(dif, d2.version);   // 9's tombstone is gone
+const dKept = core.getAggregatedDiff(dif, d3.version);    // saw the removal: still diffable
+console.log(`Diff: v${d1.version} full=${d1.full} +${JSON.stringify(d2.bids)} then ${JSON.stringify(d3.bids)}/${JSON.stringify(d3.asks)} ` +
+    `stale full=${dStale.full} bids=${dStale.bids.length}`);
+if (d1.full && d1.bids.length === 2 && !d2.full && d2.from === d1.version &&
+    JSON.stringify(d2.bids) === '[[9.5,2]]' && d2.asks.length === 0 &&
+    JSON.stringify(d3.bids) === '[[9,0]]' && JSON.stringify(d3.asks) === '[[11,3]]' &&
+    !d13.full && JSON.stringify(d13.bids) === '[[9.5,2],[9,0]]' && dNone === null &&
+    dStale.full && dStale.version > d3.version + 256 && JSON.stringify(dStale.bids) === '[[10,1],[9.5,2]]' &&
+    !dKept.full && dKept.bids.length === 0 && dKept.asks.length === 1) {
+    console.log('✅ Snapshot diff checks passed');
+} else {
+    console.log('❌ Snapshot diff checks failed');
+}
+core.clearSymbol(dif);
+
+// Bucketed depth: both venues fold into buckets anchored on the
+// consolidated touch, bids floored and asks ceiled to each step
+const bkt = core.registerSymbol('BKTUSDT');
+core.initSnapshot(bkt, 'binance', [['100.5', '1'], ['100', '2'], ['99.99', '3'], ['99', '4'], ['95', '5']],
+    [['101', '1'], ['102', '3'], ['106', '4']]);
+core.initSnapshot(bkt, 'okx', [['100.2', '1']], [['101.5', '2']]);
+const bd = core.getBucketedDepth(bkt, [1, 5], 4);
+const [b1, b5] = bd.resolutions;
+console.log(`Buckets: step1 bids=${Array.from(b1.bids)}@${b1.bid_start} asks=${Array.from(b1.asks)}@${b1.ask_start} ` +
+    `step5 bids=${Array.from(b5.bids)}@${b5.bid_start} asks=${Array.from(b5.asks)}@${b5.ask_start}`);
+if (bd.best_bid === 100.5 && bd.best_ask === 101 && bd.resolutions.length === 2 &&
+    b1.step === 1 && b1.bid_start === 100 && b1.ask_start === 101 &&
+    Array.from(b1.bids).join() === '4,7,0,0' && Array.from(b1.asks).join() === '1,5,0,0' &&
+    b5.step === 5 && b5.bid_start === 100 && b5.ask_start === 105 &&
+    Array.from(b5.bids).join() === '4,12,0,0' && Array.from(b5.asks).join() === '6,4,0,0') {
+    console.log('✅ Bucketed depth checks passed');
+} else {
+    console.log('❌ Bucketed depth checks failed');
+}
+core.clearSymbol(bkt);
+
+// Test symbol registry — books of different symbols stay independent
+const eth = core.registerSymbol('ETHUSDT');
+core.initSnapshot(btc, 'binance', [['63500.50', '1']], [['63501.00', '1']]);
+core.initSnapshot(eth, 'binance', [['3100.25', '5']], [['3100.50', '5']]);
+const btcBid = core.getAggregated(btc).best_bid;
+const ethBid = core.getAggregated('ETHUSDT').best_bid;
+console.log(`Registry: ${JSON.stringify(core.listSymbols())} btc=${btcBid} eth=${ethBid}`);
+if (core.registerSymbol('BTCUSDT') === btc && btcBid === 63500.5 && ethBid === 3100.25) {
+    console.log('✅ Symbol registry checks passed');
+} else {
+    console.log('❌ Symbol registry checks failed');
+}
+core.clearSymbol(btc);
+core.clearSymbol(eth);
+
+// Test per-instrument price scale — 4-decimal levels must stay distinct
+const sol = core.registerSymbol('SOLUSDT');
+const spec = core.setInstrument(sol, { tickSize: 0.0001 });
+core.initSnapshot(sol, 'binance', [['142.1234', '1'], ['142.1233', '2']], [['142.1240', '1']]);
+const solBook = core.getAggregated(sol);
+console.log(`Instrument: scale=${spec.price_scale} bids=${JSON.stringify(solBook.bids)}`);
+if (spec.price_scale === 10000 && solBook.bids.length === 2 && solBook.best_bid === 142.1234) {
+    console.log('✅ Price scale checks passed');
+} else {
+    console.log('❌ Price scale checks failed');
+}
+
+// Fixed-point lots: 0.1 + 0.2 must sum exactly, and cumulative depth runs
+const lotSpec = core.setInstrument(sol, { lotSize: 0.00000001 });
+core.applyDelta(sol, 'binance', [['142.1232', '0.1'], ['142.1231', '0.2']], []);
+const cum = core.getCumulativeDepth(sol);
+console.log(`Lots: qty_scale=${lotSpec.qty_scale} bid_cum=${Array.from(cum.bid_cum)}`);
+if (lotSpec.qty_scale === 100000000 && cum.bid_cum.length === 4 && cum.bid_cum[3] === 3.3) {
+    console.log('✅ Fixed-point quantity checks passed');
+} else {
+    console.log('❌ Fixed-point quantity checks failed');
+}
+
+// Running depth: totals and bps bands follow every delta
+core.setDepthBands(sol, [1, 10]);
+const before = core.getDepthStats(sol);
+core.applyDelta(sol, 'binance', [['142.1234', '0']], []);
+const after = core.getDepthStats(sol);
+console.log(`Depth: before=${JSON.stringify(before.bid)} after=${JSON.stringify(after.bid)}`);
+if (before.bid.total === 3.3 && after.bid.total === 2.3 && after.bid.bands.length === 2 && after.bid.bands[0] === 2.3) {
+    console.log('✅ Running depth checks passed');
+} else {
+    console.log('❌ Running depth checks failed');
+}
+core.clearSymbol(sol);
+
+// Sequence gaps: buffered, resync requested, replayed on the next snapshot
+const resyncs = [];
+core.onResync((symbol, exchange) => resyncs.push(`${symbol}:${exchange}`));
+const xrp = core.registerSymbol('XRPUSDT');
+core.initSnapshot(xrp, 'binance', 100, [['0.5', '10']], [['0.6', '10']]);
+const s1 = core.applySequencedDelta(xrp, 'binance', { first: 101, last: 105, prev: 99 }, [['0.51', '1']], []);
+const s2 = core.applySequencedDelta(xrp, 'binance', { first: 107, last: 110, prev: 106 }, [['0.52', '2']], []);
+const s3 = core.applySequencedDelta(xrp, 'binance', { first: 111, last: 115, prev: 110 }, [['0.53', '3']], []);
+const s4 = core.initSnapshot(xrp, 'binance', 108, [['0.5', '10'], ['0.51', '1']], [['0.6', '10']]);
+const xrpBook = core.getAggregated(xrp);
+console.log(`Sequence: ${[s1, s2, s3, s4]} resyncs=${resyncs} bids=${xrpBook.bids.length}`);
+if (s1 === 'applied' && s2 === 'gap' && s3 === 'buffered' && s4 === 'applied' &&
+    resyncs.length === 1 && xrpBook.bids.length === 4 && !core.getSyncState(xrp)[0].resyncing) {
+    console.log('✅ Sequence gap checks passed');
+} else {
+    console.log('❌ Sequence gap checks failed');
+}
+core.onResync(null);
+core.clearSymbol(xrp);
+
+// Venue checksum: OKX's documented example book → -1881014294
+const chk = core.registerSymbol('CHKUSDT');
+core.setChecksumVerify(chk, 'okx', true);
+const c1 = core.initSnapshot(chk, 'okx', 1, [['3366.1', '7'], ['3366', '6']], [['3366.8', '9'], ['3368', '8']], -1881014294);
+const c2 = core.applySequencedDelta(chk, 'okx', { last: 2, prev: 1, checksum: 12345 }, [['3366.1', '0']], []);
+const chkState = core.getChecksumState(chk)[0];
+console.log(`Checksum: ${c1} ${c2} state=${JSON.stringify(chkState)}`);
+if (c1 === 'applied' && c2 === 'checksum' && chkState.checked === 2 && chkState.mismatches === 1) {
+    console.log('✅ Book checksum checks passed');
+} else {
+    console.log('❌ Book checksum checks failed');
+}
+// clearSymbol re-arms the checksum: a fresh snapshot verifies again
+core.clearSymbol(chk);
+const chkCleared = core.getChecksumState(chk)[0];
+const c3 = core.initSnapshot(chk, 'okx', 1, [['3366.1', '7'], ['3366', '6']], [['3366.8', '9'], ['3368', '8']], -1881014294);
+console.log(`Checksum clear: last_ok=${chkCleared.last_ok} ${c3}`);
+if (chkCleared.last_ok === true && c3 === 'applied' && core.getChecksumState(chk)[0].last_ok === true) {
+    console.log('✅ Checksum clear checks passed');
+} else {
+    console.log('❌ Checksum clear checks failed');
+}
+core.clearSymbol(chk);
+
+// Simulated clock: staleness follows event time, not the wall
+const clk = core.registerSymbol('CLKUSDT');
+const t0 = core.setClock('simulated', 1700000000000);
+core.initSnapshot(clk, 'binance', [['10', '1']], [['11', '1']]);
+core.advanceClock(t0 + 4000);
+const fresh = core.getAggregated(clk);
+core.advanceClock(t0 + 6000);
+const stale = core.getAggregated(clk);
+core.setClock('real');
+console.log(`Clock: fresh=${fresh.bids.length}@${fresh.timestamp} stale=${stale.bids.length}@${stale.timestamp}`);
+if (fresh.bids.length === 1 && stale.bids.length === 0 && stale.timestamp === t0 + 6000) {
+    console.log('✅ Simulated clock checks passed');
+} else {
+    console.log('❌ Simulated clock checks failed');
+}
+core.clearSymbol(clk);
+
+// Book journal: every input lands in a segment file, starting with a checkpoint
+const journalDir = mkdtempSync(join(tmpdir(), 'terminus-journal-'));
+if (core.openJournal(journalDir, { segmentMB: 1 })) {
+    const jnl = core.registerSymbol('JNLUSDT');
+    core.initSnapshot(jnl, 'binance', [['10', '1']], [['11', '1']]);
+    core.applyDelta(jnl, 'binance', [['10', '2']], []);
+    const js = core.closeJournal();
+    const files = readdirSync(journalDir);
+    console.log(`Journal: records=${js.records} bytes=${js.bytes} checkpoints=${js.checkpoints} files=${files}`);
+    if (js.records >= 3 && js.checkpoints >= 1 && js.dropped === 0 && files.length === 1) {
+        console.log('✅ Book journal checks passed');
+    } else {
+        console.log('❌ Book journal checks failed');
+    }
+
+    // Replay rebuilds the book from the segment as fast as possible
+    const rid = core.openReplay(journalDir, 'JNLUSDT', 0);
+    const step = rid !== null ? core.replayAdvance(rid, null, 1000) : null;
+    const rb = rid !== null ? core.getReplayBook(rid, 5) : null;
+    if (rid !== null) core.closeReplay(rid);
+    console.log(`Journal replay: applied=${step?.applied} bid=${rb?.bids[0]?.price}x${rb?.bids[0]?.qty} done=${step?.done}`);
+    if (step?.done && rb?.bids[0]?.price === 10 && rb?.bids[0]?.qty === 2 && core.openReplay(journalDir, 'NOPE', 0) === null) {
+        console.log('✅ Journal replay checks passed');
+    } else {
+        console.log('❌ Journal replay checks failed');
+    }
+    core.clearSymbol(jnl);
+} else {
+    console.log('⚠️ Book journal unavailable on this platform');
+}
+rmSync(journalDir, { recursive: true, force: true });
+
+// Journal recovery: a delta too big for the ring is dropped, the next
+// record re-bases the stream with a recovery checkpoint and the replayed
+// book matches the live one again
+const recoverDir = mkdtempSync(join(tmpdir(), 'terminus-journal-'));
+if (core.openJournal(recoverDir, { segmentMB: 1, ringMB: 1 })) {
+    const rcv = core.registerSymbol('RCVUSDT');
+    core.initSnapshot(rcv, 'binance', [['10', '1']], [['11', '1']]);
+    const huge = [['9.5', '1']];
+    for (let i = 0; i < 200000; ++i) huge.push([i % 2 ? '1' : '100000000', '0']);
+    core.applyDelta(rcv, 'binance', huge, []);
+    core.applyDelta(rcv, 'binance', [['9', '3']], []);
+    const live = core.getAggregated(rcv, 5);
+    const js = core.closeJournal();
+    const rid = core.openReplay(recoverDir, 'RCVUSDT', 0);
+    if (rid !== null) core.replayAdvance(rid, null, 1000);
+    const rb = rid !== null ? core.getReplayBook(rid, 5) : null;
+    if (rid !== null) core.closeReplay(rid);
+    const levels = (b) => b?.bids.map(l => `${l.price}x${l.qty}`).join(',');
+    console.log(`Journal recovery: dropped=${js.dropped} checkpoints=${js.checkpoints} live=${levels(live)} replay=${levels(rb)}`);
+    if (js.dropped === 1 && js.checkpoints >= 2 && levels(live) === '10x1,9.5x1,9x3' && levels(rb) === levels(live)) {
+        console.log('✅ Journal recovery checks passed');
+    } else {
+        console.log('❌ Journal recovery checks failed');
+    }
+    core.clearSymbol(rcv);
+} else {
+    console.log('⚠️ Book journal unavailable on this platform');
+}
+rmSync(recoverDir, { recursive: true, force: true });
+
+// Deep replay book: asking for more levels than the output holds is
+// clamped to OUTPUT_LEVELS (50), live and replayed
+const deepDir = mkdtempSync(join(tmpdir(), 'terminus-journal-'));
+if (core.openJournal(deepDir, { segmentMB: 1 })) {
+    const dep = core.registerSymbol('DEPUSDT');
+    const ladder = (from, dir) => Array.from({ length: 300 }, (_, i) => [String(from + dir * i), '1']);
+    core.initSnapshot(dep, 'binance', ladder(1000, -1), ladder(1001, 1));
+    core.initSnapshot(dep, 'okx', ladder(999.5, -1), ladder(1001.5, 1));
+    const live = core.getAggregated(dep, 200);
+    core.closeJournal();
+    const rid = core.openReplay(deepDir, 'DEPUSDT', 0);
+    if (rid !== null) core.replayAdvance(rid, null, 1000);
+    const rb = rid !== null ? core.getReplayBook(rid, 200) : null;
+    if (rid !== null) core.closeReplay(rid);
+    console.log(`Deep replay: live=${live.bids.length}/${live.asks.length} replay=${rb?.bids.length}/${rb?.asks.length}`);
+    if (live.bids.length === 50 && live.asks.length === 50 && rb?.bids.length === 50 && rb?.asks.length === 50 &&
+        rb.bids[49].price === live.bids[49].price) {
+        console.log('✅ Deep replay checks passed');
+    } else {
+        console.log('❌ Deep replay checks failed');
+    }
+    core.clearSymbol(dep);
+} else {
+    console.log('⚠️ Book journal unavailable on this platform');
+}
+rmSync(deepDir, { recursive: true, force: true });
+
+// Warm restart: books and venue sequence ids survive a save / restore
+const stateDir = mkdtempSync(join(tmpdir(), 'terminus-state-'));
+const wrm = core.registerSymbol('WRMUSDT');
+core.initSnapshot(wrm, 'bybit', 100, [['20', '1']], [['21', '1']]);
+const saved = core.saveState(join(stateDir, 'book.state'));
+core.clearSymbol(wrm);
+const restored = core.restoreState(join(stateDir, 'book.state'));
+const wrmBid = core.getAggregated(wrm).best_bid;
+const wrmNext = core.applySequencedDelta(wrm, 'bybit', { last: 101 }, [['20', '3']], []);
+console.log(`State: saved=${saved.books} books in ${saved.ms.toFixed(2)}ms, restored=${restored.books} bid=${wrmBid} next=${wrmNext}`);
+if (saved.ok && restored.ok && restored.books >= 1 && wrmBid === 20 && wrmNext === 'applied' &&
+    core.restoreState(join(stateDir, 'none.state')).error === 'missing') {
+    console.log('✅ Warm restart checks passed');
+} else {
+    console.log('❌ Warm restart checks failed');
+}
+core.clearSymbol(wrm);
+rmSync(stateDir, { recursive: true, force: true });
+
+// Depth history: a sampled column reads back as a heatmap cell
+const historyDir = mkdtempSync(join(tmpdir(), 'terminus-depth-'));
+const hst = core.registerSymbol('HSTUSDT');
+core.initSnapshot(hst, 'binance', [['10', '1.5']], [['11', '2']]);
+if (core.enableDepthHistory(hst, historyDir, { step: 1, rowsPerSide: 8 })) {
+    const written = core.recordDepthHistory();
+    const hs = core.getDepthHistoryStats(hst);
+    const grid = core.readDepthHistory(historyDir, 'HSTUSDT', Date.now() - 60000, Date.now() + 60000, 5, 15, 1);
+    const cell = (price) => grid ? grid.qty[Math.floor((price - grid.price0) / grid.step)] : NaN;
+    console.log(`Depth history: written=${written} bytes=${hs?.bytes} rows=${grid?.rows} bid=${cell(10)} ask=${cell(11)}`);
+    if (written >= 1 && grid?.bins === 1 && cell(10) === 1.5 && cell(11) === 2 && cell(12) === 0 &&
+        core.readDepthHistory(historyDir, 'NOPE', 0, Date.now(), 5, 15) === null) {
+        console.log('✅ Depth history checks passed');
+    } else {
+        console.log('❌ Depth history checks failed');
+    }
+} else {
+    console.log('⚠️ Depth history unavailable on this platform');
+}
+core.clearSymbol(hst);
+rmSync(historyDir, { recursive: true, force: true });
+
+// Depth history at 61-bit cells: the last packed cell straddles into the
+// record's final byte and still reads back exactly
+const wideDir = mkdtempSync(join(tmpdir(), 'terminus-depth-'));
+const wde = core.registerSymbol('WDEUSDT');
+const wideQty = '600000000000';   // 6e17 lots → zigzag needs 61 bits
+core.initSnapshot(wde, 'binance', [['10', wideQty], ['9', wideQty], ['8', wideQty], ['7', wideQty]], [['11', wideQty]]);
+if (core.enableDepthHistory(wde, wideDir, { step: 1, rowsPerSide: 8 })) {
+    core.recordDepthHistory();
+    const grid = core.readDepthHistory(wideDir, 'WDEUSDT', Date.now() - 60000, Date.now() + 60000, 5, 15, 1);
+    const cell = (price) => grid ? grid.qty[Math.floor((price - grid.price0) / grid.step)] : NaN;
+    const cells = [7, 8, 9, 10, 11].map(cell);
+    console.log(`Depth history wide: cells=${cells} next=${cell(12)}`);
+    if (cells.every(q => q === Math.fround(Number(wideQty))) && cell(12) === 0) {
+        console.log('✅ Depth history wide cell checks passed');
+    } else {
+        console.log('❌ Depth history wide cell checks failed');
+    }
+} else {
+    console.log('⚠️ Depth history unavailable on this platform');
+}
+core.clearSymbol(wde);
+rmSync(wideDir, { recursive: true, force: true });
+
+// Candles: trades fold into every interval; a later window closes the last
+const cdl = core.registerSymbol('CDLUSDT');
+core.drainCandles();
+core.ingestTrade(cdl, 0, 100, 1, 60_000_000 + 5_000, 'buy');
+core.ingestTrade(cdl, 'okx', 100.5, 3, 60_000_000 + 15_000, 'sell');
+core.ingestTrade(cdl, 1, 100.2, 2, 60_000_000 + 61_000, 1);
+const cb = core.drainCandles(true);
+const closed1m = cb.data.subarray(0, cb.stride);
+const closedRows = cb.footprint.subarray(0, cb.rows * 2);
+const fpSell = closedRows.filter((_, i) => i % 2 === 1).reduce((a, b) => a + b, 0);
+console.log(`Candles: closed=${cb.closed} live=${cb.live} 1m=[${Array.from(closed1m.subarray(2, 12))}] poc=${closed1m[12]}`);
+if (cb.closed === 1 && cb.live === 8 && closed1m[0] === cdl && closed1m[1] === 60 && closed1m[2] === 60_000 &&
+    closed1m[4] === 100.5 && closed1m[7] === 4 && closed1m[8] === 401.5 && closed1m[10] === 1 && closed1m[11] === 3 &&
+    closed1m[19] === 3 && Math.abs(closed1m[12] - 100.5) < closed1m[16] && fpSell === 3 &&
+    core.getFootprint(cdl, 86400)?.buy.reduce((a, b) => a + b, 0) === 3 &&
+    core.drainCandles().data.length === 0) {
+    console.log('✅ Candle engine checks passed');
+} else {
+    console.log('❌ Candle engine checks failed');
+}
+
+// Trade flow: the same trades build CVD and rolling imbalance
+const flow = core.getTradeFlow(cdl);
+console.log(`Trade flow: cvd=${flow.total.cvd} buys=${flow.total.buys} sells=${flow.total.sells} okx=${flow.exchanges[2]?.cvd}`);
+if (flow.total.cvd === 0 && flow.total.buys === 2 && flow.total.sells === 1 && flow.exchanges[2]?.cvd === -3 &&
+    flow.total.size_count[1] === 3 && flow.windows.length === 4 && flow.windows[0].ms === 1000) {
+    console.log('✅ Trade flow checks passed');
+} else {
+    console.log('❌ Trade flow checks failed');
+}
+
+// Trade tape: columnar recent trades, range reads and resampling
+const tap = core.registerSymbol('TAPUSDT');
+core.enableTradeTape(tap, 1);
+core.ingestTrade(tap, 0, 100, 1, 60_000_000 + 1_000, 'buy');
+core.ingestTrade(tap, 'okx', 101, 2, 60_000_000 + 9_000, 'sell');
+core.ingestTrade(tap, 'kraken', 99, 3, 60_000_000 + 12_000);
+const tape = core.getTapeTrades(tap, 60_000_000, 60_000_000 + 20_000, 2, true);
+const bars = core.getTapeCandles(tap, 0, 60_000_000 + 20_000, 10_000);
+const ts = core.getTapeStats(tap);
+console.log(`Trade tape: count=${tape.count} truncated=${tape.truncated} bars=${bars.count} first=[${Array.from(bars.data.subarray(0, bars.stride))}]`);
+if (tape.count === 2 && tape.truncated && tape.price[0] === 101 && tape.exchange[0] === 2 && tape.side[0] === -1 &&
+    tape.exchange[1] === 7 && tape.side[1] === 0 && bars.count === 2 && bars.data[0] === 60_000_000 &&
+    bars.data[2] === 101 && bars.data[5] === 3 && bars.data[7] === 1 && bars.data[8] === 2 && bars.data[9] === 2 &&
+    bars.data[bars.stride] === 60_010_000 && ts.trades === 3 && ts.firstMs === 60_001_000 &&
+    core.getTapeStats(cdl).enabled === false) {
+    console.log('✅ Trade tape checks passed');
+} else {
+    console.log('❌ Trade tape checks failed');
+}
+
+// Binary COPY: payload byte-for-byte against a golden file (PostgreSQL
+// binary format, checked with struct.pack): header, two rows, trailer
+const golden = '5047434f50590aff0d0a0000000000000000000006000000080002ad22dce840780000000762696e616e636500000007425443555344540000000840e4821000000000000000083fd0000000000000000000036275790006000000080000000000000000000000036f6b78000000074254435553445400000008bff8000000000000000000080000000000000000ffffffffffff';
+const copy = core.encodeCopy(2, [
+    { type: 'timestamptz', values: new Float64Array([1700000000123, 946684800000]) },
+    { type: 'text', dict: ['binance', 'okx'], index: new Uint8Array([0, 1]) },
+    { type: 'text', dict: ['BTCUSDT'] },
+    { type: 'float8', values: new Float64Array([42000.5, -1.5]) },
+    { type: 'float8', values: new Float64Array([0.25, 0]) },
+    { type: 'text', dict: ['buy', 'sell'], index: new Uint16Array([0, 2]) }
+]);
+console.log(`Binary COPY: ${copy.length} bytes`);
+if (copy.toString('hex') === golden) {
+    console.log('✅ Binary COPY checks passed');
+} else {
+    console.log('❌ Binary COPY checks failed');
+}
+
+// Book signals: the consolidated touch sums both venues' size at 100
+// (4 vs 1 at 101) → microprice 100.8; top-1 imbalance sums each venue's
+// own best level, (3 + 1 − 1 − 2) / 7 = 1/7; binance 0.5
+const sig = core.registerSymbol('SIGUSDT');
+core.initSnapshot(sig, 'binance', [['100', '3'], ['99', '1']], [['101', '1'], ['102', '1']]);
+core.initSnapshot(sig, 'okx', [['100', '1']], [['101.5', '2']]);
+const bs = core.getBookSignals(sig);
+const bsSeries = core.getBookSignalSeries(sig);
+console.log(`Book signals: micro=${bs.total.microprice} imb=${bs.total.imbalance[0]} binance=${bs.exchanges[0].imbalance[0]} series=${bsSeries.count}`);
+if (Math.abs(bs.total.microprice - 100.8) < 1e-9 && Math.abs(bs.total.imbalance[0] - 1 / 7) < 1e-6 &&
+    Math.abs(bs.exchanges[0].imbalance[0] - 0.5) < 1e-6 && bs.total.bid === 100 && bs.total.ask === 101 &&
+    bsSeries.count >= 1 && bsSeries.data[bsSeries.stride * (bsSeries.count - 1) + 3] === bs.total.microprice) {
+    console.log('✅ Book signal checks passed');
+} else {
+    console.log('❌ Book signal checks failed');
+}
+core.clearSymbol(sig);
+
+// Cross-venue BBO: okx's bid 101 tops binance's 100.1 ask by ~89bps,
+// well past both taker fees → a cross opens on the snapshot that made
+// it, and closes when the symbol is cleared
+const bboEvents = [];
+core.onBboEvent((symbol, events) => bboEvents.push(...events.map(e => ({ symbol, ...e }))));
+const arb = core.registerSymbol('ARBUSDT');
+core.setBboConfig(arb, { feesBps: { binance: 4, okx: 5 }, deviationBps: 1000 });
+core.initSnapshot(arb, 'binance', [['100', '1']], [['100.1', '2']]);
+core.initSnapshot(arb, 'okx', [['101', '3']], [['101.1', '1']]);
+const bbo = core.getBbo(arb);
+const opened = bboEvents.find(e => e.type === 'cross');
+core.clearSymbol(arb);
+const closed = bboEvents.find(e => e.type === 'cross_end');
+core.onBboEvent(null);
+console.log(`BBO: bid=${bbo.bid} ask=${bbo.ask} open=${bbo.open.length} events=${bboEvents.map(e => e.type)}`);
+if (bbo.bid === 101 && bbo.ask === 100.1 && bbo.exchanges.okx.bidQty === 3 && bbo.open.length === 1 &&
+    opened && opened.symbol === 'ARBUSDT' && opened.buy === 'binance' && opened.sell === 'okx' &&
+    Math.abs(opened.bps - ((101 * 0.9995 - 100.1 * 1.0004) / 100.55 * 1e4)) < 1e-9 && opened.qty === 2 &&
+    closed && closed.since === opened.ts && bboEvents.length === 2) {
+    console.log('✅ Cross-venue BBO checks passed');
+} else {
+    console.log('❌ Cross-venue BBO checks failed');
+}
+
+// Lead-lag: okx re-quotes binance's mid 10ms late → after 3s of
+// simulated time the peak sits at binance leading okx by 10ms
+const llClock = core.setClock('simulated', 1700000000000);
+const ll = core.registerSymbol('LLGUSDT');
+const walk = [];
+for (let i = 0, p = 1000, seed = 7; i < 3000; i++) {
+    seed = (seed * 16807) % 2147483647;
+    if (seed % 10 < 3) p += seed % 20 < 10 ? 1 : -1;
+    walk.push(p / 10);
+}
+for (let t = 10; t < 3000; t++) {
+    core.advanceClock(llClock + t);
+    for (const [ex, lag] of [['binance', 0], ['okx', 10]]) {
+        const mid = walk[t - lag];
+        core.initSnapshot(ll, ex, [[(mid - 0.05).toFixed(2), '1']], [[(mid + 0.05).toFixed(2), '1']]);
+    }
+}
+const lead = core.getLeadLag(ll);
+core.setClock('real');
+core.clearSymbol(ll);
+const okxCol = lead ? lead.exchanges.indexOf('okx') : -1, n = lead ? lead.exchanges.length : 0;
+console.log(`Lead-lag: binance→okx ${lead?.leadMs[okxCol]}ms peak=${lead?.peak[okxCol].toFixed(3)} ratio=${lead?.ratio[okxCol].toFixed(1)}`);
+if (lead && lead.leadMs[okxCol] === 10 && lead.leadMs[okxCol * n] === -10 && lead.peak[okxCol] > 0.9 &&
+    lead.ratio[okxCol] > 1 && lead.curves['binance/okx'].length === 2 * lead.maxLagMs / lead.binMs + 1) {
+    console.log('✅ Lead-lag checks passed');
+} else {
+    console.log('❌ Lead-lag checks failed');
+}
+
+// Wall lifecycle: a bid wall 50bps back that is pulled once price has
+// walked to within 4bps reads as spoofed; an ask wall traded away as filled
+const wlClock = core.setClock('simulated', 1700000000000);
+const wl = core.registerSymbol('WALUSDT');
+const ladder = (from, step) => Array.from({ length: 20 }, (_, i) => [(from + step * i).toFixed(2), '1']);
+core.initSnapshot(wl, 'binance', ladder(100, -0.01), ladder(100.01, 0.01));
+core.ingestTrade(wl, 'binance', 100.01, 0.1, wlClock, 'buy');
+core.applyDelta(wl, 'binance', [['99.50', '20']], []);
+core.advanceClock(wlClock + 500);
+core.applyDelta(wl, 'binance', [...ladder(100, -0.01).map(([p]) => [p, '0']), ['99.54', '1']], []);
+const wlLive = core.getWalls(wl).live;
+core.advanceClock(wlClock + 600);
+core.applyDelta(wl, 'binance', [['99.50', '0']], []);
+core.applyDelta(wl, 'binance', [], [['100.30', '10']]);
+core.ingestTrade(wl, 'binance', 100.30, 10, wlClock + 600, 'buy');
+core.applyDelta(wl, 'binance', [], [['100.30', '0']]);
+const wls = core.getWalls(wl);
+core.setClock('real');
+core.clearSymbol(wl);
+const wlCleared = core.getWalls(wl);
+const [spoof, fill] = wls.recent;
+console.log(`Walls: live age ${wlLive[0]?.ageMs}ms, then ${spoof?.fate} after ${spoof?.lifetimeMs}ms at ${spoof?.deathBps.toFixed(1)}bps, ${fill?.fate} ${fill?.filledQty}`);
+if (wlLive.length === 1 && wlLive[0].ageMs === 500 && wlLive[0].price === 99.5 && wlLive[0].side === 'bid' &&
+    spoof?.fate === 'spoofed' && spoof.lifetimeMs === 600 && fill?.fate === 'filled' && fill.filledQty === 10 &&
+    wls.counts.binance.spoofed === 1 && wls.counts.binance.filled === 1 && wls.live.length === 0 &&
+    wlCleared.recent.length === 0 && Object.values(wlCleared.counts.binance).every((c) => c === 0)) {
+    console.log('✅ Wall lifecycle checks passed');
+} else {
+    console.log('❌ Wall lifecycle checks failed');
+}
+
 console.log('--- DONE ---');
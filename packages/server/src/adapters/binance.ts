@@ -35,8 +35,7 @@ export class BinanceAdapter implements ExchangeAdapter {
     private isStopped = false;
     private heartbeatTimer: ReturnType<typeof setInterval> | null = null;
 
-    // Sequence checking state for orderbook desync detection
-    private lastUpdateId: number | null = null;
+    // A depth snapshot fetch is in flight (sequence checks are native)
     private isResyncing = false;
 
     // Trade batching state
@@ -249,7 +248,6 @@ export class BinanceAdapter implements ExchangeAdapter {
             this.wsTrades = null;
         }
         this.health = 'down';
-        this.lastUpdateId = null;
         this.isResyncing = false;
     }
 
@@ -325,26 +323,15 @@ export class BinanceAdapter implements ExchangeAdapter {
 
     /**
      * Connect to orderbook depth stream + fetch initial snapshot.
+     * The stream opens first: the native book buffers its deltas until the
+     * REST snapshot lands, then replays the ones newer than it.
      */
     async connectOrderbook(): Promise<void> {
-        if (this.isResyncing) return;
+        orderbookEngine.onResync('binance', (symbol) => {
+            if (symbol === this.symbol.toUpperCase()) this.loadDepthSnapshot();
+        });
 
         try {
-            this.lastUpdateId = null; // Reset sequence tracking
-
-            // 1. Fetch REST depth snapshot
-            const snapRes = await fetch(`${REST_BASE}/fapi/v1/depth?symbol=${this.symbol.toUpperCase()}&limit=100`);
-            if (!snapRes.ok) throw new Error(`Depth snapshot ${snapRes.status}`);
-            const snap = await snapRes.json() as {
-                lastUpdateId: number;
-                bids: [string, string][];
-                asks: [string, string][];
-            };
-
-            this.lastUpdateId = snap.lastUpdateId;
-            orderbookEngine.initSnapshot('binance', snap);
-
-            // 2. Subscribe to WS depth deltas
             const url = `${WS_BASE}/${this.symbol}@depth@100ms`;
 
             // Cleanup existing if any
@@ -357,37 +344,22 @@ export class BinanceAdapter implements ExchangeAdapter {
 
             this.wsDepth.on('open', () => {
                 logger.info('Binance depth stream connected');
-                this.isResyncing = false;
+                this.loadDepthSnapshot();
             });
 
             this.wsDepth.on('message', (raw) => {
                 try {
                     const msg = JSON.parse(raw.toString());
                     if (msg.e === 'depthUpdate') {
-                        // FIX 2: Sequence Checking for Orderbook Desync
-                        // u = Final update ID in event
-                        // pu = Final update ID in previous event
-
-                        if (this.lastUpdateId !== null && msg.pu !== this.lastUpdateId) {
-                            // Gap detected! We dropped a packet.
-                            logger.error({
-                                expected: this.lastUpdateId,
-                                receivedPrev: msg.pu,
-                                symbol: this.symbol
-                            }, 'Desync Detected — Refetching Snapshot');
-
-                            this._wipeAndResync();
-                            return;
-                        }
-
-                        // Update sequence tracker
-                        this.lastUpdateId = msg.u;
-
+                        // U/u = first/final update ID in event, pu = final ID
+                        // of the previous event — validated natively; a gap
+                        // calls back into loadDepthSnapshot()
                         orderbookEngine.applyDelta('binance', {
                             u: msg.u,
                             b: msg.b,
                             a: msg.a,
-                        });
+                            seq: { first: msg.U, last: msg.u, prev: msg.pu },
+                        }, this.symbol);
                     }
                 } catch (err) {
                     logger.error({ err }, 'Binance depth parse error');
@@ -406,28 +378,34 @@ export class BinanceAdapter implements ExchangeAdapter {
             });
         } catch (err) {
             logger.error({ err }, 'Failed to init orderbook');
-            this.isResyncing = false;
             this.depthReconnectTimer = setTimeout(() => this.connectOrderbook(), 5000);
         }
     }
 
     /**
-     * Triggered when a sequence gap is detected. Drops WebSocket and refetches REST.
+     * Fetch a REST depth snapshot and seed the book. Runs on connect and
+     * whenever the native sequence check reports a gap — the depth stream
+     * stays open throughout, so the book is never wiped.
      */
-    private _wipeAndResync() {
-        if (this.isResyncing) return;
+    private async loadDepthSnapshot(): Promise<void> {
+        if (this.isResyncing || this.isStopped) return;
         this.isResyncing = true;
 
-        if (this.wsDepth) {
-            this.wsDepth.removeAllListeners();
-            this.wsDepth.terminate();
-            this.wsDepth = null;
+        try {
+            const snapRes = await fetch(`${REST_BASE}/fapi/v1/depth?symbol=${this.symbol.toUpperCase()}&limit=100`);
+            if (!snapRes.ok) throw new Error(`Depth snapshot ${snapRes.status}`);
+            const snap = await snapRes.json() as {
+                lastUpdateId: number;
+                bids: [string, string][];
+                asks: [string, string][];
+            };
+            this.isResyncing = false;
+            orderbookEngine.initSnapshot('binance', snap, this.symbol);
+        } catch (err) {
+            logger.error({ err }, 'Binance depth snapshot failed');
+            this.isResyncing = false;
+            if (!this.isStopped) this.depthReconnectTimer = setTimeout(() => this.loadDepthSnapshot(), 5000);
         }
-
-        if (this.depthReconnectTimer) clearTimeout(this.depthReconnectTimer);
-
-        // Immediately try to reconnect (which fetches a new REST snapshot)
-        if (!this.isStopped) this.connectOrderbook();
     }
 
     private _startHeartbeat() {
@@ -496,7 +474,7 @@ export class BinanceAdapter implements ExchangeAdapter {
                         }
 
                         // Feed into Aggregated Candle Engine (VWAP)
-                        aggregatedCandleEngine.ingestTrade('binance', trade.symbol, trade.price, trade.qty, trade.time);
+                        aggregatedCandleEngine.ingestTrade('binance', trade.symbol, trade.price, trade.qty, trade.time, trade.side);
                     }
                 } catch (err) {
                     logger.error({ err }, 'Binance trades parse error');
@@ -11,9 +11,21 @@ let heartbeatTimer: ReturnType<typeof setInterval> | null = null;
 export function startBitget(symbol: string) {
     currentSymbol = symbol.toLowerCase();
     isStopped = false;
+    orderbookEngine.onResync('bitget', (sym) => {
+        if (sym === currentSymbol.toUpperCase()) resubscribeBook(sym);
+    });
     connect(currentSymbol);
 }
 
+// Checksum mismatch (found natively): re-subscribing makes Bitget push a
+// fresh snapshot on the same socket.
+function resubscribeBook(instId: string) {
+    if (!ws || ws.readyState !== WebSocket.OPEN) return;
+    const args = [{ instType: 'SPOT', channel: 'books50', instId }];
+    ws.send(JSON.stringify({ op: 'unsubscribe', args }));
+    ws.send(JSON.stringify({ op: 'subscribe', args }));
+}
+
 export function stopBitget(symbol: string) {
     isStopped = true;
     stopHeartbeat();
@@ -61,13 +73,15 @@ function connect(symbol: string) {
                         lastUpdateId: parseInt(book.ts),
                         bids: book.bids || [],
                         asks: book.asks || [],
-                    });
+                        checksum: book.checksum,
+                    }, symbol);
                 } else if (msg.action === 'update') {
                     orderbookEngine.applyDelta('bitget', {
                         u: parseInt(book.ts),
                         b: book.bids || [],
                         a: book.asks || [],
-                    });
+                        seq: { checksum: book.checksum },
+                    }, symbol);
                 }
             }
 
@@ -79,7 +93,8 @@ function connect(symbol: string) {
                         symbol,
                         parseFloat(t.px),
                         parseFloat(t.sz),
-                        parseInt(t.ts)
+                        parseInt(t.ts),
+                        t.side
                     );
                 }
             }
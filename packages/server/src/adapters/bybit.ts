@@ -6,15 +6,15 @@ import { aggregatedCandleEngine } from '../engines/core/AggregatedCandleEngine.j
 let ws: WebSocket | null = null;
 let currentSymbol = 'btcusdt';
 
-// Sequence checking state
-let lastSeq: number | null = null;
-let isResyncing = false;
 let isStopped = false;
 let heartbeatTimer: ReturnType<typeof setInterval> | null = null;
 
 export function startBybit(symbol: string) {
     currentSymbol = symbol.toUpperCase();
     isStopped = false;
+    orderbookEngine.onResync('bybit', (sym) => {
+        if (sym === currentSymbol) resubscribeBook(currentSymbol);
+    });
     connect(currentSymbol);
 }
 
@@ -26,31 +26,19 @@ export function stopBybit(symbol: string) {
         ws.close();
         ws = null;
     }
-    lastSeq = null;
-    isResyncing = false;
     logger.info({ symbol }, 'Bybit adapter stopped');
 }
 
-function wipeAndResync(symbol: string) {
-    if (isResyncing) return;
-    isResyncing = true;
-
-    logger.error({ symbol }, 'Desync Detected on Bybit — Refetching Snapshot');
-
-    if (ws) {
-        ws.removeAllListeners();
-        ws.terminate();
-        ws = null;
-    }
-
-    // Attempt reconnect
-    if (!isStopped) setTimeout(() => connect(symbol), 100);
+// Sequence gap (found natively): re-subscribing makes Bybit push a fresh
+// snapshot on the same socket; deltas meanwhile are buffered and replayed.
+function resubscribeBook(symbol: string) {
+    if (!ws || ws.readyState !== WebSocket.OPEN) return;
+    const args = [`orderbook.50.${symbol}`];
+    ws.send(JSON.stringify({ op: 'unsubscribe', args }));
+    ws.send(JSON.stringify({ op: 'subscribe', args }));
 }
 
 function connect(symbol: string) {
-    isResyncing = false;
-    lastSeq = null; // Reset on new connection
-
     try {
         ws = new WebSocket('wss://stream.bybit.com/v5/public/linear');
     } catch (err) {
@@ -74,28 +62,21 @@ function connect(symbol: string) {
 
             // Handle Orderbook
             if (msg.topic === `orderbook.50.${symbol}` && msg.data) {
-                const currentU = msg.data.u;
+                // u: update id, +1 per delta (checked natively)
+                const u = msg.data.u;
                 if (msg.type === 'snapshot') {
-                    lastSeq = currentU;
                     orderbookEngine.initSnapshot('bybit', {
-                        lastUpdateId: Date.now(),
+                        lastUpdateId: u,
                         bids: msg.data.b || [],
                         asks: msg.data.a || [],
-                    });
+                    }, symbol);
                 } else if (msg.type === 'delta') {
-                    if (lastSeq !== null && currentU) {
-                        if (currentU <= lastSeq) return;
-                        if (currentU !== lastSeq + 1) {
-                            wipeAndResync(symbol);
-                            return;
-                        }
-                    }
-                    lastSeq = currentU;
                     orderbookEngine.applyDelta('bybit', {
-                        u: Date.now(),
+                        u,
                         b: msg.data.b || [],
                         a: msg.data.a || [],
-                    });
+                        seq: { last: u },
+                    }, symbol);
                 }
             }
 
@@ -107,7 +88,8 @@ function connect(symbol: string) {
                         symbol,
                         parseFloat(t.p),
                         parseFloat(t.v),
-                        parseInt(t.T)
+                        parseInt(t.T),
+                        t.S === 'Buy' ? 'buy' : 'sell'
                     );
                 }
             }
@@ -116,7 +98,7 @@ function connect(symbol: string) {
 
     ws.on('close', () => {
         stopHeartbeat();
-        if (!isResyncing && !isStopped) setTimeout(() => connect(symbol), 3000);
+        if (!isStopped) setTimeout(() => connect(symbol), 3000);
     });
 }
 
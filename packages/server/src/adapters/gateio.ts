@@ -63,7 +63,7 @@ function connect(symbol: string) {
                     b: book.bids || [],
                     a: book.asks || [],
                     isSnapshot: true
-                });
+                }, symbol);
             }
 
             // Handle Trades
@@ -74,7 +74,8 @@ function connect(symbol: string) {
                         symbol,
                         parseFloat(t.price),
                         parseFloat(t.amount),
-                        Math.floor(parseFloat(t.create_time_ms))
+                        Math.floor(parseFloat(t.create_time_ms)),
+                        t.side
                     );
                 }
             }
@@ -90,7 +90,8 @@ function connect() {
                         `${t.coin}USDT`, // Normalized symbol
                         parseFloat(t.px),
                         parseFloat(t.sz),
-                        t.side === 'B' ? t.time : t.time // HL uses side but time is same
+                        t.time,
+                        t.side === 'B' ? 'buy' : 'sell'   // B = bid side took liquidity
                     );
                 }
             }
@@ -9,9 +9,21 @@ let heartbeatTimer: ReturnType<typeof setInterval> | null = null;
 
 export function startOkx(symbol: string) {
     const instId = symbol.toUpperCase().replace('USDT', '-USDT-SWAP');
+    orderbookEngine.onResync('okx', (sym) => {
+        if (sym === symbol.toUpperCase()) resubscribeBook(instId);
+    });
     connect(symbol, instId);
 }
 
+// Sequence gap (found natively): a re-subscribe makes OKX push a fresh
+// snapshot; deltas meanwhile are buffered and replayed on top of it.
+function resubscribeBook(instId: string) {
+    if (!ws || ws.readyState !== WebSocket.OPEN) return;
+    const args = [{ channel: 'books', instId }];
+    ws.send(JSON.stringify({ op: 'unsubscribe', args }));
+    ws.send(JSON.stringify({ op: 'subscribe', args }));
+}
+
 function connect(symbol: string, instId: string) {
     if (isStopped) return;
     try {
@@ -44,18 +56,21 @@ function connect(symbol: string, instId: string) {
                 const cleanBids = book.bids.map((b: any) => [b[0], b[1]]);
                 const cleanAsks = book.asks.map((a: any) => [a[0], a[1]]);
 
+                // seqId / prevSeqId chain each message to the last (checked natively)
                 if (msg.action === 'snapshot') {
                     orderbookEngine.initSnapshot('okx', {
-                        lastUpdateId: Date.now(),
+                        lastUpdateId: book.seqId,
                         bids: cleanBids,
                         asks: cleanAsks,
-                    });
+                        checksum: book.checksum,
+                    }, symbol);
                 } else if (msg.action === 'update') {
                     orderbookEngine.applyDelta('okx', {
-                        u: Date.now(),
+                        u: book.seqId,
                         b: cleanBids,
                         a: cleanAsks,
-                    });
+                        seq: { last: book.seqId, prev: book.prevSeqId, checksum: book.checksum },
+                    }, symbol);
                 }
             }
 
@@ -67,7 +82,8 @@ function connect(symbol: string, instId: string) {
                         symbol,
                         parseFloat(t.px),
                         parseFloat(t.sz),
-                        parseInt(t.ts)
+                        parseInt(t.ts),
+                        t.side
                     );
                 }
             }
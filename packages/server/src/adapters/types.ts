@@ -238,6 +238,8 @@ export interface ExchangeAdapter {
 // ── WebSocket Topics ──────────────────────────
 export type WSTopic =
     | `candles.${string}.${string}`
+    | `footprint.${string}.${string}`
+    | `flow.${string}`
     | `orderbook.${string}`
     | `orderbook.aggregated`
     | `options.analytics`
@@ -35,6 +35,27 @@ const envSchema = z.object({
     ENABLE_MEXC: z.coerce.boolean().default(true),
     ENABLE_BITGET: z.coerce.boolean().default(true),
     ENABLE_GATEIO: z.coerce.boolean().default(true),
+
+    // Native book mirror — POSIX shm segment for out-of-process WS fan-out
+    ORDERBOOK_SHM_NAME: z.string().optional(),
+    // Verify OKX / Bitget top-25 book checksums natively (resync on mismatch)
+    ORDERBOOK_VERIFY_CHECKSUMS: z.coerce.boolean().default(false),
+    // Native binary journal of every book event (directory of segment files)
+    ORDERBOOK_JOURNAL_DIR: z.string().optional(),
+    // Native book state file for warm restarts, rewritten every N seconds and on stop
+    ORDERBOOK_STATE_FILE: z.string().optional(),
+    ORDERBOOK_STATE_SAVE_SEC: z.coerce.number().default(30),
+    // Native liquidity heatmap history (directory of daily depth files), sampled every N ms
+    ORDERBOOK_HISTORY_DIR: z.string().optional(),
+    ORDERBOOK_HISTORY_MS: z.coerce.number().default(100),
+    // Native in-memory trade tape per symbol, hours kept (0 = off)
+    TRADE_TAPE_HOURS: z.coerce.number().default(6),
+    // Traded symbols given native candles; the 64-slot symbol registry never frees a slot
+    // and is shared with the order books, so the rest of the trade stream is skipped
+    CANDLE_MAX_SYMBOLS: z.coerce.number().default(48),
+    // Cross-exchange BBO alerts: after-fee arb edge / distance from the consolidated mid, bps
+    BBO_ARB_MIN_EDGE_BPS: z.coerce.number().default(0),
+    BBO_DEVIATION_BPS: z.coerce.number().default(25),
     // Security
     JWT_SECRET: z.string().min(32, "JWT_SECRET must be at least 32 characters"),
     TERMINUS_API_KEY: z.string().min(16, "TERMINUS_API_KEY must be at least 16 characters"),
@@ -1,6 +1,6 @@
 import { logger } from '../logger.js';
-import { query } from './timescale.js';
 import { dbQueue } from './BackpressureQueue.js';
+import { copyFrom, encodeCopy, textColumn } from './copy.js';
 
 interface Trade {
     time: number;
@@ -29,19 +29,6 @@ export class TradeBatcher {
         }
     }
 
-    private buildPlaceholders(rowCount: number, colsPerRow: number): string {
-        const rows = [];
-        let index = 1;
-        for (let i = 0; i < rowCount; i++) {
-            const cols = [];
-            for (let j = 0; j < colsPerRow; j++) {
-                cols.push(`$${index++}`);
-            }
-            rows.push(`(${cols.join(', ')})`);
-        }
-        return rows.join(', ');
-    }
-
     async flush() {
         if (this.intervalRef) {
             clearTimeout(this.intervalRef);
@@ -54,21 +41,28 @@ export class TradeBatcher {
         // Drain up to BATCH_SIZE
         const batch = this.queue.splice(0, this.BATCH_SIZE);
 
-        const values: any[] = [];
-        for (const t of batch) {
-            // Convert ms timestamp to JS Date for PostgreSQL timestamptz
-            values.push(new Date(t.time), t.exchange, t.symbol, t.price, t.qty, t.side);
+        // Columnar batch → one native binary COPY payload
+        const n = batch.length;
+        const time = new Float64Array(n), price = new Float64Array(n), qty = new Float64Array(n);
+        for (let i = 0; i < n; i++) {
+            time[i] = batch[i].time;
+            price[i] = batch[i].price;
+            qty[i] = batch[i].qty;
         }
 
         try {
-            const placeholders = this.buildPlaceholders(batch.length, 6);
+            const payload = encodeCopy(n, [
+                { type: 'timestamptz', values: time },
+                textColumn(n, i => batch[i].exchange),
+                textColumn(n, i => batch[i].symbol),
+                { type: 'float8', values: price },
+                { type: 'float8', values: qty },
+                textColumn(n, i => batch[i].side)
+            ]);
 
             dbQueue.push(async () => {
-                await query(`
-                    INSERT INTO big_trades (time, exchange, symbol, price, qty, side)
-                    VALUES ${placeholders}
-                `, values);
-                logger.debug({ batchSize: batch.length }, 'Flushed trade batch to TimescaleDB');
+                await copyFrom('big_trades', ['time', 'exchange', 'symbol', 'price', 'qty', 'side'], payload);
+                logger.debug({ batchSize: n }, 'Flushed trade batch to TimescaleDB');
             });
 
         } catch (error) {
@@ -0,0 +1,99 @@
+import type pg from 'pg';
+import bindings from 'bindings';
+import { pool } from './timescale.js';
+
+const core = bindings('terminus_core');
+
+/** encodeCopy() column spec (pg_copy.hpp) */
+export type CopyColumn =
+    | { type: 'timestamptz' | 'float8'; values: Float64Array }
+    | { type: 'text'; dict: string[]; index?: Uint8Array | Uint16Array };
+
+/**
+ * Dictionary-code a text column: row i holds valueAt(i). Batches have
+ * a handful of distinct exchanges / symbols / sides, so the native side
+ * gets a short dict and one index per row instead of n strings.
+ */
+export function textColumn(rows: number, valueAt: (i: number) => string): CopyColumn {
+    const dict: string[] = [];
+    const ids = new Map<string, number>();
+    const index = new Uint16Array(rows);
+    for (let i = 0; i < rows; i++) {
+        const value = valueAt(i);
+        let id = ids.get(value);
+        if (id === undefined) {
+            id = dict.push(value) - 1;
+            ids.set(value, id);
+        }
+        index[i] = id;
+    }
+    return { type: 'text', dict, index };
+}
+
+/** One binary COPY payload for `rows` rows of `columns` */
+export function encodeCopy(rows: number, columns: CopyColumn[]): Buffer {
+    return core.encodeCopy(rows, columns);
+}
+
+/**
+ * pg has no COPY API of its own; this is the Submittable protocol
+ * pg-copy-streams builds on, minus the stream: the whole payload goes as
+ * one CopyData message, then CopyDone.
+ */
+class CopyFromBuffer implements pg.Submittable {
+    private rowCount = 0;
+    private settled = false;
+
+    constructor(private readonly text: string, private readonly payload: Buffer,
+                private readonly done: (err: Error | null, rows: number) => void) { }
+
+    submit(connection: any) {
+        connection.query(this.text);
+    }
+
+    handleCopyInResponse(connection: any) {
+        connection.sendCopyFromChunk(this.payload);
+        connection.endCopyFrom();
+    }
+
+    handleCommandComplete(msg: { text?: string }) {
+        this.rowCount = parseInt(msg.text?.split(' ')[1] ?? '') || 0;   // "COPY <n>"
+    }
+
+    // Settles at once: a dropped connection never sends ReadyForQuery
+    handleError(err: Error) {
+        this.settle(err);
+    }
+
+    handleReadyForQuery() {
+        this.settle(null);
+    }
+
+    // Not sent during COPY FROM, but pg dispatches them to the active query
+    handleEmptyQuery() { }
+    handleRowDescription() { }
+    handleDataRow() { }
+    handleCopyData() { }
+
+    private settle(err: Error | null) {
+        if (this.settled) return;
+        this.settled = true;
+        this.done(err, this.rowCount);
+    }
+}
+
+/**
+ * `COPY table (columns) FROM STDIN (FORMAT binary)` with a payload from
+ * encodeCopy(); resolves to the number of rows written.
+ */
+export async function copyFrom(table: string, columns: string[], payload: Buffer): Promise<number> {
+    const client = await pool.connect();
+    try {
+        return await new Promise<number>((resolve, reject) => {
+            client.query(new CopyFromBuffer(`COPY ${table} (${columns.join(', ')}) FROM STDIN (FORMAT binary)`, payload,
+                (err, rows) => err ? reject(err) : resolve(rows)));
+        });
+    } finally {
+        client.release();
+    }
+}
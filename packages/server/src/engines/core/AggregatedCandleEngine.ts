@@ -3,27 +3,44 @@ import { Trade, Exchange } from '../../adapters/types.js';
 import { logger } from '../../logger.js';
 import { query } from '../../db/timescale.js';
 import { clientHub } from '../../ws/client-hub.js';
+import { config } from '../../config.js';
+import bindings from 'bindings';
 
-interface CandleAccumulator {
-    open: number | null;
-    high: number;
-    low: number;
-    close: number | null;
-    volume: number;
-    quoteVolume: number;
-    tradeCount: number;
-    openTime: number;
-    sumPriceXVol: number;
-    sumVol: number;
-    exchangeVolume: Record<string, number>;
-}
+const core = bindings('terminus_core');
+
+// Native ExchangeID order (types.hpp); other venues count without a split
+const NATIVE_EXCHANGES: Exchange[] = ['binance', 'bybit', 'okx', 'hyperliquid', 'gateio', 'mexc', 'bitget'];
+const NATIVE_EXCHANGE_ID: Record<string, number> = Object.fromEntries(NATIVE_EXCHANGES.map((ex, i) => [ex, i]));
+
+// drainCandles() record layout, `stride` doubles per candle
+const F_SYMBOL = 0, F_INTERVAL = 1, F_TIME = 2, F_OPEN = 3, F_HIGH = 4, F_LOW = 5, F_CLOSE = 6,
+    F_VOLUME = 7, F_QUOTE = 8, F_TRADES = 9, F_BUY = 10, F_SELL = 11, F_POC = 12, F_VAL = 13, F_VAH = 14,
+    F_FP_PRICE0 = 15, F_FP_STEP = 16, F_EX_VOLUME = 17;
+
+// getTapeCandles() record layout
+const T_TIME = 0, T_OPEN = 1, T_HIGH = 2, T_LOW = 3, T_CLOSE = 4, T_VOLUME = 5, T_QUOTE = 6, T_BUY = 7, T_SELL = 8,
+    T_TRADES = 9;
 
+/**
+ * Cross-exchange candles at 1m … 1M. Accumulation is native
+ * (candle_engine.hpp): a trade is one call updating fixed per-symbol,
+ * per-interval slots. Every 100ms one drain returns the candles closed
+ * since the last tick and the live ones that changed, each with its
+ * footprint (aggressive buy / sell volume per price row) while anyone
+ * consumes footprints — a footprint subscriber or a `candle:closed`
+ * listener. The same
+ * trades go onto a native tape (trade_tape.hpp) holding the last
+ * TRADE_TAPE_HOURS, which serves recent trades and candles at any
+ * interval without the database.
+ */
 export class AggregatedCandleEngine extends EventEmitter {
-    private accumulators = new Map<string, CandleAccumulator>();
-    // 1m, 5m, 15m, 1h, 4h, 1d
-    private readonly SUPPORTED_INTERVALS = [60, 300, 900, 3600, 14400, 86400, 604800, 2592000];
-    private dirtyAccumulators = new Set<string>();
+    private symbolIds = new Map<string, number>();   // symbol → native registry id
+    private symbolNames: string[] = [];              // native registry id → symbol
+    private claimed = 0;                             // symbols given candles, against CANDLE_MAX_SYMBOLS
+    private refused = new Set<string>();             // symbols refused an id, skipped from then on
     private broadcastInterval: NodeJS.Timeout;
+    private dropped = 0;
+    private ticks = 0;
 
     constructor() {
         super();
@@ -37,110 +54,231 @@ export class AggregatedCandleEngine extends EventEmitter {
     }
 
     /**
-     * Ingest a new trade from any exchange and update aggregated candles
+     * Ingest a new trade from any exchange and update aggregated candles.
+     * `side` is the aggressor; trades without one skip the footprint.
      */
-    public ingestTrade(exchange: Exchange, symbol: string, price: number, qty: number, timestamp: number) {
-        // Convert to unix seconds
-        const tsSeconds = Math.floor(timestamp / 1000);
-
-        for (const interval of this.SUPPORTED_INTERVALS) {
-            const key = `${symbol.toUpperCase()}:${interval}`;
-            let acc = this.accumulators.get(key);
-
-            const windowStart = Math.floor(tsSeconds / interval) * interval;
-
-            // Detect new candle window
-            if (!acc || acc.openTime !== windowStart) {
-                if (acc) {
-                    // Finalize and persist previous candle
-                    const finalized = this.finalize(acc, symbol, interval);
-                    this.emit('candle:closed', { symbol, interval, candle: finalized });
-                    this.persist(symbol, interval, finalized);
-                }
+    public ingestTrade(exchange: Exchange, symbol: string, price: number, qty: number, timestamp: number, side?: 'buy' | 'sell') {
+        const id = this.idFor(symbol);
+        if (id === undefined) return;
+        core.ingestTrade(id, NATIVE_EXCHANGE_ID[exchange] ?? NATIVE_EXCHANGES.length, price, qty, timestamp,
+            side === 'buy' ? 1 : side === 'sell' ? -1 : 0);
+    }
 
-                acc = {
-                    openTime: windowStart,
-                    open: price,
-                    high: price,
-                    low: price,
-                    close: price,
-                    volume: 0,
-                    quoteVolume: 0,
-                    tradeCount: 0,
-                    sumPriceXVol: 0,
-                    sumVol: 0,
-                    exchangeVolume: {}
-                };
-                this.accumulators.set(key, acc);
-            }
+    /**
+     * Aggressor flow fed by the same trades: CVD and trade-size buckets
+     * since start, and buy / sell imbalance over 1s … 5m, consolidated
+     * and per exchange. Null for a symbol that never traded.
+     */
+    public getTradeFlow(symbol: string) {
+        const id = this.tradedId(symbol);
+        if (id === undefined) return null;
+        const flow = core.getTradeFlow(id);
+        const byName = (perId: Record<string, unknown>) =>
+            Object.fromEntries(Object.entries(perId).map(([id, v]) => [NATIVE_EXCHANGES[Number(id)], v]));
+        return {
+            ...flow,
+            exchanges: byName(flow.exchanges),
+            windows: flow.windows.map((w: any) => ({ ...w, exchanges: byName(w.exchanges) }))
+        };
+    }
 
-            // Update OHLCV
-            acc.high = Math.max(acc.high, price);
-            acc.low = Math.min(acc.low, price);
-            acc.close = price;
-            acc.volume += qty;
-            acc.quoteVolume += price * qty;
-            acc.tradeCount += 1;
+    /**
+     * Volume profile of the open candle at `intervalSec` — the UTC session
+     * at 86400 — or null before the symbol's first trade.
+     */
+    public getFootprint(symbol: string, intervalSec = 86400) {
+        const id = this.tradedId(symbol);
+        if (id === undefined) return null;
+        return core.getFootprint(id, intervalSec) as {
+            time: number; price0: number; step: number; poc: number; val: number; vah: number;
+            buy: Float32Array; sell: Float32Array;
+        } | null;
+    }
 
-            // Update VWAP components
-            acc.sumPriceXVol += price * qty;
-            acc.sumVol += qty;
+    /**
+     * Time of the oldest trade on the tape: it holds every trade from here
+     * on. Null while the tape is off or empty.
+     */
+    public tapeStartMs(symbol: string): number | null {
+        const id = this.tradedId(symbol);
+        if (id === undefined) return null;
+        const stats = core.getTapeStats(id);
+        return stats.enabled && stats.trades > 0 ? stats.firstMs : null;
+    }
 
-            // Track per-exchange contribution
-            acc.exchangeVolume[exchange] = (acc.exchangeVolume[exchange] || 0) + qty;
+    /**
+     * Trades in [fromMs, toMs] from the tape, oldest first; past `limit`
+     * the newest are kept.
+     */
+    public getTapeTrades(symbol: string, fromMs: number, toMs: number, limit: number) {
+        const id = this.tradedId(symbol);
+        if (id === undefined) return { trades: [], truncated: false };
+        const t = core.getTapeTrades(id, fromMs, toMs, limit, true);
+        const trades = new Array(t.count);
+        for (let i = 0; i < t.count; i++) {
+            trades[i] = {
+                time: t.time[i],
+                exchange: NATIVE_EXCHANGES[t.exchange[i]] ?? 'other',
+                price: t.price[i],
+                qty: t.qty[i],
+                side: t.side[i] > 0 ? 'buy' : t.side[i] < 0 ? 'sell' : null
+            };
+        }
+        return { trades, truncated: t.truncated as boolean };
+    }
 
-            // Mark as dirty for the throttled broadcast
-            this.dirtyAccumulators.add(key);
+    /**
+     * Candles of any `intervalSec` resampled from the tape, in the
+     * aggregated_candles row shape (time in seconds); empty intervals are
+     * left out.
+     */
+    public getTapeCandles(symbol: string, fromMs: number, toMs: number, intervalSec: number) {
+        const id = this.tradedId(symbol);
+        if (id === undefined) return [];
+        const { data, stride, count } = core.getTapeCandles(id, fromMs, toMs, intervalSec * 1000);
+        const candles = new Array(count);
+        for (let i = 0; i < count; i++) {
+            const at = i * stride, volume = data[at + T_VOLUME];
+            candles[i] = {
+                time: data[at + T_TIME] / 1000,
+                open: data[at + T_OPEN],
+                high: data[at + T_HIGH],
+                low: data[at + T_LOW],
+                close: data[at + T_CLOSE],
+                volume,
+                vwap: volume > 0 ? data[at + T_QUOTE] / volume : data[at + T_CLOSE],
+                trade_count: data[at + T_TRADES],
+                buy_volume: data[at + T_BUY],
+                sell_volume: data[at + T_SELL]
+            };
         }
+        return candles;
     }
 
-    private processBroadcastQueue() {
-        if (this.dirtyAccumulators.size === 0) return;
+    // Id of a symbol that has traded; API lookups must not register names
+    private tradedId(symbol: string): number | undefined {
+        const id = this.symbolNames.indexOf(symbol.toUpperCase());
+        return id < 0 ? undefined : id;
+    }
 
-        for (const key of this.dirtyAccumulators) {
-            const acc = this.accumulators.get(key);
-            if (!acc) continue;
+    /**
+     * Native registry id, interned on a symbol's first trade. Registry
+     * slots are never freed, so past CANDLE_MAX_SYMBOLS new symbols (or
+     * any once the registry is full) are refused once, logged, and their
+     * trades skipped.
+     */
+    private idFor(symbol: string): number | undefined {
+        let id = this.symbolIds.get(symbol);
+        if (id !== undefined || this.refused.has(symbol)) return id;
 
-            // Extract symbol and interval from key (SYMBOL:INTERVAL)
-            const [symbol, intervalString] = key.split(':');
-            const interval = parseInt(intervalString);
+        const key = symbol.toUpperCase();
+        const known = this.symbolNames.indexOf(key);
+        if (known >= 0) {
+            this.symbolIds.set(symbol, known);
+            return known;
+        }
+        if (this.claimed >= config.CANDLE_MAX_SYMBOLS) {
+            this.refuse(symbol, 'Candle symbol limit reached, trades skipped');
+            return undefined;
+        }
+        try {
+            id = core.registerSymbol(key) as number;
+        } catch (err) {
+            this.refuse(symbol, 'Native symbol registry full, trades skipped', err);
+            return undefined;
+        }
+        this.symbolIds.set(symbol, id);
+        this.symbolNames[id] = key;
+        this.claimed++;
+        if (config.TRADE_TAPE_HOURS > 0) core.enableTradeTape(id, config.TRADE_TAPE_HOURS);
+        return id;
+    }
+
+    private refuse(symbol: string, msg: string, err?: unknown) {
+        this.refused.add(symbol);
+        logger.warn({ symbol, candleSymbols: this.claimed, err }, msg);
+    }
 
-            // Broadcast live "dirty" candle update to frontend
-            const live = this.buildLive(acc, symbol, interval);
-            clientHub.broadcast(`candles.aggregated.${symbol.toUpperCase()}.${this.intervalToName(interval)}` as any, live);
+    private processBroadcastQueue() {
+        // Trade flow once a second, to whoever watches it
+        if (++this.ticks % 10 === 0) {
+            for (const symbol of this.symbolNames) {
+                if (!symbol || !clientHub.hasSubscribers(`flow.${symbol}`)) continue;
+                const flow = this.getTradeFlow(symbol);
+                if (flow) clientHub.broadcast(`flow.${symbol}`, { symbol, ...flow });
+            }
         }
 
-        this.dirtyAccumulators.clear();
+        const withFootprints = this.listenerCount('candle:closed') > 0 || clientHub.hasSubscribersWithPrefix('footprint.');
+        const batch = core.drainCandles(withFootprints);
+        if (batch.dropped > this.dropped) {
+            logger.warn({ dropped: batch.dropped - this.dropped }, 'Aggregated candles dropped before drain');
+            this.dropped = batch.dropped;
+        }
+
+        const { data, stride, rows } = batch;
+        for (let i = 0; i < batch.closed + batch.live; i++) {
+            const candle = this.buildLive(data, i * stride);
+            const footprint: Float32Array | undefined = batch.footprint?.subarray(i * rows * 2, (i + 1) * rows * 2);
+            if (i < batch.closed) {
+                // Finalize and persist previous candle
+                const finalized = { ...candle, closed: true };
+                this.emit('candle:closed', { symbol: candle.symbol, interval: data[i * stride + F_INTERVAL], candle: finalized, footprint });
+                this.persist(candle.symbol, data[i * stride + F_INTERVAL], finalized);
+            } else {
+                // Broadcast live "dirty" candle update to frontend
+                clientHub.broadcast(`candles.aggregated.${candle.symbol}.${candle.interval}` as any, candle);
+                const fpTopic = `footprint.${candle.symbol}.${candle.interval}` as const;
+                if (footprint && clientHub.hasSubscribers(fpTopic)) {
+                    clientHub.broadcast(fpTopic, this.buildFootprint(candle, data, i * stride, footprint));
+                }
+            }
+        }
+    }
+
+    /**
+     * Non-empty rows only: [price (row low edge), buy, sell]
+     */
+    private buildFootprint(candle: ReturnType<AggregatedCandleEngine['buildLive']>, data: Float64Array, at: number, rows: Float32Array) {
+        const price0 = data[at + F_FP_PRICE0], step = data[at + F_FP_STEP];
+        const levels: [number, number, number][] = [];
+        for (let r = 0; r < rows.length / 2; r++) {
+            if (rows[2 * r] > 0 || rows[2 * r + 1] > 0) levels.push([price0 + r * step, rows[2 * r], rows[2 * r + 1]]);
+        }
+        return { symbol: candle.symbol, interval: candle.interval, time: candle.time, step, poc: candle.poc, val: candle.val, vah: candle.vah, levels };
     }
 
-    private buildLive(acc: CandleAccumulator, symbol: string, interval: number) {
-        const vwap = acc.sumVol > 0 ? acc.sumPriceXVol / acc.sumVol : acc.close || 0;
+    private buildLive(data: Float64Array, at: number) {
+        const volume = data[at + F_VOLUME];
+        const vwap = volume > 0 ? data[at + F_QUOTE] / volume : data[at + F_CLOSE];
 
         const exchangeSplit: Record<string, number> = {};
-        for (const [ex, vol] of Object.entries(acc.exchangeVolume)) {
-            exchangeSplit[ex] = acc.sumVol > 0 ? vol / acc.sumVol : 0;
+        for (let e = 0; e < NATIVE_EXCHANGES.length; e++) {
+            const vol = data[at + F_EX_VOLUME + e];
+            if (vol > 0) exchangeSplit[NATIVE_EXCHANGES[e]] = vol / volume;
         }
 
         return {
-            time: acc.openTime,
-            open: acc.open,
-            high: acc.high,
-            low: acc.low,
-            close: acc.close,
-            volume: acc.volume,
-            vwap: vwap,
-            tradeCount: acc.tradeCount,
+            time: data[at + F_TIME],
+            open: data[at + F_OPEN],
+            high: data[at + F_HIGH],
+            low: data[at + F_LOW],
+            close: data[at + F_CLOSE],
+            volume,
+            vwap,
+            tradeCount: data[at + F_TRADES],
+            buyVolume: data[at + F_BUY],
+            sellVolume: data[at + F_SELL],
+            poc: data[at + F_POC],
+            val: data[at + F_VAL],
+            vah: data[at + F_VAH],
             exchangeSplit,
             exchange: 'aggregated' as Exchange,
-            interval: this.intervalToName(interval),
-            symbol: symbol.toUpperCase()
+            interval: this.intervalToName(data[at + F_INTERVAL]),
+            symbol: this.symbolNames[data[at + F_SYMBOL]]
         };
     }
 
-    private finalize(acc: CandleAccumulator, symbol: string, interval: number) {
-        return { ...this.buildLive(acc, symbol, interval), closed: true };
-    }
-
     private intervalToName(interval: number): string {
         switch (interval) {
             case 60: return '1m';
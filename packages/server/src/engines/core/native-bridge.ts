@@ -19,6 +19,7 @@ export interface NativeAddon {
     applyDelta(exchangeId: string, data: any): void;
     updateFunding(exchangeId: string, fundingRate: number): void;
     getAggregated(depth: number): AggregatedSnapshot;
+    getAggregatedIfNewer(symbolId: number, sinceVersion: number): (AggregatedSnapshot & { version: number }) | null;
     getVWAF(): any;
     clearExchange(exchangeId: string): void;
     clearAll(): void;
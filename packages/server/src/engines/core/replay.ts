@@ -1,11 +1,18 @@
 import { logger } from '../../logger.js';
+import { config as appConfig } from '../../config.js';
 import { query } from '../../db/timescale.js';
 import { clientHub } from '../../ws/client-hub.js';
+import bindings from 'bindings';
+
+const core = bindings('terminus_core');
+
+const BOOK_LEVELS = 25;
 
 interface ReplayConfig {
     startTime: number; // unix ms
     endTime: number;
     speed: number;    // e.g. 1, 2, 5
+    symbol?: string;  // also rebuild this symbol's book from the native journal
 }
 
 class ReplayEngine {
@@ -13,6 +20,7 @@ class ReplayEngine {
         config: ReplayConfig;
         currentTime: number;
         timer: ReturnType<typeof setInterval> | null;
+        bookReplay: number | null;   // native replay session id
     }>();
 
     async startSession(clientId: string, config: ReplayConfig) {
@@ -37,7 +45,8 @@ class ReplayEngine {
         const session = {
             config: { ...config, speed },
             currentTime: config.startTime,
-            timer: null as any
+            timer: null as any,
+            bookReplay: this.openBookReplay(config)
         };
 
         this.activeSessions.set(clientId, session);
@@ -69,11 +78,19 @@ class ReplayEngine {
                     data.splice(5000);
                 }
 
+                // The real book at nextTime, replayed natively from the journal
+                let book = null;
+                if (current.bookReplay !== null) {
+                    core.replayAdvance(current.bookReplay, nextTime);
+                    book = core.getReplayBook(current.bookReplay, BOOK_LEVELS);
+                }
+
                 // Always send BATCH to keep frontend scrubber synchronized, even if no data
                 clientHub.sendToClient(clientId, 'replay' as any, {
                     type: 'BATCH',
                     timestamp: current.currentTime,
-                    events: data
+                    events: data,
+                    book
                 });
 
                 current.currentTime = nextTime;
@@ -88,11 +105,29 @@ class ReplayEngine {
         const session = this.activeSessions.get(clientId);
         if (session) {
             if (session.timer) clearInterval(session.timer);
+            if (session.bookReplay !== null) core.closeReplay(session.bookReplay);
             this.activeSessions.delete(clientId);
             logger.info({ clientId }, 'Replay session stopped');
         }
     }
 
+    /**
+     * Seek the native journal replayer to the session start. Null when no
+     * journal is configured or the symbol was never journaled there —
+     * the session then replays the stored events only.
+     */
+    private openBookReplay(cfg: ReplayConfig): number | null {
+        if (!cfg.symbol || !appConfig.ORDERBOOK_JOURNAL_DIR) return null;
+        try {
+            const id = core.openReplay(appConfig.ORDERBOOK_JOURNAL_DIR, cfg.symbol.toUpperCase(), cfg.startTime, cfg.endTime);
+            if (id === null) logger.warn({ symbol: cfg.symbol }, 'Symbol not in book journal — replaying without book');
+            return id;
+        } catch (err) {
+            logger.error({ err }, 'Native book replay failed to open');
+            return null;
+        }
+    }
+
     private async fetchRange(start: number, end: number) {
         const startTime = new Date(start).toISOString();
         const endTime = new Date(end).toISOString();
@@ -1,6 +1,6 @@
 import { logger } from '../../logger.js';
 import { clientHub } from '../../ws/client-hub.js';
-import { query } from '../../db/timescale.js';
+import { copyFrom, encodeCopy, textColumn } from '../../db/copy.js';
 import { redis } from '../../db/redis.js';
 import type { LiquidationEvent, LiquidationHeatmapEntry } from '../../adapters/types.js';
 
@@ -53,26 +53,21 @@ export class LiquidationEngine {
         this.eventBuffer = [];
 
         try {
-            const values: any[] = [];
-            const placeholders = events.map((ev, i) => {
-                const base = i * 6;
-                values.push(
-                    Math.floor(ev.time / 1000),
-                    ev.exchange,
-                    ev.symbol,
-                    ev.price,
-                    ev.size_usd,
-                    ev.side
-                );
-                return `(to_timestamp($${base + 1}), $${base + 2}, $${base + 3}, $${base + 4}, $${base + 5}, $${base + 6})`;
-            }).join(', ');
-
-            await query(
-                `INSERT INTO liquidation_events (time, exchange, symbol, price, size_usd, side)
-                 VALUES ${placeholders}
-                 ON CONFLICT DO NOTHING`,
-                values
-            );
+            const n = events.length;
+            const time = new Float64Array(n), price = new Float64Array(n), size = new Float64Array(n);
+            for (let i = 0; i < n; i++) {
+                time[i] = Math.floor(events[i].time / 1000) * 1000;   // stored at whole seconds
+                price[i] = events[i].price;
+                size[i] = events[i].size_usd;
+            }
+            await copyFrom('liquidation_events', ['time', 'exchange', 'symbol', 'price', 'size_usd', 'side'], encodeCopy(n, [
+                { type: 'timestamptz', values: time },
+                textColumn(n, i => events[i].exchange),
+                textColumn(n, i => events[i].symbol),
+                { type: 'float8', values: price },
+                { type: 'float8', values: size },
+                textColumn(n, i => events[i].side)
+            ]));
         } catch (err) {
             logger.error({ err }, 'Failed to batch persist liquidations');
         }
@@ -1,4 +1,5 @@
 import { logger } from '../../logger.js';
+import { config } from '../../config.js';
 import { redis } from '../../db/redis.js';
 import { query } from '../../db/timescale.js';
 import { clientHub } from '../../ws/client-hub.js';
@@ -7,14 +8,34 @@ import bindings from 'bindings';
 
 const core = bindings('terminus_core');
 
+// Native ExchangeID (types.hpp): the index of each venue's native book.
+// Must follow the enum exactly — an id off by one feeds a venue's deltas
+// into another venue's book, and its checksums, BBO and walls with them.
 const EXCHANGE_MAP: Record<string, number> = {
     'binance': 0,
     'bybit': 1,
     'okx': 2,
-    'gateio': 3,
-    'mexc': 4,
+    'hyperliquid': 3,
+    'gateio': 4,
+    'mexc': 5,
     'bitget': 6
 };
+const EXCHANGE_NAMES: Record<number, string> = Object.fromEntries(
+    Object.entries(EXCHANGE_MAP).map(([name, id]) => [id, name]));
+
+// Venue names the native side reports that differ from ours
+const fromNative = (name: string): string => name === 'gate' ? 'gateio' : name;
+
+// Taker fees (bps) a cross-venue arb pays on each leg
+const TAKER_FEES_BPS: Record<string, number> = {
+    'binance': 5,
+    'bybit': 5.5,
+    'okx': 5,
+    'hyperliquid': 4.5,
+    'gate': 5,
+    'mexc': 2,
+    'bitget': 6,
+};
 
 // ══════════════════════════════════════════════════════════════
 //  Orderbook Engine — Delta State Machine + Wall Detection
@@ -23,6 +44,43 @@ const EXCHANGE_MAP: Record<string, number> = {
 const DEPTH_LEVELS = 25;
 const WALL_THRESHOLD_PCT = 3.0;   // wall if >3% of total depth
 const BROADCAST_INTERVAL = 250;   // ms — throttle broadcasts
+const FULL_SNAPSHOT_EVERY = 20;   // ticks (5s) — resyncs clients that dropped a diff
+const BUCKETS_EVERY = 4;          // ticks (1s) — wide-range bucketed depth
+const DEPTH_BUCKETS_PER_SIDE = 200;   // native default steps: 10/100/500/1000 ticks
+
+// Venues publishing a top-25 CRC32 book checksum
+const CHECKSUM_EXCHANGES: Exchange[] = ['okx', 'bitget'];
+
+// Finest tick across the venues we aggregate. The native book derives its
+// integer price scale from this; unknown symbols fall back to the decimals
+// seen in their snapshots.
+const INSTRUMENT_TICKS: Record<string, number> = {
+    'BTCUSDT': 0.1,
+    'ETHUSDT': 0.01,
+    'SOLUSDT': 0.001,
+    'XRPUSDT': 0.0001,
+    'LINKUSDT': 0.001,
+    'ADAUSDT': 0.00001,
+    'DOGEUSDT': 0.000001,
+    'AVAXUSDT': 0.001,
+    'DOTUSDT': 0.001,
+    'MATICUSDT': 0.0001,
+};
+
+// Significant decimal places of the finest price (col 0) or size (col 1)
+// string in a level list — trailing zeros ("0.00100000") don't count
+function levelDecimals(levels: [string | number, string | number][], col: 0 | 1): number {
+    let max = 0;
+    for (const level of levels) {
+        const str = String(level[col]);
+        const dot = str.indexOf('.');
+        if (dot < 0) continue;
+        let end = str.length;
+        while (end > dot + 1 && str[end - 1] === '0') end--;
+        max = Math.max(max, end - dot - 1);
+    }
+    return max;
+}
 
 interface OrderbookState {
     bids: Map<number, number>;  // price → qty
@@ -37,30 +95,204 @@ export interface OrderbookDelta {
     b: [string, string][];
     a: [string, string][];
     isSnapshot?: boolean;
+    // Venue sequence ids / checksum, validated natively: Binance { first: U,
+    // last: u, prev: pu }, Bybit { last: u }, OKX { last: seqId, prev:
+    // prevSeqId, checksum }, Bitget { checksum }
+    seq?: { first?: number; last?: number; prev?: number; checksum?: number };
 }
 
 export class OrderbookEngine {
-    private books = new Map<Exchange, OrderbookState>();
+    private books = new Map<string, Map<Exchange, OrderbookState>>();   // symbol → exchange → state
+    private symbolIds = new Map<string, number>();                      // symbol → native registry id
+    private scaleDecimals = new Map<string, number>();                  // symbol → price decimals the native scale covers
+    private lotDecimals = new Map<string, number>();                    // symbol → size decimals the native lots cover
+    private shmEnabled = new Set<string>();
+    private resyncHandlers = new Map<string, (symbol: string) => void>();   // exchange → snapshot refetch
     private broadcastTimer: ReturnType<typeof setInterval> | null = null;
     private persistTimer: ReturnType<typeof setInterval> | null = null;
-    private dirty = false;
+    private stateTimer: ReturnType<typeof setInterval> | null = null;
+    private historyTimer: ReturnType<typeof setInterval> | null = null;
     private currentSymbol = 'BTCUSDT';
+    private symbolId = this.idFor('BTCUSDT');
+    private lastDiffVersion = 0;        // native diff version last broadcast
+    private lastSignalsTs = -1;         // newest book-signal sample last broadcast
+    private lastBboKey = '';            // touch / quotes / liveness last broadcast
+    private lastLeadLagTs = -1;         // native lead-lag publish last broadcast
+    private ticksSinceFull = 0;
+    private ticksSinceBuckets = 0;
+
+    constructor() {
+        // Restore before the journal opens, so its first checkpoint holds the restored books
+        if (config.ORDERBOOK_STATE_FILE) {
+            this.restoreState(config.ORDERBOOK_STATE_FILE);
+            this.stateTimer = setInterval(() => this.saveState(), config.ORDERBOOK_STATE_SAVE_SEC * 1000);
+        }
+        if (config.ORDERBOOK_JOURNAL_DIR) {
+            if (core.openJournal(config.ORDERBOOK_JOURNAL_DIR)) {
+                logger.info({ dir: config.ORDERBOOK_JOURNAL_DIR }, 'Native book journal enabled');
+            } else {
+                logger.warn({ dir: config.ORDERBOOK_JOURNAL_DIR }, 'Native book journal unavailable');
+            }
+        }
+        if (config.ORDERBOOK_HISTORY_DIR) {
+            // Symbols enable themselves in idFor(); one native call samples them all
+            this.historyTimer = setInterval(() => core.recordDepthHistory(), config.ORDERBOOK_HISTORY_MS);
+        }
+        // Called inside the applyDelta / initSnapshot that opened or closed the condition
+        core.onBboEvent((symbol: string, events: any[]) => this.onBboEvents(symbol, events));
+    }
+
+    private onBboEvents(symbol: string, events: any[]): void {
+        for (const native of events) {
+            const event = { symbol, ...native };
+            for (const key of ['buy', 'sell', 'exchange']) {
+                if (event[key]) event[key] = fromNative(event[key]);
+            }
+            if (event.type === 'cross') {
+                logger.info({ symbol, buy: event.buy, sell: event.sell, bps: event.bps }, 'Cross-exchange arb opened');
+            }
+            clientHub.broadcast('orderbook.bbo.event' as any, event);
+        }
+    }
+
+    /**
+     * Warm restart: serve the books saved by the previous process while
+     * the feeds reconnect. Sequenced venues check their first live delta
+     * against the restored ids and resync on a gap as usual.
+     */
+    private restoreState(file: string): void {
+        const stats = core.restoreState(file);
+        if (!stats.ok) {
+            if (stats.error !== 'missing') logger.warn({ file, error: stats.error }, 'Native book state not restored');
+            return;
+        }
+        logger.info({
+            file, symbols: stats.symbols, books: stats.books,
+            ageMs: Date.now() - stats.saved_ms, ms: stats.ms.toFixed(1)
+        }, 'Native book state restored');
+        if (stats.books > 0) this._startBroadcastLoop();
+    }
 
+    private saveState(): void {
+        if (!config.ORDERBOOK_STATE_FILE) return;
+        const stats = core.saveState(config.ORDERBOOK_STATE_FILE);
+        if (!stats.ok) logger.warn({ file: config.ORDERBOOK_STATE_FILE, error: stats.error }, 'Native book state not saved');
+    }
+
+    /**
+     * Switch the broadcast symbol. Books of other symbols stay live in the
+     * native registry, so switching back needs no reseed while their feeds
+     * are still running.
+     */
     setSymbol(symbol: string): void {
-        this.currentSymbol = symbol;
+        this.currentSymbol = symbol.toUpperCase();
+        this.symbolId = this.idFor(this.currentSymbol);
+
+        // Diff versions are per symbol — start the new one with a full book
+        this.lastDiffVersion = 0;
+        this.lastSignalsTs = -1;
+        this.lastBboKey = '';
+        this.lastLeadLagTs = -1;
+        this.ticksSinceFull = 0;
+        this.enableSharedMirror(this.currentSymbol);
+    }
+
+    /**
+     * Native registry id for a symbol, interned on first use.
+     */
+    private idFor(symbol: string): number {
+        const key = symbol.toUpperCase();
+        let id = this.symbolIds.get(key);
+        if (id === undefined) {
+            id = core.registerSymbol(key) as number;
+            this.symbolIds.set(key, id);
+            const tick = INSTRUMENT_TICKS[key];
+            if (tick) this.applyInstrument(key, id, { tickSize: tick });
+            if (config.ORDERBOOK_VERIFY_CHECKSUMS) {
+                for (const ex of CHECKSUM_EXCHANGES) core.setChecksumVerify(id, EXCHANGE_MAP[ex], true);
+            }
+            core.setBboConfig(id, {
+                feesBps: TAKER_FEES_BPS,
+                minEdgeBps: config.BBO_ARB_MIN_EDGE_BPS,
+                deviationBps: config.BBO_DEVIATION_BPS,
+            });
+            if (config.ORDERBOOK_HISTORY_DIR &&
+                !core.enableDepthHistory(id, config.ORDERBOOK_HISTORY_DIR, { intervalMs: config.ORDERBOOK_HISTORY_MS })) {
+                logger.warn({ symbol: key, dir: config.ORDERBOOK_HISTORY_DIR }, 'Depth history unavailable');
+            }
+        }
+        return id;
+    }
+
+    private applyInstrument(symbol: string, id: number, opts: { tickSize?: number; lotSize?: number }): void {
+        const spec = core.setInstrument(id, opts);
+        this.scaleDecimals.set(symbol, Math.round(Math.log10(spec.price_scale)));
+        this.lotDecimals.set(symbol, Math.round(Math.log10(spec.qty_scale)));
+        logger.debug({ symbol, ...spec }, 'Native instrument spec set');
+    }
+
+    /**
+     * Widen the native price / lot scales if a snapshot quotes finer than
+     * they cover — otherwise distinct prices would round onto one key and
+     * sub-lot sizes would round away.
+     */
+    private ensureScales(symbol: string, bids: [string, string][], asks: [string, string][]): void {
+        const key = symbol.toUpperCase();
+        const id = this.idFor(key);
+        const priceDec = Math.max(levelDecimals(bids, 0), levelDecimals(asks, 0));
+        const sizeDec = Math.max(levelDecimals(bids, 1), levelDecimals(asks, 1));
+
+        const opts: { tickSize?: number; lotSize?: number } = {};
+        if (priceDec > (this.scaleDecimals.get(key) ?? 2)) opts.tickSize = Math.pow(10, -priceDec);
+        if (sizeDec > (this.lotDecimals.get(key) ?? 6)) opts.lotSize = Math.pow(10, -sizeDec);
+        if (opts.tickSize === undefined && opts.lotSize === undefined) return;
+
+        logger.info({ symbol: key, priceDec, sizeDec }, 'Finer levels seen — widening native scales');
+        this.applyInstrument(key, id, opts);
+    }
+
+    /**
+     * Register how an exchange adapter reloads a snapshot. Called by the
+     * native sequence check when it finds a gap; the adapter's deltas keep
+     * flowing (buffered natively) and the next snapshot replays them.
+     */
+    onResync(exchange: Exchange, handler: (symbol: string) => void): void {
+        if (this.resyncHandlers.size === 0) {
+            core.onResync((symbol: string, nativeExchange: string) => {
+                logger.warn({ symbol, exchange: nativeExchange }, 'Orderbook sequence gap — requesting snapshot');
+                this.resyncHandlers.get(nativeExchange)?.(symbol);
+            });
+        }
+        this.resyncHandlers.set(exchange, handler);
+    }
+
+    private booksFor(symbol: string): Map<Exchange, OrderbookState> {
+        const key = symbol.toUpperCase();
+        let books = this.books.get(key);
+        if (!books) {
+            books = new Map();
+            this.books.set(key, books);
+        }
+        return books;
     }
 
     /**
-     * Clear all book state (called on symbol switch).
+     * Drop one symbol's books (e.g. when its feeds are torn down for good).
+     */
+    clearSymbol(symbol: string): void {
+        this.books.delete(symbol.toUpperCase());
+        core.clearSymbol(this.idFor(symbol));
+    }
+
+    /**
+     * Clear all book state across every symbol.
      */
     clearAll(): void {
         this.books.clear();
-        this.wallAgeMap.clear();
-        this.dirty = false;
 
         // Clear native too
-        for (const id of Object.values(EXCHANGE_MAP)) {
-            core.clearExchange(id);
+        for (const id of this.symbolIds.values()) {
+            core.clearSymbol(id);
         }
     }
 
@@ -71,7 +303,10 @@ export class OrderbookEngine {
         lastUpdateId: number;
         bids: [string, string][];
         asks: [string, string][];
-    }): void {
+        checksum?: number;
+    }, symbol: string = this.currentSymbol): void {
+        this.ensureScales(symbol, snapshot.bids, snapshot.asks);
+
         const bookBids: [number, number][] = [];
         const bookAsks: [number, number][] = [];
 
@@ -89,11 +324,11 @@ export class OrderbookEngine {
 
         const exchangeId = EXCHANGE_MAP[exchange] ?? 255;
         if (exchangeId !== 255) {
-            core.initSnapshot(exchangeId, bookBids, bookAsks);
+            core.initSnapshot(this.idFor(symbol), exchangeId, snapshot.lastUpdateId, bookBids, bookAsks, snapshot.checksum);
         }
 
         // Keep local state for best bid/ask (used by some legacy triggers)
-        this.books.set(exchange, {
+        this.booksFor(symbol).set(exchange, {
             bids: new Map(bookBids),
             asks: new Map(bookAsks),
             lastUpdateId: snapshot.lastUpdateId,
@@ -101,52 +336,52 @@ export class OrderbookEngine {
             bestAsk: bookAsks[0]?.[0] ?? 0,
         });
 
-        this.dirty = true;
         this._startBroadcastLoop();
     }
 
     /**
      * Apply delta update from WebSocket.
      */
-    applyDelta(exchange: Exchange, delta: OrderbookDelta): void {
-        const book = this.books.get(exchange);
-        if (!book) return;
+    applyDelta(exchange: Exchange, delta: OrderbookDelta, symbol: string = this.currentSymbol): void {
+        const book = this.booksFor(symbol).get(exchange);
+        const sequenced = delta.seq !== undefined && !delta.isSnapshot;
+        // Sequenced deltas may precede the snapshot — the native side buffers them
+        if (!book && !sequenced) return;
+        if (delta.isSnapshot) this.ensureScales(symbol, delta.b, delta.a);
 
-        const bidDeltas: [number, number][] = [];
-        const askDeltas: [number, number][] = [];
+        const bidDeltas: [number, number][] = delta.b.map(([p, q]) => [parseFloat(p), parseFloat(q)]);
+        const askDeltas: [number, number][] = delta.a.map(([p, q]) => [parseFloat(p), parseFloat(q)]);
 
-        // Apply bid deltas
-        for (const [priceStr, qtyStr] of delta.b) {
-            const price = parseFloat(priceStr);
-            const qty = parseFloat(qtyStr);
-            bidDeltas.push([price, qty]);
+        const exchangeId = EXCHANGE_MAP[exchange] ?? 255;
+        if (exchangeId !== 255) {
+            if (sequenced) {
+                // Only mirror what the native book applied — buffered and gapped
+                // deltas wait there for the snapshot, stale ones are dropped
+                const status = core.applySequencedDelta(this.idFor(symbol), exchangeId, delta.seq, bidDeltas, askDeltas);
+                if (status !== 'applied') return;
+            } else {
+                core.applyDelta(this.idFor(symbol), exchangeId, bidDeltas, askDeltas, !!delta.isSnapshot);
+            }
+        }
+        if (!book) return;
+
+        for (const [price, qty] of bidDeltas) {
             if (qty === 0) book.bids.delete(price);
             else book.bids.set(price, qty);
         }
-
-        // Apply ask deltas
-        for (const [p, q] of delta.a) {
-            const price = parseFloat(p);
-            const qty = parseFloat(q);
-            askDeltas.push([price, qty]);
+        for (const [price, qty] of askDeltas) {
             if (qty === 0) book.asks.delete(price);
             else book.asks.set(price, qty);
         }
 
-        const exchangeId = EXCHANGE_MAP[exchange] ?? 255;
-        if (exchangeId !== 255) {
-            core.applyDelta(exchangeId, bidDeltas, askDeltas, !!delta.isSnapshot);
-        }
-
         book.lastUpdateId = delta.u;
-        this.dirty = true;
     }
 
     /**
      * Get the top N levels as a sorted snapshot.
      */
     getSnapshot(exchange: Exchange): OrderbookSnapshot | null {
-        const book = this.books.get(exchange);
+        const book = this.booksFor(this.currentSymbol).get(exchange);
         if (!book) return null;
 
         const bids: OrderbookLevel[] = [...book.bids.entries()]
@@ -169,10 +404,10 @@ export class OrderbookEngine {
     }
 
 
-    private wallAgeMap = new Map<number, number>(); // price -> ticks alive
-
     /**
-     * Detect limit walls — price levels with disproportionate qty.
+     * Detect limit walls — price levels with disproportionate qty. Walls
+     * the native tracker follows on the snapshot's exchange score for
+     * persistence by their age.
      */
     detectWalls(snapshot: OrderbookSnapshot): { bid_walls: OrderbookWall[]; ask_walls: OrderbookWall[] } {
         const allLevels = [...snapshot.bids, ...snapshot.asks];
@@ -190,20 +425,15 @@ export class OrderbookEngine {
         const rawBids = snapshot.bids.filter((l: any) => l.qty > threshold);
         const rawAsks = snapshot.asks.filter((l: any) => l.qty > threshold);
 
-        // Update age map
-        const currentWallPrices = new Set([...rawBids, ...rawAsks].map(w => w.price));
-        for (const [price, age] of this.wallAgeMap.entries()) {
-            if (!currentWallPrices.has(price)) {
-                this.wallAgeMap.delete(price); // Wall pulled
-            } else {
-                this.wallAgeMap.set(price, age + 1); // persists
-            }
-        }
-        for (const price of currentWallPrices) {
-            if (!this.wallAgeMap.has(price)) {
-                this.wallAgeMap.set(price, 1);
-            }
+        // Ages of the walls tracked natively on this exchange, by side
+        const ages = { bid: new Map<number, number>(), ask: new Map<number, number>() };
+        for (const w of this.getWalls(snapshot.symbol)?.live ?? []) {
+            if (w.exchange === snapshot.exchange) ages[w.side as 'bid' | 'ask'].set(w.price, w.ageMs);
         }
+        const ageMs = (side: 'bid' | 'ask', price: number): number => {
+            for (const [p, age] of ages[side]) if (Math.abs(p - price) <= price * 1e-9) return age;
+            return 0;
+        };
 
         const processWalls = (walls: OrderbookLevel[], side: 'bid' | 'ask', totalQty: number): OrderbookWall[] => {
             return walls.map(w => {
@@ -213,9 +443,8 @@ export class OrderbookEngine {
                 const multiple = w.qty / (medianQty || 1);
                 score += Math.min(multiple / 2, 5);
 
-                // Persistence score (cap at 4)
-                const age = this.wallAgeMap.get(w.price) || 1;
-                score += Math.min(age / 10, 4);
+                // Persistence score: a point per 2.5s alive (cap at 4)
+                score += Math.min(ageMs(side, w.price) / 2500, 4);
 
                 // Round number proximity (2 points)
                 const nearest100 = Math.round(w.price / 100) * 100;
@@ -250,25 +479,215 @@ export class OrderbookEngine {
      */
     getAggregated(): AggregatedOrderbook | null {
         try {
-            const nativeSnap = core.getAggregated();
-            if (!nativeSnap) return null;
+            return this.mapNative(core.getAggregated(this.symbolId));
+        } catch (err) {
+            logger.error({ err }, 'Native getAggregated failed, falling back to JS');
+            return null; // For now no fallback, native is primary
+        }
+    }
+
+    /**
+     * Levels changed since the last broadcast — null when nothing moved.
+     * `full` diffs carry the whole book and must replace, not patch. The
+     * caller advances lastDiffVersion once the payload has gone out.
+     */
+    private getAggregatedDiff(): any | null {
+        try {
+            return core.getAggregatedDiff(this.symbolId, this.lastDiffVersion);
+        } catch (err) {
+            logger.error({ err }, 'Native getAggregatedDiff failed');
+            return null;
+        }
+    }
+
+    /**
+     * Consolidated depth grouped at several price resolutions, computed
+     * natively from the full per-exchange books (not the 50-level output).
+     * Without `steps` the native side uses 10/100/500/1000 ticks of the
+     * symbol. Each resolution carries Float64Array bids/asks; bucket j sits
+     * at bid_start - j*step / ask_start + j*step.
+     */
+    getDepthBuckets(steps?: number[], bucketsPerSide = DEPTH_BUCKETS_PER_SIDE): any | null {
+        try {
+            return core.getBucketedDepth(this.symbolId, steps, bucketsPerSide);
+        } catch (err) {
+            logger.error({ err }, 'Native getBucketedDepth failed');
+            return null;
+        }
+    }
+
+    /**
+     * Running depth totals (size, notional, size within each bps band of
+     * the touch), consolidated and per exchange. Maintained natively on
+     * every delta, so this is a read, not a re-sum.
+     */
+    getDepthStats(): any | null {
+        try {
+            return core.getDepthStats(this.symbolId);
+        } catch (err) {
+            logger.error({ err }, 'Native getDepthStats failed');
+            return null;
+        }
+    }
+
+    /**
+     * Order-book imbalance at the top 1/5/10/25 levels and each bps band,
+     * plus the size-weighted microprice, per exchange and consolidated,
+     * with 1s/10s/60s time-weighted averages. Updated natively on every
+     * delta; exchanges are keyed by name here.
+     */
+    getBookSignals(symbol: string = this.currentSymbol): any | null {
+        try {
+            const native = core.getBookSignals(this.idFor(symbol));
+            if (!native) return null;
+            const plain = (s: any) => ({
+                ...s,
+                imbalance: Array.from(s.imbalance as Float32Array),
+                windows: (s.windows as Float32Array[]).map(w => Array.from(w)),
+            });
+            const exchanges: Record<string, any> = {};
+            for (const [id, s] of Object.entries(native.exchanges)) {
+                exchanges[EXCHANGE_NAMES[Number(id)] ?? id] = plain(s);
+            }
+            return { ...native, symbol, total: plain(native.total), exchanges };
+        } catch (err) {
+            logger.error({ err }, 'Native getBookSignals failed');
+            return null;
+        }
+    }
+
+    /**
+     * Recent signal samples (one per millisecond, up to 2048) of one
+     * exchange, or the consolidated book, newer than `sinceMs`: `stride`
+     * doubles per sample — ts, bid, ask, microprice, imbalances.
+     */
+    getBookSignalSeries(symbol: string = this.currentSymbol, exchange?: Exchange, sinceMs = 0): any | null {
+        try {
+            const id = exchange === undefined ? undefined : EXCHANGE_MAP[exchange];
+            if (exchange !== undefined && id === undefined) return null;
+            return core.getBookSignalSeries(this.idFor(symbol), id, sinceMs);
+        } catch (err) {
+            logger.error({ err }, 'Native getBookSignalSeries failed');
+            return null;
+        }
+    }
+
+    /**
+     * Best bid / ask per exchange, the consolidated touch over the live
+     * ones, and the crosses (one venue's bid above another's ask after
+     * taker fees) and mid deviations in progress. Kept natively as the
+     * books change; opens and closes also arrive as `orderbook.bbo.event`.
+     */
+    getBbo(symbol: string = this.currentSymbol): any | null {
+        try {
+            const native = core.getBbo(this.idFor(symbol));
+            const exchanges: Record<string, any> = {};
+            for (const [name, row] of Object.entries(native.exchanges)) exchanges[fromNative(name)] = row;
+            const open = native.open.map((e: any) => ({
+                ...e,
+                ...(e.buy && { buy: fromNative(e.buy), sell: fromNative(e.sell) }),
+                ...(e.exchange && { exchange: fromNative(e.exchange) }),
+            }));
+            return { ...native, symbol, exchanges, open };
+        } catch (err) {
+            logger.error({ err }, 'Native getBbo failed');
+            return null;
+        }
+    }
+
+    /**
+     * Which exchange leads price discovery: lagged correlation of each
+     * pair's 5ms mid returns over the last minute, republished natively
+     * every second. leadMs[a][b] > 0 = exchanges[a] moves that many ms
+     * before exchanges[b]; ratio[a][b] > 1 = a leads overall.
+     */
+    getLeadLag(symbol: string = this.currentSymbol): any | null {
+        try {
+            const native = core.getLeadLag(this.idFor(symbol));
+            if (!native) return null;
+            const n = native.exchanges.length;
+            const rows = (flat: Float64Array) => Array.from({ length: n }, (_, a) => Array.from(flat.subarray(a * n, (a + 1) * n)));
+            const moves: Record<string, number> = {};
+            for (const [name, count] of Object.entries(native.moves)) moves[fromNative(name)] = count as number;
+            const curves: Record<string, number[]> = {};
+            for (const [pair, curve] of Object.entries(native.curves)) {
+                curves[pair.split('/').map(fromNative).join('/')] = Array.from(curve as Float32Array);
+            }
+            return {
+                symbol,
+                ts: native.ts,
+                binMs: native.binMs,
+                maxLagMs: native.maxLagMs,
+                windowMs: native.windowMs,
+                exchanges: native.exchanges.map(fromNative),
+                moves,
+                leadMs: rows(native.leadMs),
+                peak: rows(native.peak),
+                ratio: rows(native.ratio),
+                curves,
+            };
+        } catch (err) {
+            logger.error({ err }, 'Native getLeadLag failed');
+            return null;
+        }
+    }
 
-            // Map native snapshot to TS type
+    /**
+     * Per-exchange wall lifecycles, tracked natively at delta resolution:
+     * live walls with ageMs and [ts, qty] size history, and recent deaths
+     * with how they went — 'filled' (mostly traded), 'spoofed' (cancelled
+     * as price closed in), 'pulled', 'out_of_range' or 'reset' — plus
+     * all-time death counts per exchange and fate.
+     */
+    getWalls(symbol: string = this.currentSymbol): any | null {
+        try {
+            const native = core.getWalls(this.idFor(symbol));
+            const rename = (w: any) => ({ ...w, exchange: fromNative(w.exchange) });
+            const counts: Record<string, Record<string, number>> = {};
+            for (const [name, row] of Object.entries(native.counts)) counts[fromNative(name)] = row as Record<string, number>;
             return {
-                time: nativeSnap.timestamp,
-                exchange: 'binance', // default output representation
-                symbol: this.currentSymbol,
-                best_bid: nativeSnap.best_bid,
-                best_ask: nativeSnap.best_ask,
-                spread: nativeSnap.spread,
-                mid_price: nativeSnap.mid_price,
-                bids: nativeSnap.bids,
-                asks: nativeSnap.asks,
-                walls: nativeSnap.walls
+                symbol,
+                ts: native.ts,
+                live: native.live.map(rename),
+                recent: native.recent.map(rename),
+                counts,
             };
         } catch (err) {
-            logger.error({ err }, 'Native getAggregated failed, falling back to JS');
-            return null; // For now no fallback, native is primary
+            logger.error({ err }, 'Native getWalls failed');
+            return null;
+        }
+    }
+
+    private mapNative(nativeSnap: any): AggregatedOrderbook | null {
+        if (!nativeSnap) return null;
+
+        // Map native snapshot to TS type
+        return {
+            time: nativeSnap.timestamp,
+            exchange: 'binance', // default output representation
+            symbol: this.currentSymbol,
+            best_bid: nativeSnap.best_bid,
+            best_ask: nativeSnap.best_ask,
+            spread: nativeSnap.spread,
+            mid_price: nativeSnap.mid_price,
+            bids: nativeSnap.bids,
+            asks: nativeSnap.asks,
+            walls: nativeSnap.walls
+        };
+    }
+
+    /**
+     * Mirror a symbol's book into shared memory for out-of-process fan-out.
+     * One segment per symbol: `${ORDERBOOK_SHM_NAME}_${SYMBOL}`.
+     */
+    private enableSharedMirror(symbol: string): void {
+        if (!config.ORDERBOOK_SHM_NAME || this.shmEnabled.has(symbol)) return;
+        const segment = `${config.ORDERBOOK_SHM_NAME}_${symbol}`;
+        if (core.enableSharedMirror(this.idFor(symbol), segment)) {
+            this.shmEnabled.add(symbol);
+            logger.info({ segment }, 'Orderbook shared-memory mirror enabled');
+        } else {
+            logger.warn({ segment }, 'Failed to open orderbook shared-memory mirror');
         }
     }
 
@@ -278,28 +697,100 @@ export class OrderbookEngine {
     private _startBroadcastLoop(): void {
         if (this.broadcastTimer) return;
 
+        this.enableSharedMirror(this.currentSymbol);
+
         // Start persistence timer (every 10s)
         if (!this.persistTimer) {
             this.persistTimer = setInterval(() => this.persistSnapshot(), 10_000);
         }
 
         this.broadcastTimer = setInterval(() => {
-            if (!this.dirty) return;
-            this.dirty = false;
-
-            // Build aggregated snapshot from primary exchange
-            const aggregated = this.getAggregated();
-            if (!aggregated) return;
-
-            // Cache in Redis
-            redis.set(
-                'orderbook.aggregated',
-                JSON.stringify(aggregated),
-                'EX', 5,
-            ).catch(() => { });
-
-            // Broadcast to subscribed clients
-            clientHub.broadcast('orderbook.aggregated' as any, aggregated);
+            // Null when no consolidated level moved — gates the depth diff only
+            const diff = this.getAggregatedDiff();
+
+            // Signals are sampled on every book change, so the newest sample
+            // also versions the depth stats (which cover levels past the diff)
+            const signals = this.getBookSignals();
+            const signalsTs = signals
+                ? Math.max(signals.total.ts, ...Object.values(signals.exchanges).map((s: any) => s.ts as number))
+                : 0;
+            if (diff || signalsTs !== this.lastSignalsTs) {
+                this.lastSignalsTs = signalsTs;
+                const depthStats = this.getDepthStats();
+                if (depthStats) clientHub.broadcast('orderbook.depth' as any, depthStats);
+                if (signals) clientHub.broadcast('orderbook.signals' as any, signals);
+            }
+
+            // Venues also go live / stale with no book change
+            const bbo = this.getBbo();
+            const bboKey = bbo ? `${bbo.bid}/${bbo.ask}/${bbo.open.length}/` +
+                Object.values(bbo.exchanges).map((q: any) => `${q.seen}${q.live ? '+' : '-'}`).join() : '';
+            if (bbo && bboKey !== this.lastBboKey) {
+                this.lastBboKey = bboKey;
+                clientHub.broadcast('orderbook.bbo' as any, bbo);
+            }
+
+            if (++this.ticksSinceBuckets >= BUCKETS_EVERY) {
+                this.ticksSinceBuckets = 0;
+                const leadLag = this.getLeadLag();
+                if (leadLag && leadLag.ts !== this.lastLeadLagTs) {
+                    this.lastLeadLagTs = leadLag.ts;
+                    clientHub.broadcast('orderbook.leadlag' as any, leadLag);
+                }
+                const walls = this.getWalls();
+                if (walls) clientHub.broadcast('orderbook.walls' as any, walls);
+                const depth = this.getDepthBuckets();
+                if (depth) {
+                    clientHub.broadcast('orderbook.buckets' as any, {
+                        ...depth,
+                        resolutions: depth.resolutions.map((r: any) => ({
+                            ...r,
+                            bids: Array.from(r.bids as Float64Array),
+                            asks: Array.from(r.asks as Float64Array),
+                        })),
+                    });
+                }
+            }
+
+            if (!diff) return;
+            // The mirror holds the exact snapshot this diff was cut from
+            const aggregated = diff.full || this.ticksSinceFull + 1 >= FULL_SNAPSHOT_EVERY
+                ? this.mapNative(core.getAggregatedIfNewer(this.symbolId, 0))
+                : null;
+            // A full diff can't be patched — without the snapshot, retry next tick
+            if (diff.full && !aggregated) return;
+            if (aggregated) {
+                this.ticksSinceFull = 0;
+                this.lastDiffVersion = diff.version;
+                const full = { ...aggregated, version: diff.version };
+
+                // Cache in Redis (initial state for newly connected clients)
+                redis.set(
+                    'orderbook.aggregated',
+                    JSON.stringify(full),
+                    'EX', 10,
+                ).catch(() => { });
+
+                clientHub.broadcast('orderbook.aggregated' as any, full);
+                return;
+            }
+
+            // Compact diff: [price, qty] pairs, qty 0 = remove. Clients apply
+            // it only if `from` matches the version they hold.
+            clientHub.broadcast('orderbook.aggregated.diff' as any, {
+                version: diff.version,
+                from: diff.from,
+                time: diff.timestamp,
+                best_bid: diff.best_bid,
+                best_ask: diff.best_ask,
+                spread: diff.spread,
+                mid_price: diff.mid_price,
+                bids: diff.bids,
+                asks: diff.asks,
+                walls: diff.walls,
+            });
+            this.lastDiffVersion = diff.version;
+            this.ticksSinceFull++;
         }, BROADCAST_INTERVAL);
     }
 
@@ -323,6 +814,19 @@ export class OrderbookEngine {
         }
     }
 
+    /**
+     * Recorded heatmap window: `qty[bin * rows + row]` is the largest
+     * resting size in row's price band (row 0 at `price0`) during the bin.
+     * Null when history is off or nothing in range was recorded.
+     */
+    readDepthHistory(symbol: string, fromMs: number, toMs: number, priceLo: number, priceHi: number, maxBins: number): {
+        from: number; bin_ms: number; bins: number; rows: number;
+        price0: number; step: number; columns: number; qty: Float32Array;
+    } | null {
+        if (!config.ORDERBOOK_HISTORY_DIR) return null;
+        return core.readDepthHistory(config.ORDERBOOK_HISTORY_DIR, symbol.toUpperCase(), fromMs, toMs, priceLo, priceHi, maxBins);
+    }
+
     /**
      * Stop broadcast loop.
      */
@@ -335,6 +839,19 @@ export class OrderbookEngine {
             clearInterval(this.persistTimer);
             this.persistTimer = null;
         }
+        if (this.historyTimer) {
+            clearInterval(this.historyTimer);
+            this.historyTimer = null;
+        }
+        if (this.stateTimer) {
+            clearInterval(this.stateTimer);
+            this.stateTimer = null;
+            this.saveState();
+        }
+        if (config.ORDERBOOK_JOURNAL_DIR) {
+            const stats = core.closeJournal();
+            logger.info({ records: stats.records, bytes: stats.bytes, dropped: stats.dropped }, 'Native book journal closed');
+        }
     }
 }
 
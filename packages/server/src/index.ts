@@ -18,6 +18,7 @@ import { startBitget, stopBitget } from './adapters/bitget.js';
 import { startGateio, stopGateio } from './adapters/gateio.js';
 import { clerkPlugin } from '@clerk/fastify';
 import { ohlcvRoutes } from './routes/ohlcv.js';
+import { depthRoutes } from './routes/depth.js';
 import { optionsEngine, generateSimulatedChain, generateSimulatedTrade } from './engines/analytics/options.js';
 import { liquidationEngine, generateSimulatedLiquidation, seedLiquidationHistory } from './engines/signals/liquidations.js';
 import { vwafEngine, generateSimulatedFunding } from './engines/analytics/vwaf.js';
@@ -92,6 +93,7 @@ async function start(): Promise<void> {
     // Auth
     // await app.register(clerkPlugin);
     await app.register(ohlcvRoutes);
+    await app.register(depthRoutes);
     await app.register(userRoutes, { prefix: '/api/user' });
 
     // ── Connect exchange adapters ────────────────
@@ -519,7 +521,6 @@ async function start(): Promise<void> {
                         globalSymbol = normalized;
                         logger.info(`Switching global market to ${globalSymbol}`);
 
-                        orderbookEngine.clearAll();
                         orderbookEngine.setSymbol(normalized);
                         signalIntelligenceEngine.switchSymbol(normalized);
                         optionsEngine.setSymbol(normalized);
@@ -1,45 +1,333 @@
 #pragma once
 #include "orderbook.hpp"
 #include "wall_detector.hpp"
+#include "snapshot_diff.hpp"
+#include "sequence_guard.hpp"
+#include "book_checksum.hpp"
+#include "clock.hpp"
+#include "book_journal.hpp"
+#include "bbo_tracker.hpp"
+#include "book_signals.hpp"
+#include "lead_lag.hpp"
+#include "wall_tracker.hpp"
 #include <array>
 #include <map>
 #include <shared_mutex>   // C++17 reader-writer lock — multiple readers, one writer
 #include <atomic>
+#include <mutex>
 
 constexpr size_t N_EXCHANGES = static_cast<size_t>(ExchangeID::MAX_EXCHANGES);
+constexpr size_t MAX_DEPTH_RESOLUTIONS = 8;
+
+// Consolidated depth grouped into fixed price buckets at several
+// resolutions. Bid bucket j of resolution r covers prices p with
+// floor(p/step) == floor(best_bid/step) - j (asks: ceil, upwards).
+// qty arrays are lots, laid out [r * buckets + j].
+struct BucketedDepth {
+    size_t  resolutions = 0;
+    size_t  buckets     = 0;
+    int64_t price_scale = PRICE_SCALE;
+    int64_t qty_scale   = QTY_SCALE;
+    int64_t best_bid_raw = 0;
+    int64_t best_ask_raw = 0;
+    int64_t step_raw[MAX_DEPTH_RESOLUTIONS]{};
+    int64_t bid_start_raw[MAX_DEPTH_RESOLUTIONS]{};   // price of bid bucket 0
+    int64_t ask_start_raw[MAX_DEPTH_RESOLUTIONS]{};   // price of ask bucket 0
+    std::vector<int64_t> bid_qty;
+    std::vector<int64_t> ask_qty;
+};
+
+// Running depth read straight off the books — no merge, O(exchanges).
+// Consolidated band sizes are the sum of each venue's own band (measured
+// from that venue's touch, not the consolidated one).
+struct DepthSummary {
+    DepthBands bands;
+    int64_t    price_scale = PRICE_SCALE;
+    int64_t    qty_scale   = QTY_SCALE;
+    uint8_t    active      = 0;      // exchanges included, as activeMask()
+    DepthStats bids, asks;           // consolidated
+    DepthStats ex_bids[N_EXCHANGES];
+    DepthStats ex_asks[N_EXCHANGES];
+};
 
 class CrossExchangeAggregator {
 public:
+    // ── Instrument metadata ───────────────────────────────────────
+    // Scales only ever grow: a finer tick or lot re-keys the live books in
+    // place (exact — factors are integers) and rebases the diff tracker. A
+    // coarser one keeps the current scale, since existing keys would
+    // otherwise collide.
+    void setSpec(const InstrumentSpec& next) {
+        std::lock_guard diff_lock(diff_mutex_);
+        std::unique_lock lock(rw_mutex_);
+        const int64_t now_ms = clock_->nowMs();
+        const bool journaled = journaling(now_ms);
+
+        int64_t price_factor = 1, qty_factor = 1;
+        if (next.price_scale > spec_.price_scale && next.price_scale % spec_.price_scale == 0) {
+            price_factor = next.price_scale / spec_.price_scale;
+        }
+        if (next.qty_scale > spec_.qty_scale && next.qty_scale % spec_.qty_scale == 0) {
+            qty_factor = next.qty_scale / spec_.qty_scale;
+        }
+        if (price_factor != 1 || qty_factor != 1) {
+            for (auto& book : books_) book.rescale(price_factor, qty_factor);
+            spec_.price_scale *= price_factor;
+            spec_.qty_scale   *= qty_factor;
+            diff_tracker_.rebase();
+            diff_seen_mutations_ = UINT64_MAX;
+            markDirty();
+        }
+        const double tick = static_cast<double>(next.tick_raw) / next.price_scale;
+        spec_.tick_raw = std::max<int64_t>(1, spec_.toRaw(tick));
+        if (journaled) journal_.spec(now_ms, spec_);
+    }
+
+    InstrumentSpec spec() const {
+        std::shared_lock lock(rw_mutex_);
+        return spec_;
+    }
+
+    // Time source for staleness and snapshot timestamps — the process
+    // clock unless a replay hands in its own. Not owned.
+    void setClock(Clock& clock) {
+        std::unique_lock lock(rw_mutex_);
+        clock_ = &clock;
+        markDirty();
+    }
+
+    Clock& clock() const { return *clock_; }
+
+    // Record every book input of this instrument as stream `stream` of
+    // `journal` (book_journal.hpp); nullptr stops. Attaching starts with a
+    // checkpoint of the current books.
+    void setJournal(BookJournal* journal, uint16_t stream = 0, const std::string& name = {}) {
+        std::unique_lock lock(rw_mutex_);
+        if (journal) journal_.attach(*journal, stream, name);
+        else         journal_.detach();
+    }
+
+    // ── Warm restart (state_snapshot.hpp) ─────────────────────────
+    // Instrument scales plus every book that is in sync, with its venue
+    // sequence position. A book mid-resync is left out: it is already
+    // wrong and its next snapshot replaces it. Returns the books written.
+    size_t saveState(JournalCodec::Buffer& out) const {
+        std::shared_lock lock(rw_mutex_);
+        out.varint(static_cast<uint64_t>(spec_.price_scale));
+        out.varint(static_cast<uint64_t>(spec_.tick_raw));
+        out.varint(static_cast<uint64_t>(spec_.qty_scale));
+
+        size_t n = 0;
+        for (size_t i = 0; i < N_EXCHANGES; ++i) n += saveable(i) ? 1 : 0;
+        out.varint(n);
+        for (size_t i = 0; i < N_EXCHANGES; ++i) {
+            if (!saveable(i)) continue;
+            const auto& book = books_[i];
+            out.u8(static_cast<uint8_t>(i));
+            out.varint(book.last_update_id);
+            out.varint(guards_[i].lastId());
+            out.u8(guards_[i].synced() ? 1 : 0);
+            int64_t anchor = 0;
+            JournalCodec::putSide(out, book.bids.data(), book.bids.size(), anchor);
+            anchor = 0;
+            JournalCodec::putSide(out, book.asks.data(), book.asks.size(), anchor);
+        }
+        return n;
+    }
+
+    // Replace every book with a saveState() payload; false (and nothing
+    // changed) if it doesn't parse. Restored books count as fresh from
+    // now, so they are served for one staleness window while the feeds
+    // reconnect; sequenced venues validate their first live delta
+    // against the restored id and resync on a gap as usual.
+    bool restoreState(const uint8_t*& p, const uint8_t* end, size_t& books) {
+        using namespace JournalCodec;
+        struct Saved {
+            size_t      ex;
+            uint64_t    update_id, seq_id;
+            bool        synced;
+            LevelDeltas bids, asks;
+        };
+        uint64_t ps, tick, qs, n;
+        if (!getVarint(p, end, ps) || !getVarint(p, end, tick) || !getVarint(p, end, qs) ||
+            ps == 0 || tick == 0 || qs == 0 || !getVarint(p, end, n) || n > N_EXCHANGES) return false;
+
+        std::vector<Saved> saved(static_cast<size_t>(n));
+        for (auto& sv : saved) {
+            int64_t anchor = 0;
+            if (p >= end || (sv.ex = *p++) >= N_EXCHANGES) return false;
+            if (!getVarint(p, end, sv.update_id) || !getVarint(p, end, sv.seq_id) || p >= end) return false;
+            sv.synced = *p++ != 0;
+            if (!getSide(p, end, sv.bids, anchor)) return false;
+            anchor = 0;
+            if (!getSide(p, end, sv.asks, anchor)) return false;
+        }
+
+        std::lock_guard diff_lock(diff_mutex_);
+        std::unique_lock lock(rw_mutex_);
+        const int64_t now_ms = clock_->nowMs();
+        spec_.price_scale = static_cast<int64_t>(ps);
+        spec_.tick_raw    = static_cast<int64_t>(tick);
+        spec_.qty_scale   = static_cast<int64_t>(qs);
+        for (size_t i = 0; i < N_EXCHANGES; ++i) {
+            resetBook(books_[i]);
+            guards_[i].reset();
+            checksums_[i].last_ok = true;
+        }
+        for (const auto& sv : saved) {
+            books_[sv.ex].applySnapshot(sv.update_id, sv.bids, sv.asks, now_ms);
+            guards_[sv.ex].restore(sv.seq_id, sv.synced);
+        }
+        diff_tracker_.rebase();
+        diff_seen_mutations_ = UINT64_MAX;
+        markDirty();
+        bbo_.reset();
+        lead_lag_.reset();
+        walls_.reset();
+        for (const auto& sv : saved) {
+            walls_.onSnapshot(sv.ex, books_[sv.ex], now_ms);
+            bookChanged(sv.ex, now_ms);
+        }
+        if (journal_.active()) writeCheckpoint(now_ms);
+        books = saved.size();
+        return true;
+    }
+
     // ── Write path — called from Node.js WS handlers ──────────────
     // These acquire a write lock (exclusive) for microseconds.
 
-    void initSnapshot(
+    // Replays deltas buffered during a resync; GAP if they still don't
+    // connect to this snapshot (another one is needed). A snapshot that
+    // fails its own checksum means we can't reproduce the venue's
+    // strings — verification is switched off for that exchange rather
+    // than resyncing forever.
+    SeqStatus initSnapshot(
         ExchangeID ex,
         uint64_t update_id,
-        const std::vector<std::pair<int64_t,double>>& bids,
-        const std::vector<std::pair<int64_t,double>>& asks
+        const std::vector<std::pair<int64_t,int64_t>>& bids,
+        const std::vector<std::pair<int64_t,int64_t>>& asks,
+        std::optional<int32_t> checksum = std::nullopt
     ) {
         std::unique_lock lock(rw_mutex_);
-        books_[idx(ex)].applySnapshot(update_id, bids, asks);
-        dirty_ = true;
+        return snapshotLocked(idx(ex), update_id, bids, asks, checksum);
     }
 
     void applyDelta(
         ExchangeID ex,
         uint64_t update_id,
-        const std::vector<std::pair<int64_t,double>>& bid_deltas,
-        const std::vector<std::pair<int64_t,double>>& ask_deltas,
+        const std::vector<std::pair<int64_t,int64_t>>& bid_deltas,
+        const std::vector<std::pair<int64_t,int64_t>>& ask_deltas,
         bool is_snap = false
     ) {
         std::unique_lock lock(rw_mutex_);
-        books_[idx(ex)].applyDelta(update_id, bid_deltas, ask_deltas, is_snap);
-        dirty_ = true;
+        if (is_snap) {
+            snapshotLocked(idx(ex), update_id, bid_deltas, ask_deltas);
+            return;
+        }
+        const int64_t now_ms = clock_->nowMs();
+        if (journaling(now_ms)) journal_.delta(now_ms, idx(ex), update_id, bid_deltas, ask_deltas);
+        auto& book = books_[idx(ex)];
+        const bool applies = book.initialized && (update_id == 0 || update_id > book.last_update_id);
+        const bool moved = book.applyDelta(update_id, bid_deltas, ask_deltas, now_ms);
+        if (applies) walls_.onDeltas(idx(ex), book, bid_deltas, ask_deltas, moved, now_ms);
+        bookChanged(idx(ex), now_ms, moved);
+        markDirty();
+    }
+
+    // Delta with venue sequence ids (see sequence_guard.hpp). Buffered
+    // while the exchange has no snapshot yet or is resyncing; GAP is
+    // returned once per gap, when the caller should fetch a snapshot.
+    SeqStatus applySequenced(
+        ExchangeID ex,
+        const DeltaSeq& seq,
+        const LevelDeltas& bid_deltas,
+        const LevelDeltas& ask_deltas
+    ) {
+        std::unique_lock lock(rw_mutex_);
+        const size_t i = idx(ex);
+        auto& guard = guards_[i];
+
+        const int64_t now_ms = clock_->nowMs();
+        if (journaling(now_ms)) journal_.sequenced(now_ms, i, seq, bid_deltas, ask_deltas);
+
+        if (guard.resyncing() || !books_[i].initialized) {
+            guard.buffer(seq, bid_deltas, ask_deltas);
+            return SeqStatus::BUFFERED;
+        }
+        const SeqStatus status = applyChecked(i, seq, bid_deltas, ask_deltas);
+        if (needsResync(status)) guard.beginResync();
+        if (status == SeqStatus::GAP) guard.buffer(seq, bid_deltas, ask_deltas);   // not yet applied
+        return status;
+    }
+
+    // Venue checksum verification for one exchange (OKX, Bitget)
+    void setChecksumVerify(ExchangeID ex, bool enabled) {
+        std::unique_lock lock(rw_mutex_);
+        auto& cs = checksums_[idx(ex)];
+        cs.enabled     = enabled;
+        cs.unsupported = false;
+    }
+
+    ChecksumState checksumState(ExchangeID ex) const {
+        std::shared_lock lock(rw_mutex_);
+        return checksums_[idx(ex)];
+    }
+
+    struct SyncState {
+        SeqMode  mode;
+        uint64_t last_id;
+        bool     resyncing;
+        size_t   pending;
+    };
+
+    SyncState syncState(ExchangeID ex) const {
+        std::shared_lock lock(rw_mutex_);
+        const auto& g = guards_[idx(ex)];
+        return SyncState{ g.mode(), g.lastId(), g.resyncing(), g.pending() };
+    }
+
+    // Single-level update from the ingestor ring (ExecutionEngine thread).
+    // Event timestamps drive a SIMULATED clock.
+    void processUpdate(const MarketPayload& m) {
+        if (m.source >= ExchangeID::MAX_EXCHANGES) return;
+        std::unique_lock lock(rw_mutex_);
+        if (m.timestamp != 0) clock_->advanceTo(m.timestamp);
+        const int64_t now_ms = clock_->nowMs();
+        auto& book = books_[idx(m.source)];
+        const int64_t lots = spec_.toLots(m.qty);
+        if (journaling(now_ms)) journal_.level(now_ms, idx(m.source), m.is_bid, m.price, lots);
+        const bool moved = m.is_bid ? book.bids.applyDelta(m.price, lots) : book.asks.applyDelta(m.price, lots);
+        book.last_seen_ms = now_ms;
+        walls_.onLevel(idx(m.source), m.is_bid, m.price, lots, book, moved, now_ms);
+        bookChanged(idx(m.source), now_ms, moved);
+        markDirty();
     }
 
     void clearExchange(ExchangeID ex) {
         std::unique_lock lock(rw_mutex_);
-        books_[idx(ex)] = ExchangeBook{};
-        dirty_ = true;
+        const int64_t now_ms = clock_->nowMs();
+        if (journaling(now_ms)) journal_.clear(now_ms, idx(ex));
+        resetVenue(idx(ex), now_ms);
+        bookChanged(idx(ex), now_ms);
+        markDirty();
+    }
+
+    void clearAll() {
+        std::unique_lock lock(rw_mutex_);
+        const int64_t now_ms = clock_->nowMs();
+        if (journaling(now_ms)) journal_.clear(now_ms, ALL_EXCHANGES);
+        for (size_t i = 0; i < N_EXCHANGES; ++i) resetVenue(i, now_ms);
+        walls_.reset();   // a whole-symbol clear starts the fate counts over
+        for (size_t i = 0; i < N_EXCHANGES; ++i) bookChanged(i, now_ms);
+        markDirty();
+    }
+
+    // bps distances the running band depth is kept for (all exchanges)
+    void setDepthBands(const DepthBands& bands) {
+        std::unique_lock lock(rw_mutex_);
+        bands_ = bands;
+        bands_.count = std::min(bands_.count, MAX_DEPTH_BANDS);
+        for (auto& book : books_) book.setBands(bands_);
     }
 
     // ── Read path — called from broadcast timer every 250ms ────────
@@ -49,69 +337,443 @@ public:
         std::shared_lock lock(rw_mutex_);
 
         // Merge all active exchange books into unified bid/ask maps
-        // Using std::map here is fine — we call this only 4x/sec
-        std::map<int64_t, double, std::greater<int64_t>> merged_bids;
-        std::map<int64_t, double, std::less<int64_t>>    merged_asks;
+        // Using std::map here is fine — we call this only 4x/sec.
+        // Lots are integers, so merged sizes are exact.
+        std::map<int64_t, int64_t, std::greater<int64_t>> merged_bids;
+        std::map<int64_t, int64_t, std::less<int64_t>>    merged_asks;
 
+        const int64_t now_ms = clock_->nowMs();
         for (size_t i = 0; i < N_EXCHANGES; ++i) {
             const auto& book = books_[i];
-            if (!book.initialized || book.isStale()) continue;
+            if (!book.initialized || book.isStale(now_ms)) continue;
 
             // Merge bids
             Level buf[MAX_LEVELS];
             size_t n = book.bids.topN(buf, MAX_LEVELS);
             for (size_t j = 0; j < n; ++j) {
-                merged_bids[buf[j].price_raw] += buf[j].qty;
+                merged_bids[buf[j].price_raw] += buf[j].qty_lots;
             }
 
             // Merge asks
             n = book.asks.topN(buf, MAX_LEVELS);
             for (size_t j = 0; j < n; ++j) {
-                merged_asks[buf[j].price_raw] += buf[j].qty;
+                merged_asks[buf[j].price_raw] += buf[j].qty_lots;
             }
         }
 
         AggregatedSnapshot snap{};
-        snap.timestamp_ms = currentMs();
+        snap.timestamp_ms = now_ms;
+        snap.price_scale  = spec_.price_scale;
+        snap.qty_scale    = spec_.qty_scale;
 
-        // Write top N into output arrays
+        // Write top N into output arrays, totalling them for the walls
         size_t bi = 0;
+        int64_t bid_lots = 0;
         for (auto& pair : merged_bids) {
             if (bi >= levels) break;
             snap.bids[bi++] = Level{ pair.first, pair.second };
+            bid_lots += pair.second;
         }
         snap.bid_count = bi;
 
         size_t ai = 0;
+        int64_t ask_lots = 0;
         for (auto& pair : merged_asks) {
             if (ai >= levels) break;
             snap.asks[ai++] = Level{ pair.first, pair.second };
+            ask_lots += pair.second;
         }
         snap.ask_count = ai;
 
         // BBO + spread
-        snap.best_bid = bi > 0 ? snap.bids[0].price_f() : 0;
-        snap.best_ask = ai > 0 ? snap.asks[0].price_f() : 0;
+        snap.best_bid = bi > 0 ? snap.bids[0].price_f(spec_.price_scale) : 0;
+        snap.best_ask = ai > 0 ? snap.asks[0].price_f(spec_.price_scale) : 0;
         snap.spread   = snap.best_ask - snap.best_bid;
         snap.mid_price = (snap.best_bid + snap.best_ask) / 2.0;
 
         // Wall detection
-        WallDetector::detect(snap);
+        WallDetector::detect(snap, bid_lots, ask_lots);
 
         return snap;
     }
 
+    // ── Multi-resolution bucketed depth ──────────────────────────
+    // One pass over every tracked level (up to 500/side/exchange, not
+    // just the top 50) fills all resolutions at once. Steps are in quote
+    // units; steps == nullptr defaults to 10/100/500/1000 ticks.
+    void getBucketedDepth(const double* steps, size_t n_res, size_t buckets, BucketedDepth& out) const {
+        static constexpr int64_t DEFAULT_STEP_TICKS[] = { 10, 100, 500, 1000 };
+        n_res = steps ? std::min(n_res, MAX_DEPTH_RESOLUTIONS) : std::size(DEFAULT_STEP_TICKS);
+        out.resolutions = n_res;
+        out.buckets     = buckets;
+        out.bid_qty.assign(n_res * buckets, 0);
+        out.ask_qty.assign(n_res * buckets, 0);
+
+        std::shared_lock lock(rw_mutex_);
+        out.price_scale = spec_.price_scale;
+        out.qty_scale   = spec_.qty_scale;
+
+        // Consolidated touch anchors bucket 0 on each side
+        const int64_t now_ms = clock_->nowMs();
+        int64_t best_bid = 0, best_ask = 0;
+        for (const auto& book : books_) {
+            if (!book.initialized || book.isStale(now_ms)) continue;
+            if (!book.bids.empty()) best_bid = std::max(best_bid, book.bids.bestPrice());
+            if (!book.asks.empty()) best_ask = best_ask == 0 ? book.asks.bestPrice() : std::min(best_ask, book.asks.bestPrice());
+        }
+
+        out.best_bid_raw = best_bid;
+        out.best_ask_raw = best_ask;
+
+        int64_t bid_top[MAX_DEPTH_RESOLUTIONS], ask_top[MAX_DEPTH_RESOLUTIONS];
+        for (size_t r = 0; r < n_res; ++r) {
+            const int64_t step = std::max<int64_t>(1, steps ? spec_.toRaw(steps[r]) : DEFAULT_STEP_TICKS[r] * spec_.tick_raw);
+            out.step_raw[r]      = step;
+            bid_top[r]           = best_bid / step;
+            ask_top[r]           = (best_ask + step - 1) / step;
+            out.bid_start_raw[r] = bid_top[r] * step;
+            out.ask_start_raw[r] = ask_top[r] * step;
+        }
+        if (buckets == 0) return;
+
+        for (const auto& book : books_) {
+            if (!book.initialized || book.isStale(now_ms)) continue;
+
+            const Level* lv = book.bids.data();
+            for (size_t i = 0, n = book.bids.size(); i < n; ++i) {
+                size_t in_range = 0;
+                for (size_t r = 0; r < n_res; ++r) {
+                    int64_t j = bid_top[r] - lv[i].price_raw / out.step_raw[r];
+                    if (j < 0 || static_cast<size_t>(j) >= buckets) continue;
+                    out.bid_qty[r * buckets + j] += lv[i].qty_lots;
+                    ++in_range;
+                }
+                if (in_range == 0 && lv[i].price_raw < best_bid) break;   // past the widest window
+            }
+
+            lv = book.asks.data();
+            for (size_t i = 0, n = book.asks.size(); i < n; ++i) {
+                size_t in_range = 0;
+                for (size_t r = 0; r < n_res; ++r) {
+                    int64_t j = (lv[i].price_raw + out.step_raw[r] - 1) / out.step_raw[r] - ask_top[r];
+                    if (j < 0 || static_cast<size_t>(j) >= buckets) continue;
+                    out.ask_qty[r * buckets + j] += lv[i].qty_lots;
+                    ++in_range;
+                }
+                if (in_range == 0 && lv[i].price_raw > best_ask) break;
+            }
+        }
+    }
+
+    // ── Depth on an absolute price grid ───────────────────────────
+    // Resting lots of every live book, both sides, in rows of `step`
+    // quote units — row r holds [r·step, (r+1)·step) — over `lots.size()`
+    // rows centred on the consolidated mid. Returns the first row, or
+    // INT64_MIN (lots untouched) with no live book. Used by the heatmap
+    // history (depth_history.hpp).
+    int64_t getDepthRows(double step, std::vector<int64_t>& lots, int64_t& qty_scale) const {
+        std::shared_lock lock(rw_mutex_);
+        const int64_t now_ms = clock_->nowMs();
+        int64_t best_bid = 0, best_ask = 0;
+        for (const auto& book : books_) {
+            if (!book.initialized || book.isStale(now_ms)) continue;
+            if (!book.bids.empty()) best_bid = std::max(best_bid, book.bids.bestPrice());
+            if (!book.asks.empty()) best_ask = best_ask == 0 ? book.asks.bestPrice() : std::min(best_ask, book.asks.bestPrice());
+        }
+        if (best_bid == 0 && best_ask == 0) return INT64_MIN;
+
+        const int64_t step_raw = std::max<int64_t>(1, spec_.toRaw(step));
+        const int64_t mid  = best_bid == 0 ? best_ask : best_ask == 0 ? best_bid : (best_bid + best_ask) / 2;
+        const int64_t rows = static_cast<int64_t>(lots.size());
+        const int64_t base = mid / step_raw - rows / 2;
+        qty_scale = spec_.qty_scale;
+        std::fill(lots.begin(), lots.end(), 0);
+
+        for (const auto& book : books_) {
+            if (!book.initialized || book.isStale(now_ms)) continue;
+            const Level* lv = book.bids.data();
+            for (size_t i = 0, n = book.bids.size(); i < n; ++i) {
+                const int64_t r = lv[i].price_raw / step_raw - base;
+                if (r < 0) break;
+                if (r < rows) lots[static_cast<size_t>(r)] += lv[i].qty_lots;
+            }
+            lv = book.asks.data();
+            for (size_t i = 0, n = book.asks.size(); i < n; ++i) {
+                const int64_t r = lv[i].price_raw / step_raw - base;
+                if (r >= rows) break;
+                if (r >= 0) lots[static_cast<size_t>(r)] += lv[i].qty_lots;
+            }
+        }
+        return base;
+    }
+
+    // ── Running depth ─────────────────────────────────────────────
+    // Maintained by the books on every delta, so this is cheap enough to
+    // poll at any rate. Same active-exchange filter as the merge.
+    void getDepthStats(DepthSummary& out) const {
+        std::shared_lock lock(rw_mutex_);
+        out = DepthSummary{};
+        out.bands       = bands_;
+        out.price_scale = spec_.price_scale;
+        out.qty_scale   = spec_.qty_scale;
+
+        const int64_t now_ms = clock_->nowMs();
+        for (size_t i = 0; i < N_EXCHANGES; ++i) {
+            const auto& book = books_[i];
+            if (!book.initialized || book.isStale(now_ms)) continue;
+            out.active |= static_cast<uint8_t>(1u << i);
+            out.ex_bids[i] = book.bids.stats();
+            out.ex_asks[i] = book.asks.stats();
+            accumulate(out.bids, out.ex_bids[i]);
+            accumulate(out.asks, out.ex_asks[i]);
+        }
+    }
+
+    // ── Microprice / imbalance (book_signals.hpp) ──────────────────
+    // Sampled on every book change; windows decayed to the current time
+    BookSignalsSnapshot getSignals() const {
+        std::shared_lock lock(rw_mutex_);
+        BookSignalsSnapshot s = signals_.snapshot(clock_->nowMs());
+        s.bands = bands_;
+        return s;
+    }
+
+    // venue = ExchangeID, or SIGNAL_ALL for the consolidated book
+    size_t getSignalSeries(size_t venue, int64_t since_ms, std::vector<double>& out) const {
+        std::shared_lock lock(rw_mutex_);
+        return signals_.series(venue, since_ms, out);
+    }
+
+    // ── Per-venue BBO, crosses and deviations (bbo_tracker.hpp) ───
+    void setBboConfig(const BboConfig<N_EXCHANGES>& config) {
+        std::unique_lock lock(rw_mutex_);
+        bbo_.setConfig(config);
+    }
+
+    BboConfig<N_EXCHANGES> bboConfig() const {
+        std::shared_lock lock(rw_mutex_);
+        return bbo_.config();
+    }
+
+    BboTable<N_EXCHANGES> getBbo() const {
+        std::shared_lock lock(rw_mutex_);
+        return bbo_.table(clock_->nowMs());
+    }
+
+    // Events queued since the last call, oldest first. One atomic load
+    // when there are none, as after most deltas.
+    size_t takeBboEvents(std::vector<BboEvent>& out) {
+        out.clear();
+        if (!bbo_pending_.load(std::memory_order_acquire)) return 0;
+        std::unique_lock lock(rw_mutex_);
+        bbo_.take(out);
+        bbo_pending_.store(false, std::memory_order_relaxed);
+        return out.size();
+    }
+
+    // ── Cross-venue lead-lag (lead_lag.hpp) — republished every second
+    LeadLagMatrix<N_EXCHANGES> getLeadLag() const {
+        std::shared_lock lock(rw_mutex_);
+        return lead_lag_.matrix();
+    }
+
+    // ── Wall lifetimes (wall_tracker.hpp) ──────────────────────────
+    // Trades credit fills to the walls they hit; side +1 = aggressive buy
+    void onTrade(ExchangeID ex, double price, double qty, int8_t side) {
+        if (ex >= ExchangeID::MAX_EXCHANGES) return;
+        std::unique_lock lock(rw_mutex_);
+        walls_.onTrade(idx(ex), spec_.toRaw(price), spec_.toLots(qty), side, clock_->nowMs());
+    }
+
+    // Returns now, the time live walls' ages are measured to
+    int64_t getWalls(std::vector<WallRecord>& live, std::vector<WallRecord>& dead,
+                     std::array<std::array<uint64_t, WALL_FATES>, N_EXCHANGES>& counts) const {
+        std::shared_lock lock(rw_mutex_);
+        walls_.collect(live, dead);
+        counts = walls_.counts();
+        return clock_->nowMs();
+    }
+
+    // Bit i set = exchange i initialized and fresh (i.e. part of the merge)
+    uint8_t activeMask() const {
+        std::shared_lock lock(rw_mutex_);
+        const int64_t now_ms = clock_->nowMs();
+        uint8_t mask = 0;
+        for (size_t i = 0; i < N_EXCHANGES; ++i) {
+            if (books_[i].initialized && !books_[i].isStale(now_ms)) mask |= static_cast<uint8_t>(1u << i);
+        }
+        return mask;
+    }
+
+    // ── Incremental diff — only levels changed since `since` ────────
+    // Re-merges only when the books mutated or an exchange went stale;
+    // otherwise the tracker's last snapshot is diffed as-is.
+    AggregatedDiff getAggregatedDiff(uint64_t since) {
+        uint64_t mutations = mutations_.load(std::memory_order_acquire);
+        uint8_t  active    = activeMask();
+
+        std::lock_guard lock(diff_mutex_);
+        if (mutations != diff_seen_mutations_ || active != diff_seen_active_) {
+            diff_tracker_.observe(getAggregated(OUTPUT_LEVELS));
+            diff_seen_mutations_ = mutations;
+            diff_seen_active_    = active;
+        }
+
+        AggregatedDiff diff;
+        diff_tracker_.diffSince(since, diff);
+        return diff;
+    }
+
     bool isDirty() const { return dirty_.load(); }
     void clearDirty()    { dirty_ = false; }
 
 private:
     mutable std::shared_mutex rw_mutex_;
     std::array<ExchangeBook, N_EXCHANGES> books_;
+    InstrumentSpec spec_;
+    DepthBands     bands_;
+    Clock*         clock_ = &Clock::process();
+    JournalStream  journal_;
+    std::array<SequenceGuard, N_EXCHANGES> guards_ = makeGuards();
+    std::array<ChecksumState, N_EXCHANGES> checksums_;
+    BookSignals    signals_;
+    BboTracker<N_EXCHANGES> bbo_;
+    LeadLagEngine<N_EXCHANGES> lead_lag_;
+    WallTracker<N_EXCHANGES> walls_;
+    std::atomic<bool> bbo_pending_{ false };   // bbo_ has queued events
     std::atomic<bool> dirty_{ false };
+    std::atomic<uint64_t> mutations_{ 0 };   // bumped on every write; diff consumers compare
 
-    static size_t idx(ExchangeID ex) { return static_cast<size_t>(ex); }
-    static int64_t currentMs() {
-        using namespace std::chrono;
-        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    std::mutex          diff_mutex_;
+    SnapshotDiffTracker diff_tracker_;
+    uint64_t            diff_seen_mutations_ = UINT64_MAX;
+    uint8_t             diff_seen_active_    = 0;
+
+    // Empty venue i's book and its per-venue state; the caller then runs
+    // bookChanged once every cleared book is empty. Write lock held.
+    void resetVenue(size_t i, int64_t now_ms) {
+        resetBook(books_[i]);
+        guards_[i].reset();
+        checksums_[i].last_ok = true;
+        walls_.onClear(i, now_ms);
+    }
+
+    // Caller holds rw_mutex_ exclusively, after book i changed;
+    // touch_moved = its best price did (see BboTracker)
+    void bookChanged(size_t i, int64_t now_ms, bool touch_moved = true) {
+        signals_.update(books_, i, bands_, spec_.price_scale, now_ms);
+        bbo_.update(books_, i, touch_moved, spec_, now_ms);
+        flagBboEvents();
+        if (touch_moved) lead_lag_.onTouch(i, books_[i], spec_, now_ms);
+    }
+
+    void flagBboEvents() {
+        if (bbo_.hasEvents()) bbo_pending_.store(true, std::memory_order_release);
+    }
+
+    void markDirty() {
+        dirty_ = true;
+        mutations_.fetch_add(1, std::memory_order_release);
+    }
+
+    static std::array<SequenceGuard, N_EXCHANGES> makeGuards() {
+        std::array<SequenceGuard, N_EXCHANGES> guards;
+        for (size_t i = 0; i < N_EXCHANGES; ++i) guards[i] = SequenceGuard(seqModeFor(static_cast<ExchangeID>(i)));
+        return guards;
+    }
+
+    // Caller holds rw_mutex_ exclusively
+    SeqStatus snapshotLocked(size_t i, uint64_t update_id, const LevelDeltas& bids, const LevelDeltas& asks,
+                             std::optional<int32_t> checksum = std::nullopt) {
+        const int64_t now_ms = clock_->nowMs();
+        if (journaling(now_ms)) {
+            journal_.snapshot(now_ms, i, update_id, bids.data(), bids.size(), asks.data(), asks.size(), checksum, false);
+        }
+
+        auto& guard = guards_[i];
+        books_[i].applySnapshot(update_id, bids, asks, now_ms);
+        guard.onSnapshot(update_id);
+        walls_.onSnapshot(i, books_[i], now_ms);
+        bookChanged(i, now_ms);
+        markDirty();
+
+        auto& cs = checksums_[i];
+        if (checksum && !cs.verify(books_[i], spec_.price_scale, spec_.qty_scale, *checksum)) {
+            cs.enabled     = false;
+            cs.unsupported = true;
+        }
+
+        auto pending = guard.takePending();
+        if (guard.mode() == SeqMode::NONE) pending.clear();
+
+        while (!pending.empty()) {
+            const SeqStatus status = applyChecked(i, pending.front().seq, pending.front().bids, pending.front().asks);
+            if (needsResync(status)) {
+                if (status == SeqStatus::CHECKSUM) pending.pop_front();   // already applied
+                guard.beginResync();
+                guard.restorePending(std::move(pending));
+                return status;
+            }
+            pending.pop_front();
+        }
+        return SeqStatus::APPLIED;
+    }
+
+    SeqStatus applyChecked(size_t i, const DeltaSeq& seq, const LevelDeltas& bids, const LevelDeltas& asks) {
+        switch (guards_[i].check(seq)) {
+            case SequenceGuard::Verdict::STALE: return SeqStatus::STALE;
+            case SequenceGuard::Verdict::GAP:   return SeqStatus::GAP;
+            case SequenceGuard::Verdict::APPLY: break;
+        }
+        const int64_t now_ms = clock_->nowMs();
+        const bool moved = books_[i].applyDelta(0, bids, asks, now_ms);
+        walls_.onDeltas(i, books_[i], bids, asks, moved, now_ms);
+        guards_[i].commit(seq);
+        bookChanged(i, now_ms, moved);
+        markDirty();
+
+        if (seq.checksum && !checksums_[i].verify(books_[i], spec_.price_scale, spec_.qty_scale, *seq.checksum)) {
+            return SeqStatus::CHECKSUM;
+        }
+        return SeqStatus::APPLIED;
+    }
+
+    // Caller holds rw_mutex_ exclusively. Called before the event is
+    // applied, so a checkpoint holds the books the event then applies to.
+    bool journaling(int64_t now_ms) {
+        if (!journal_.active()) return false;
+        if (journal_.checkpointDue(now_ms)) writeCheckpoint(now_ms);
+        return true;
+    }
+
+    // Sequenced books restart from the guard's id, so replayed deltas
+    // are validated exactly as the live ones were
+    void writeCheckpoint(int64_t now_ms) {
+        size_t live = 0;
+        for (const auto& book : books_) live += book.initialized ? 1 : 0;
+        journal_.checkpoint(now_ms, spec_, live);
+
+        for (size_t i = 0; i < N_EXCHANGES; ++i) {
+            const auto& book = books_[i];
+            if (!book.initialized) continue;
+            journal_.snapshot(now_ms, i, std::max(book.last_update_id, guards_[i].lastId()),
+                              book.bids.data(), book.bids.size(), book.asks.data(), book.asks.size(),
+                              std::nullopt, true);
+        }
     }
+
+    bool saveable(size_t i) const { return books_[i].initialized && !guards_[i].resyncing(); }
+
+    void resetBook(ExchangeBook& book) const {
+        book = ExchangeBook{};
+        book.setBands(bands_);
+    }
+
+    static void accumulate(DepthStats& into, const DepthStats& s) {
+        into.total_lots   += s.total_lots;
+        into.notional_raw += s.notional_raw;
+        for (size_t k = 0; k < MAX_DEPTH_BANDS; ++k) into.band_lots[k] += s.band_lots[k];
+    }
+
+    static size_t idx(ExchangeID ex) { return static_cast<size_t>(ex); }
 };
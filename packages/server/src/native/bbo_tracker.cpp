@@ -0,0 +1,2 @@
+#include "bbo_tracker.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,251 @@
+#pragma once
+#include "orderbook.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// ── Cross-venue BBO tracker ───────────────────────────────────
+// Every venue's best bid / ask, kept as the books change, and two
+// detectors run over them:
+//   - cross: venue S's bid exceeds venue B's ask after both taker fees —
+//     buy on B, sell on S — by more than min_edge_bps of their mid;
+//   - deviation: a venue's mid is more than deviation_bps from the
+//     consolidated mid (best bid / best ask over the fresh venues).
+// Both are edge-triggered: an event when a condition starts, another
+// (with its duration and peak) when it ends. The aggregator queues them
+// under its write lock and the binding that applied the update hands
+// them to JS before returning, so they arrive with the update itself.
+//
+// A venue's row is refreshed in O(1) on every change to its book. The
+// detectors only run when OrderbookSide::applyDelta reports the touch
+// moved (a size change at the same price neither opens nor closes a
+// cross), and only over the pairs involving that venue. Stale and
+// uninitialized venues take no part; their open conditions close the
+// next time a detector looks at them.
+
+constexpr size_t BBO_MAX_EVENTS = 4096;   // queued between drains; more are counted, not kept
+
+struct BboQuote {
+    double  bid      = 0;   // quote units, 0 = side empty
+    double  bid_qty  = 0;   // base units
+    double  ask      = 0;
+    double  ask_qty  = 0;
+    int64_t seen_ms  = 0;   // last update to this venue's book
+
+    double mid() const { return (bid + ask) / 2; }
+};
+
+enum class BboEventKind : uint8_t { CROSS, CROSS_END, DEVIATION, DEVIATION_END };
+
+struct BboEvent {
+    BboEventKind kind     = BboEventKind::CROSS;
+    uint8_t      buy      = 0;   // cross: venue lifted at its ask; deviation: the venue
+    uint8_t      sell     = 0;   // cross: venue hit at its bid; deviation: the venue
+    int64_t      ts_ms    = 0;
+    int64_t      since_ms = 0;   // when the condition began (ts_ms for a start)
+    double       bps      = 0;   // cross: edge after fees; deviation: venue mid − consolidated mid
+    double       peak_bps = 0;   // largest |bps| while it lasted
+    double       buy_px   = 0;   // cross: ask on `buy`; deviation: venue mid
+    double       sell_px  = 0;   // cross: bid on `sell`; deviation: consolidated mid
+    double       qty      = 0;   // cross: smaller of the two touch sizes
+};
+
+template <size_t N>
+struct BboConfig {
+    std::array<double, N> fee_bps;   // taker fee per venue
+    double min_edge_bps  = 0;        // cross once the after-fee edge exceeds this
+    double deviation_bps = 25;
+
+    BboConfig() { fee_bps.fill(5); }
+};
+
+template <size_t N>
+struct BboTable {
+    int64_t ts_ms = 0;
+    std::array<BboQuote, N> quotes;
+    std::array<bool, N>     live{};       // initialized, fresh, both sides quoted
+    double  bid = 0, ask = 0;             // consolidated touch over the live venues
+    std::vector<BboEvent> open;           // conditions in progress, as their start events
+    uint64_t dropped = 0;                 // events lost to a full queue, all time
+};
+
+template <size_t N>
+class BboTracker {
+public:
+    void setConfig(const BboConfig<N>& config) { config_ = config; }
+    const BboConfig<N>& config() const { return config_; }
+
+    // Venue `touched` changed (touched ≥ N: every venue, e.g. after a
+    // clear). `touch_moved` = its best bid or ask price changed.
+    void update(const std::array<ExchangeBook, N>& books, size_t touched, bool touch_moved,
+                const InstrumentSpec& spec, int64_t now_ms) {
+        if (touched < N) {
+            refresh(books[touched], spec, quotes_[touched]);
+            if (!touch_moved) return;
+        } else {
+            for (size_t v = 0; v < N; ++v) refresh(books[v], spec, quotes_[v]);
+        }
+
+        std::array<bool, N> live;
+        double best_bid = 0, best_ask = 0;
+        size_t n_live = 0;
+        for (size_t v = 0; v < N; ++v) {
+            live[v] = isLive(quotes_[v], now_ms);
+            if (!live[v]) continue;
+            best_bid = n_live == 0 ? quotes_[v].bid : std::max(best_bid, quotes_[v].bid);
+            best_ask = n_live == 0 ? quotes_[v].ask : std::min(best_ask, quotes_[v].ask);
+            ++n_live;
+        }
+
+        for (size_t b = 0; b < N; ++b) {
+            for (size_t s = 0; s < N; ++s) {
+                if (b == s || (touched < N && b != touched && s != touched)) continue;
+                checkCross(b, s, live[b] && live[s], now_ms);
+            }
+        }
+        const double mid = (best_bid + best_ask) / 2;
+        for (size_t v = 0; v < N; ++v) checkDeviation(v, live[v] && n_live > 1, mid, now_ms);
+    }
+
+    bool hasEvents() const { return !events_.empty(); }
+
+    // Hand over the queued events, oldest first
+    void take(std::vector<BboEvent>& out) {
+        out.clear();
+        out.swap(events_);
+    }
+
+    BboTable<N> table(int64_t now_ms) const {
+        BboTable<N> t;
+        t.ts_ms   = now_ms;
+        t.quotes  = quotes_;
+        t.dropped = dropped_;
+        size_t n_live = 0;
+        for (size_t v = 0; v < N; ++v) {
+            t.live[v] = isLive(quotes_[v], now_ms);
+            if (!t.live[v]) continue;
+            t.bid = n_live == 0 ? quotes_[v].bid : std::max(t.bid, quotes_[v].bid);
+            t.ask = n_live == 0 ? quotes_[v].ask : std::min(t.ask, quotes_[v].ask);
+            ++n_live;
+        }
+        for (size_t b = 0; b < N; ++b) {
+            for (size_t s = 0; s < N; ++s) {
+                if (crosses_[b][s].active) t.open.push_back(crosses_[b][s].start);
+            }
+            if (deviations_[b].active) t.open.push_back(deviations_[b].start);
+        }
+        return t;
+    }
+
+    // Forget every quote and open condition without emitting anything
+    void reset() {
+        quotes_.fill(BboQuote{});
+        for (auto& row : crosses_) row.fill(Condition{});
+        deviations_.fill(Condition{});
+        events_.clear();
+    }
+
+private:
+    struct Condition {
+        bool     active = false;
+        BboEvent start;               // the event that opened it
+        double   peak_bps = 0;
+    };
+
+    std::array<BboQuote, N> quotes_;
+    std::array<std::array<Condition, N>, N> crosses_;   // [buy][sell]
+    std::array<Condition, N> deviations_;
+    BboConfig<N> config_;
+    std::vector<BboEvent> events_;
+    uint64_t dropped_ = 0;
+
+    static void refresh(const ExchangeBook& book, const InstrumentSpec& spec, BboQuote& q) {
+        q.bid     = book.bids.empty() ? 0 : spec.toPrice(book.bids.data()[0].price_raw);
+        q.bid_qty = book.bids.empty() ? 0 : spec.toQty(book.bids.data()[0].qty_lots);
+        q.ask     = book.asks.empty() ? 0 : spec.toPrice(book.asks.data()[0].price_raw);
+        q.ask_qty = book.asks.empty() ? 0 : spec.toQty(book.asks.data()[0].qty_lots);
+        q.seen_ms = book.initialized ? book.last_seen_ms : 0;
+    }
+
+    static bool isLive(const BboQuote& q, int64_t now_ms) {
+        return q.seen_ms != 0 && q.bid > 0 && q.ask > 0 && now_ms - q.seen_ms <= ExchangeBook::STALE_MS;
+    }
+
+    void checkCross(size_t b, size_t s, bool both_live, int64_t now_ms) {
+        Condition& c = crosses_[b][s];
+        double edge = 0;
+        if (both_live) {
+            const BboQuote& buy = quotes_[b];
+            const BboQuote& sell = quotes_[s];
+            const double net = sell.bid * (1 - config_.fee_bps[s] / 1e4) - buy.ask * (1 + config_.fee_bps[b] / 1e4);
+            edge = net / ((buy.ask + sell.bid) / 2) * 1e4;
+        }
+        if (both_live && edge > config_.min_edge_bps) {
+            if (c.active) {
+                c.peak_bps = std::max(c.peak_bps, edge);
+                return;
+            }
+            BboEvent e;
+            e.kind     = BboEventKind::CROSS;
+            e.buy      = static_cast<uint8_t>(b);
+            e.sell     = static_cast<uint8_t>(s);
+            e.ts_ms    = e.since_ms = now_ms;
+            e.bps      = e.peak_bps = edge;
+            e.buy_px   = quotes_[b].ask;
+            e.sell_px  = quotes_[s].bid;
+            e.qty      = std::min(quotes_[b].ask_qty, quotes_[s].bid_qty);
+            open(c, e);
+        } else if (c.active) {
+            close(c, BboEventKind::CROSS_END, edge, quotes_[b].ask, quotes_[s].bid, now_ms);
+        }
+    }
+
+    void checkDeviation(size_t v, bool comparable, double mid, int64_t now_ms) {
+        Condition& c = deviations_[v];
+        const double dev = comparable && mid > 0 ? (quotes_[v].mid() - mid) / mid * 1e4 : 0;
+        if (comparable && std::abs(dev) > config_.deviation_bps) {
+            if (c.active) {
+                if (std::abs(dev) > std::abs(c.peak_bps)) c.peak_bps = dev;
+                return;
+            }
+            BboEvent e;
+            e.kind     = BboEventKind::DEVIATION;
+            e.buy      = e.sell = static_cast<uint8_t>(v);
+            e.ts_ms    = e.since_ms = now_ms;
+            e.bps      = e.peak_bps = dev;
+            e.buy_px   = quotes_[v].mid();
+            e.sell_px  = mid;
+            open(c, e);
+        } else if (c.active) {
+            close(c, BboEventKind::DEVIATION_END, dev, quotes_[v].mid(), mid, now_ms);
+        }
+    }
+
+    void open(Condition& c, const BboEvent& e) {
+        c.active   = true;
+        c.start    = e;
+        c.peak_bps = e.bps;
+        push(e);
+    }
+
+    void close(Condition& c, BboEventKind kind, double bps, double buy_px, double sell_px, int64_t now_ms) {
+        BboEvent e = c.start;
+        e.kind     = kind;
+        e.ts_ms    = now_ms;
+        e.bps      = bps;
+        e.peak_bps = c.peak_bps;
+        e.buy_px   = buy_px;
+        e.sell_px  = sell_px;
+        c.active   = false;
+        push(e);
+    }
+
+    void push(const BboEvent& e) {
+        if (events_.size() >= BBO_MAX_EVENTS) {
+            ++dropped_;
+            return;
+        }
+        events_.push_back(e);
+    }
+};
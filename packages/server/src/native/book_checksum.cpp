@@ -0,0 +1,2 @@
+#include "book_checksum.hpp"
+// Implementation is inline in header.
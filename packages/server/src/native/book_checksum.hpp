@@ -0,0 +1,133 @@
+#pragma once
+#include "orderbook.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+// ── Venue book checksums (OKX, Bitget) ────────────────────────
+// Both venues publish a CRC32 (IEEE/zlib polynomial, as a signed int32)
+// over the top 25 levels, interleaved as
+//   "bid1px:bid1sz:ask1px:ask1sz:bid2px:bid2sz:..."
+// with the shorter side simply running out. Numbers are the venue's own
+// strings, which for both are plain decimals without trailing zeros —
+// exactly what formatDecimal() rebuilds from the integer book.
+//
+// The string is formatted straight into a stack buffer and hashed with a
+// slicing-by-8 table CRC. (SSE4.2's crc32 instruction is CRC-32C, a
+// different polynomial, so it can't be used here; at ~1KB per check the
+// formatting costs more than the CRC anyway.)
+
+namespace BookChecksum {
+
+constexpr size_t DEPTH = 25;
+
+// ── CRC32 (reflected 0xEDB88320), slicing-by-8 ─────────────────
+inline const std::array<std::array<uint32_t, 256>, 8>& crcTables() {
+    static const auto tables = [] {
+        std::array<std::array<uint32_t, 256>, 8> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (size_t s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+        }
+        return t;
+    }();
+    return tables;
+}
+
+inline uint32_t crc32(const char* data, size_t len) {
+    const auto& t = crcTables();
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;   // little-endian: byte 0 is the low byte
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+    while (len--) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ── Integer → venue decimal string ─────────────────────────────
+// raw / scale with trailing zeros (and a bare '.') dropped. Returns the
+// length written; `out` needs 42 bytes.
+inline size_t formatDecimal(int64_t raw, int64_t scale, char* out) {
+    char* p = out;
+    if (raw < 0) { *p++ = '-'; raw = -raw; }
+
+    char digits[24];
+    size_t n = 0;
+    int64_t whole = raw / scale;
+    do { digits[n++] = static_cast<char>('0' + whole % 10); whole /= 10; } while (whole > 0);
+    while (n > 0) *p++ = digits[--n];
+
+    int64_t frac = raw % scale;
+    if (frac != 0) {
+        *p++ = '.';
+        for (int64_t unit = scale / 10; unit > 0 && frac > 0; unit /= 10) {
+            *p++ = static_cast<char>('0' + frac / unit);
+            frac %= unit;
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+// Venue checksum of a book's current top DEPTH levels
+inline int32_t compute(const ExchangeBook& book, int64_t price_scale, int64_t qty_scale) {
+    char buf[DEPTH * 4 * 43];
+    size_t len = 0;
+
+    auto put = [&buf, &len, price_scale, qty_scale](const Level& lv) {
+        len += formatDecimal(lv.price_raw, price_scale, buf + len);
+        buf[len++] = ':';
+        len += formatDecimal(lv.qty_lots, qty_scale, buf + len);
+        buf[len++] = ':';
+    };
+
+    const size_t nb = std::min(book.bids.size(), DEPTH);
+    const size_t na = std::min(book.asks.size(), DEPTH);
+    for (size_t i = 0; i < std::max(nb, na); ++i) {
+        if (i < nb) put(book.bids.data()[i]);
+        if (i < na) put(book.asks.data()[i]);
+    }
+    if (len > 0) --len;   // trailing ':'
+    return static_cast<int32_t>(crc32(buf, len));
+}
+
+} // namespace BookChecksum
+
+// Per-exchange verification switch + cost accounting
+struct ChecksumState {
+    bool     enabled     = false;
+    bool     unsupported = false;   // a snapshot failed its own checksum — switched off
+    uint64_t checked     = 0;
+    uint64_t mismatches  = 0;
+    uint64_t total_ns    = 0;
+    uint64_t max_ns      = 0;
+    bool     last_ok     = true;
+
+    // True if `expected` matches the book (or verification is off)
+    bool verify(const ExchangeBook& book, int64_t price_scale, int64_t qty_scale, int32_t expected) {
+        if (!enabled) return true;
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const int32_t actual = BookChecksum::compute(book, price_scale, qty_scale);
+        const auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+
+        ++checked;
+        total_ns += ns;
+        max_ns = std::max(max_ns, ns);
+        last_ok = actual == expected;
+        if (!last_ok) ++mismatches;
+        return last_ok;
+    }
+};
@@ -0,0 +1,2 @@
+#include "book_journal.hpp"
+// Implementation is inline in header.
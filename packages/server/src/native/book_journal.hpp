@@ -0,0 +1,751 @@
+#ifndef BOOK_JOURNAL_HPP
+#define BOOK_JOURNAL_HPP
+
+#include "types.hpp"
+#include "clock.hpp"
+#include "sequence_guard.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Append-only binary journal of every book input, so any past moment of
+// any symbol's book can be rebuilt by replaying it.
+//
+// Aggregators encode their inputs (snapshots, deltas with their venue ids,
+// clears, instrument changes) into compact records and push them onto a
+// byte ring; a writer thread copies them into mmapped segment files, so
+// the hot path never touches the file system.
+//
+//   segment   journal-00000001.tjl: 64-byte header, then records until a
+//             zero type byte (the unwritten tail of the mapping) or EOF.
+//   record    [u8 type][varint body length][body]
+//   body      varint stream (symbol id), zigzag ms since the stream's
+//             previous record, u8 exchange, then the type's fields.
+//   levels    varint count, then per level zigzag(price - previous price)
+//             and varint lots. The first price of a side is relative to
+//             the first price of that side in the stream's previous record
+//             for the same exchange — usually a tick or two away.
+//
+// Each stream writes a CHECKPOINT — absolute time, symbol name, instrument
+// scales, then one snapshot record per live exchange book — every
+// checkpoint interval, at the start of every segment and after a dropped
+// record; the last kind carries JOURNAL_FLAG_RECOVERY, as the records
+// before it no longer rebuild the live book. All delta state resets
+// there, so a reader can start at any checkpoint and skips a stream's
+// records until it has seen one.
+//
+// POSIX only; on Windows open() returns false.
+
+enum class JournalRecord : uint8_t {
+    END        = 0,   // unwritten space
+    CHECKPOINT = 1,   // stream, abs ms, name, price_scale, tick_raw, qty_scale, books following, flags
+    SPEC       = 2,   // price_scale, tick_raw, qty_scale
+    SNAPSHOT   = 3,   // update_id, flags, [checksum], bids, asks
+    DELTA      = 4,   // update_id, bids, asks
+    SEQ_DELTA  = 5,   // first, last, prev, flags, [checksum], bids, asks
+    LEVEL      = 6,   // side, price, lots — single-level ingestor update
+    CLEAR      = 7    // exchange (ALL_EXCHANGES = every book of the stream)
+};
+
+constexpr uint8_t JOURNAL_FLAG_CHECKSUM   = 1;
+constexpr uint8_t JOURNAL_FLAG_CHECKPOINT = 2;   // snapshot is part of a checkpoint
+constexpr uint8_t JOURNAL_FLAG_RECOVERY   = 4;   // checkpoint re-bases the stream after a lost record
+constexpr uint8_t ALL_EXCHANGES           = 0xFF;
+
+namespace JournalCodec {
+
+constexpr size_t MAX_VARINT = 10;
+
+inline size_t putVarint(uint8_t* p, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) { p[n++] = static_cast<uint8_t>(v) | 0x80; v >>= 7; }
+    p[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+inline uint64_t zigzag(int64_t v)    { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t  unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+// False on truncation or an over-long encoding
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (unsigned shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+inline bool getF64(const uint8_t*& p, const uint8_t* end, double& v) {
+    if (end - p < 8) return false;
+    std::memcpy(&v, p, 8);
+    p += 8;
+    return true;
+}
+
+// Growable record body
+class Buffer {
+public:
+    void clear() { n_ = 0; }
+    const uint8_t* data() const { return buf_.data(); }
+    size_t size() const { return n_; }
+
+    void u8(uint8_t v)       { reserve(1); buf_[n_++] = v; }
+    void varint(uint64_t v)  { reserve(MAX_VARINT); n_ += putVarint(buf_.data() + n_, v); }
+    void zz(int64_t v)       { varint(zigzag(v)); }
+    void f64(double v)       { reserve(8); std::memcpy(buf_.data() + n_, &v, 8); n_ += 8; }
+    void bytes(const char* s, size_t len) {
+        varint(len);
+        reserve(len);
+        std::memcpy(buf_.data() + n_, s, len);
+        n_ += len;
+    }
+
+    void reserve(size_t more) {
+        if (n_ + more > buf_.size()) buf_.resize(std::max(buf_.size() * 2, n_ + more + 256));
+    }
+
+    // Raw writes into reserved space, then advance past what was written
+    uint8_t* end()           { return buf_.data() + n_; }
+    void     advance(size_t n) { n_ += n; }
+
+private:
+    std::vector<uint8_t> buf_ = std::vector<uint8_t>(4096);
+    size_t n_ = 0;
+};
+
+inline int64_t priceOf(const Level& lv)                        { return lv.price_raw; }
+inline int64_t lotsOf(const Level& lv)                         { return lv.qty_lots; }
+inline int64_t priceOf(const std::pair<int64_t, int64_t>& lv)  { return lv.first; }
+inline int64_t lotsOf(const std::pair<int64_t, int64_t>& lv)   { return lv.second; }
+
+template<typename L>
+inline void putSide(Buffer& b, const L* lv, size_t n, int64_t& anchor) {
+    b.reserve((2 * n + 1) * MAX_VARINT);
+    uint8_t* p = b.end();
+    uint8_t* const start = p;
+    p += putVarint(p, n);
+    int64_t prev = anchor;
+    for (size_t i = 0; i < n; ++i) {
+        p += putVarint(p, zigzag(priceOf(lv[i]) - prev));
+        p += putVarint(p, static_cast<uint64_t>(lotsOf(lv[i])));
+        prev = priceOf(lv[i]);
+    }
+    b.advance(static_cast<size_t>(p - start));
+    if (n > 0) anchor = priceOf(lv[0]);
+}
+
+inline bool getSide(const uint8_t*& p, const uint8_t* end, LevelDeltas& out, int64_t& anchor) {
+    uint64_t n;
+    if (!getVarint(p, end, n) || n > static_cast<uint64_t>(end - p)) return false;
+    out.resize(static_cast<size_t>(n));
+    int64_t prev = anchor;
+    for (auto& lv : out) {
+        uint64_t d, lots;
+        if (!getVarint(p, end, d) || !getVarint(p, end, lots)) return false;
+        lv.first  = prev + unzigzag(d);
+        lv.second = static_cast<int64_t>(lots);
+        prev = lv.first;
+    }
+    if (n > 0) anchor = out[0].first;
+    return true;
+}
+
+} // namespace JournalCodec
+
+struct JournalSegmentHeader {
+    static constexpr uint32_t MAGIC   = 0x54524D4A;   // "TRMJ"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t index;
+    int64_t  created_ms;
+    uint64_t bytes;          // record bytes after the header, updated per write batch
+    uint8_t  reserved[32];
+};
+static_assert(sizeof(JournalSegmentHeader) == 64, "journal segment header is 64 bytes on disk");
+
+struct JournalOptions {
+    std::string dir;
+    size_t      segment_bytes = size_t(64) << 20;
+    size_t      ring_bytes    = size_t(16) << 20;   // rounded up to a power of two
+    int64_t     checkpoint_ms = 30'000;
+};
+
+struct JournalStats {
+    uint64_t records     = 0;
+    uint64_t bytes       = 0;   // record bytes written to segments
+    uint64_t dropped     = 0;   // records lost to a full ring or a failed segment
+    uint64_t segments    = 0;
+    uint64_t checkpoints = 0;
+    uint64_t ring_peak   = 0;   // most bytes ever queued
+    uint64_t busy_ns     = 0;   // writer time spent copying / rolling
+    uint64_t segment     = 0;   // index of the segment being written
+    int64_t  opened_ms   = 0;
+};
+
+// ── Writer ───────────────────────────────────────────────────────
+// Any number of producers (serialized by a spinlock held for one memcpy),
+// one writer thread.
+class BookJournal {
+public:
+    ~BookJournal() { close(); }
+
+    bool open(const JournalOptions& opts) {
+#ifdef _WIN32
+        (void)opts;
+        return false;
+#else
+        close();
+        if (opts.dir.empty()) return false;
+        opts_ = opts;
+        opts_.segment_bytes = std::max(opts_.segment_bytes, size_t(1) << 20);
+        if (::mkdir(opts_.dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+
+        size_t cap = size_t(1) << 16;
+        while (cap < opts_.ring_bytes) cap <<= 1;
+        ring_.reset(new uint8_t[cap]);
+        mask_ = cap - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+
+        resetStats();
+        index_ = first_index_ = lastSegmentIndex() + 1;
+        if (!startSegment()) return false;
+
+        opened_ms_ = Clock::process().nowMs();
+        running_.store(true, std::memory_order_release);
+        open_.store(true, std::memory_order_release);
+        writer_ = std::thread(&BookJournal::run, this);
+        return true;
+#endif
+    }
+
+    // Drains the ring and truncates the last segment to its records.
+    // Producers must have stopped (aggregators detached) first.
+    void close() {
+        if (!open_.exchange(false)) return;
+        running_.store(false, std::memory_order_release);
+        if (writer_.joinable()) writer_.join();
+        drain();
+        finishSegment();
+        ring_.reset();
+    }
+
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+    const JournalOptions& options() const { return opts_; }
+
+    // Bumped per segment — streams checkpoint when it changes
+    uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+    // Queue one record. False (and counted) if the ring is full.
+    bool append(JournalRecord type, const uint8_t* body, size_t n) {
+        uint8_t hdr[1 + JournalCodec::MAX_VARINT];
+        hdr[0] = static_cast<uint8_t>(type);
+        const size_t h = 1 + JournalCodec::putVarint(hdr + 1, n);
+        const uint64_t total = h + n;
+
+        while (push_lock_.test_and_set(std::memory_order_acquire)) {}
+        const uint64_t head   = head_.load(std::memory_order_relaxed);
+        const uint64_t queued = head - tail_.load(std::memory_order_acquire);
+        if (!ring_ || queued + total > mask_ + 1) {
+            push_lock_.clear(std::memory_order_release);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        copyIn(head, hdr, h);
+        copyIn(head + h, body, n);
+        head_.store(head + total, std::memory_order_release);
+        push_lock_.clear(std::memory_order_release);
+
+        if (queued + total > ring_peak_.load(std::memory_order_relaxed)) {
+            ring_peak_.store(queued + total, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    JournalStats stats() const {
+        JournalStats s;
+        s.records     = records_.load(std::memory_order_relaxed);
+        s.bytes       = bytes_.load(std::memory_order_relaxed);
+        s.dropped     = dropped_.load(std::memory_order_relaxed);
+        s.segments    = segments_.load(std::memory_order_relaxed);
+        s.checkpoints = checkpoints_.load(std::memory_order_relaxed);
+        s.ring_peak   = ring_peak_.load(std::memory_order_relaxed);
+        s.busy_ns     = busy_ns_.load(std::memory_order_relaxed);
+        s.segment     = current_index_.load(std::memory_order_relaxed);
+        s.opened_ms   = opened_ms_;
+        return s;
+    }
+
+    static std::string segmentPath(const std::string& dir, uint64_t index) {
+        char name[40];
+        std::snprintf(name, sizeof(name), "journal-%08llu.tjl", static_cast<unsigned long long>(index));
+        return dir + "/" + name;
+    }
+
+    // Segments written since open(), oldest first
+    std::vector<std::string> segmentPaths() const {
+        std::vector<std::string> out;
+        for (uint64_t i = first_index_; i <= index_ && i != 0; ++i) out.push_back(segmentPath(opts_.dir, i));
+        return out;
+    }
+
+private:
+    void run() {
+        while (running_.load(std::memory_order_acquire)) {
+            if (drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Copy whole records from the ring into the segment. Returns bytes consumed.
+    size_t drain() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) return 0;
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const uint64_t start = tail;
+        uint64_t records = 0, written = 0, checkpoints = 0;
+
+        while (tail < head) {
+            uint8_t hdr[1 + JournalCodec::MAX_VARINT];
+            const size_t peek = static_cast<size_t>(std::min<uint64_t>(sizeof(hdr), head - tail));
+            copyOut(tail, hdr, peek);
+            const uint8_t* p = hdr + 1;
+            uint64_t len = 0;
+            JournalCodec::getVarint(p, hdr + peek, len);
+            const uint64_t total = static_cast<uint64_t>(p - hdr) + len;
+
+            if (seg_ && used_ + total > opts_.segment_bytes) {
+                finishSegment();
+                ++index_;
+                startSegment();
+            }
+            if (seg_ && used_ + total <= opts_.segment_bytes) {
+                copyOut(tail, seg_ + used_, static_cast<size_t>(total));
+                used_ += total;
+                written += total;
+                ++records;
+                if (hdr[0] == static_cast<uint8_t>(JournalRecord::CHECKPOINT)) ++checkpoints;
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            tail += total;
+        }
+        tail_.store(tail, std::memory_order_release);
+        if (seg_) header()->bytes = used_ - sizeof(JournalSegmentHeader);
+
+        records_.fetch_add(records, std::memory_order_relaxed);
+        bytes_.fetch_add(written, std::memory_order_relaxed);
+        checkpoints_.fetch_add(checkpoints, std::memory_order_relaxed);
+        busy_ns_.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count()), std::memory_order_relaxed);
+        return static_cast<size_t>(tail - start);
+    }
+
+    bool startSegment() {
+#ifdef _WIN32
+        return false;
+#else
+        const std::string path = segmentPath(opts_.dir, index_);
+        int fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, static_cast<off_t>(opts_.segment_bytes)) != 0) { ::close(fd); return false; }
+
+        void* p = ::mmap(nullptr, opts_.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) { ::close(fd); return false; }
+
+        fd_   = fd;
+        seg_  = static_cast<uint8_t*>(p);
+        used_ = sizeof(JournalSegmentHeader);
+
+        auto* h = header();
+        h->magic      = JournalSegmentHeader::MAGIC;
+        h->version    = JournalSegmentHeader::VERSION;
+        h->index      = index_;
+        h->created_ms = Clock::process().nowMs();
+        h->bytes      = 0;
+
+        current_index_.store(index_, std::memory_order_relaxed);
+        segments_.fetch_add(1, std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+        return true;
+#endif
+    }
+
+    void finishSegment() {
+#ifndef _WIN32
+        if (!seg_) return;
+        header()->bytes = used_ - sizeof(JournalSegmentHeader);
+        ::munmap(seg_, opts_.segment_bytes);
+        if (::ftruncate(fd_, static_cast<off_t>(used_)) != 0) {}   // full-size file still reads correctly
+        ::close(fd_);
+#endif
+        seg_ = nullptr;
+        fd_  = -1;
+    }
+
+    // Highest journal-NNNNNNNN.tjl index already in the directory
+    uint64_t lastSegmentIndex() const {
+        uint64_t last = 0;
+#ifndef _WIN32
+        if (DIR* d = ::opendir(opts_.dir.c_str())) {
+            while (const dirent* e = ::readdir(d)) {
+                unsigned long long i = 0;
+                char ext[8] = {};
+                if (std::sscanf(e->d_name, "journal-%8llu.%3s", &i, ext) == 2 && std::strcmp(ext, "tjl") == 0) {
+                    last = std::max<uint64_t>(last, i);
+                }
+            }
+            ::closedir(d);
+        }
+#endif
+        return last;
+    }
+
+    JournalSegmentHeader* header() { return reinterpret_cast<JournalSegmentHeader*>(seg_); }
+
+    void copyIn(uint64_t pos, const uint8_t* src, size_t n) {
+        const size_t off   = static_cast<size_t>(pos & mask_);
+        const size_t first = std::min(n, mask_ + 1 - off);
+        std::memcpy(ring_.get() + off, src, first);
+        std::memcpy(ring_.get(), src + first, n - first);
+    }
+
+    void copyOut(uint64_t pos, uint8_t* dst, size_t n) const {
+        const size_t off   = static_cast<size_t>(pos & mask_);
+        const size_t first = std::min(n, mask_ + 1 - off);
+        std::memcpy(dst, ring_.get() + off, first);
+        std::memcpy(dst + first, ring_.get(), n - first);
+    }
+
+    void resetStats() {
+        records_ = bytes_ = dropped_ = segments_ = checkpoints_ = ring_peak_ = busy_ns_ = 0;
+    }
+
+    JournalOptions             opts_;
+    std::unique_ptr<uint8_t[]> ring_;
+    size_t                     mask_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{ 0 };
+    std::atomic_flag                  push_lock_ = ATOMIC_FLAG_INIT;
+    alignas(64) std::atomic<uint64_t> tail_{ 0 };
+
+    // Writer thread only
+    uint8_t* seg_  = nullptr;
+    int      fd_   = -1;
+    uint64_t used_ = 0;
+    uint64_t index_       = 0;
+    uint64_t first_index_ = 0;
+
+    std::thread       writer_;
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> open_{ false };
+    std::atomic<uint64_t> epoch_{ 0 };
+    int64_t opened_ms_ = 0;
+
+    std::atomic<uint64_t> records_{ 0 }, bytes_{ 0 }, dropped_{ 0 }, segments_{ 0 }, checkpoints_{ 0 };
+    std::atomic<uint64_t> ring_peak_{ 0 }, busy_ns_{ 0 }, current_index_{ 0 };
+};
+
+// ── Per-stream encoder ────────────────────────────────────────────
+// One per aggregator; only used under the aggregator's write lock, so
+// records of a stream reach the ring in the order they were applied.
+class JournalStream {
+public:
+    static constexpr size_t N_EX = static_cast<size_t>(ExchangeID::MAX_EXCHANGES);
+
+    void attach(BookJournal& journal, uint16_t stream, const std::string& name) {
+        journal_ = &journal;
+        stream_  = stream;
+        name_    = name;
+        force_   = true;
+    }
+
+    void detach() { journal_ = nullptr; }
+
+    bool active() const { return journal_ != nullptr; }
+
+    bool checkpointDue(int64_t now_ms) const {
+        return force_ || epoch_ != journal_->epoch() ||
+               now_ms - checkpoint_ms_ >= journal_->options().checkpoint_ms;
+    }
+
+    // Header of a checkpoint; the caller follows it with `books` snapshots
+    void checkpoint(int64_t now_ms, const InstrumentSpec& spec, size_t books) {
+        const uint8_t flags = lost_ ? JOURNAL_FLAG_RECOVERY : 0;
+        force_         = false;
+        lost_          = false;
+        epoch_         = journal_->epoch();
+        checkpoint_ms_ = now_ms;
+        last_ms_       = now_ms;
+        for (auto& a : anchors_) a[0] = a[1] = 0;
+
+        body_.clear();
+        body_.varint(stream_);
+        body_.zz(now_ms);
+        body_.bytes(name_.data(), name_.size());
+        body_.varint(static_cast<uint64_t>(spec.price_scale));
+        body_.varint(static_cast<uint64_t>(spec.tick_raw));
+        body_.varint(static_cast<uint64_t>(spec.qty_scale));
+        body_.varint(books);
+        body_.u8(flags);
+        push(JournalRecord::CHECKPOINT);
+    }
+
+    void spec(int64_t now_ms, const InstrumentSpec& spec) {
+        begin(now_ms, ALL_EXCHANGES);
+        body_.varint(static_cast<uint64_t>(spec.price_scale));
+        body_.varint(static_cast<uint64_t>(spec.tick_raw));
+        body_.varint(static_cast<uint64_t>(spec.qty_scale));
+        push(JournalRecord::SPEC);
+    }
+
+    template<typename L>
+    void snapshot(int64_t now_ms, size_t ex, uint64_t update_id,
+                  const L* bids, size_t nb, const L* asks, size_t na,
+                  std::optional<int32_t> checksum, bool from_checkpoint) {
+        begin(now_ms, ex);
+        body_.varint(update_id);
+        flagsAndChecksum(checksum, from_checkpoint ? JOURNAL_FLAG_CHECKPOINT : 0);
+        sides(ex, bids, nb, asks, na);
+        push(JournalRecord::SNAPSHOT);
+    }
+
+    void delta(int64_t now_ms, size_t ex, uint64_t update_id, const LevelDeltas& bids, const LevelDeltas& asks) {
+        begin(now_ms, ex);
+        body_.varint(update_id);
+        sides(ex, bids.data(), bids.size(), asks.data(), asks.size());
+        push(JournalRecord::DELTA);
+    }
+
+    void sequenced(int64_t now_ms, size_t ex, const DeltaSeq& seq, const LevelDeltas& bids, const LevelDeltas& asks) {
+        begin(now_ms, ex);
+        body_.varint(seq.first);
+        body_.varint(seq.last);
+        body_.varint(seq.prev);
+        flagsAndChecksum(seq.checksum, 0);
+        sides(ex, bids.data(), bids.size(), asks.data(), asks.size());
+        push(JournalRecord::SEQ_DELTA);
+    }
+
+    void level(int64_t now_ms, size_t ex, bool is_bid, int64_t price_raw, int64_t lots) {
+        begin(now_ms, ex);
+        body_.u8(is_bid ? 1 : 0);
+        int64_t& anchor = anchors_[ex][is_bid ? 0 : 1];
+        body_.zz(price_raw - anchor);
+        body_.varint(static_cast<uint64_t>(lots));
+        anchor = price_raw;
+        push(JournalRecord::LEVEL);
+    }
+
+    void clear(int64_t now_ms, size_t ex) {
+        begin(now_ms, ex);
+        push(JournalRecord::CLEAR);
+    }
+
+private:
+    void begin(int64_t now_ms, size_t ex) {
+        body_.clear();
+        body_.varint(stream_);
+        body_.zz(now_ms - last_ms_);
+        body_.u8(static_cast<uint8_t>(ex));
+        last_ms_ = now_ms;
+    }
+
+    void flagsAndChecksum(std::optional<int32_t> checksum, uint8_t flags) {
+        body_.u8(flags | (checksum ? JOURNAL_FLAG_CHECKSUM : 0));
+        if (checksum) body_.zz(*checksum);
+    }
+
+    template<typename L>
+    void sides(size_t ex, const L* bids, size_t nb, const L* asks, size_t na) {
+        JournalCodec::putSide(body_, bids, nb, anchors_[ex][0]);
+        JournalCodec::putSide(body_, asks, na, anchors_[ex][1]);
+    }
+
+    // A lost record breaks the delta chain — checkpoint again next time
+    void push(JournalRecord type) {
+        if (!journal_->append(type, body_.data(), body_.size())) force_ = lost_ = true;
+    }
+
+    BookJournal*        journal_ = nullptr;
+    uint16_t            stream_  = 0;
+    std::string         name_;
+    bool                force_   = true;
+    bool                lost_    = false;   // a record was dropped since the last checkpoint
+    uint64_t            epoch_   = 0;
+    int64_t             checkpoint_ms_ = 0;
+    int64_t             last_ms_       = 0;
+    int64_t             anchors_[N_EX][2]{};
+    JournalCodec::Buffer body_;
+};
+
+// ── Decoder ───────────────────────────────────────────────────────
+// One record at a time from a byte range (a mapped segment). Keeps the
+// per-stream delta state; records of a stream before its first
+// checkpoint come back with `synced` false and undecoded levels.
+struct JournalEvent {
+    JournalRecord  type = JournalRecord::END;
+    uint16_t       stream = 0;
+    int64_t        ts_ms  = 0;
+    uint8_t        exchange = ALL_EXCHANGES;
+    bool           synced = false;
+    uint8_t        flags  = 0;      // JOURNAL_FLAG_*; CHECKPOINT: JOURNAL_FLAG_RECOVERY
+    uint64_t       update_id = 0;
+    DeltaSeq       seq;
+    InstrumentSpec spec;
+    std::string    name;
+    uint64_t       books = 0;   // CHECKPOINT: snapshots that follow
+    bool           is_bid = false;
+    LevelDeltas    bids, asks;   // LEVEL: the one level, in bids or asks
+};
+
+class JournalDecoder {
+public:
+    // Decode the record at `p`; advances `p` past it. False at END, at the
+    // end of the range or on a malformed record.
+    bool next(const uint8_t*& p, const uint8_t* end, JournalEvent& ev) {
+        if (p >= end || *p == static_cast<uint8_t>(JournalRecord::END)) return false;
+        const uint8_t type = *p;
+        const uint8_t* q = p + 1;
+        uint64_t len;
+        if (!JournalCodec::getVarint(q, end, len) || len > static_cast<uint64_t>(end - q)) return false;
+        const uint8_t* body_end = q + len;
+        p = body_end;
+        return decode(static_cast<JournalRecord>(type), q, body_end, ev);
+    }
+
+    void reset() { streams_.clear(); }
+
+    // Only decode the levels of `stream` (-1 = all); other streams' records
+    // come back unsynced, except their checkpoint headers
+    void follow(int stream) { follow_ = stream; }
+
+private:
+    struct StreamState {
+        bool    synced  = false;
+        int64_t last_ms = 0;
+        int64_t anchors[JournalStream::N_EX][2]{};
+    };
+
+    bool decode(JournalRecord type, const uint8_t* q, const uint8_t* end, JournalEvent& ev) {
+        using namespace JournalCodec;
+        uint64_t v;
+        ev.type = type;
+        if (!getVarint(q, end, v) || v > UINT16_MAX) return false;
+        ev.stream = static_cast<uint16_t>(v);
+        if (streams_.size() <= ev.stream) streams_.resize(ev.stream + 1);
+        auto& st = streams_[ev.stream];
+
+        if (!getVarint(q, end, v)) return false;
+        if (type == JournalRecord::CHECKPOINT) {
+            st = StreamState{};
+            st.synced  = true;
+            st.last_ms = unzigzag(v);
+            ev.ts_ms   = st.last_ms;
+            ev.synced  = true;
+            ev.exchange = ALL_EXCHANGES;
+
+            uint64_t len, ps, tick, qs;
+            if (!getVarint(q, end, len) || len > static_cast<uint64_t>(end - q)) return false;
+            ev.name.assign(reinterpret_cast<const char*>(q), static_cast<size_t>(len));
+            q += len;
+            if (!getVarint(q, end, ps) || !getVarint(q, end, tick) || !getVarint(q, end, qs) ||
+                !getVarint(q, end, ev.books)) return false;
+            ev.flags = q < end ? *q++ : 0;   // absent before recovery flags were written
+            ev.spec.price_scale = static_cast<int64_t>(ps);
+            ev.spec.tick_raw    = static_cast<int64_t>(tick);
+            ev.spec.qty_scale   = static_cast<int64_t>(qs);
+            return true;
+        }
+
+        ev.synced = st.synced && (follow_ < 0 || follow_ == ev.stream);
+        if (!ev.synced) return true;   // framing is all a reader needs to skip it
+        st.last_ms += unzigzag(v);
+        ev.ts_ms = st.last_ms;
+
+        if (q >= end) return false;
+        ev.exchange = *q++;
+        if (ev.exchange != ALL_EXCHANGES && ev.exchange >= JournalStream::N_EX) return false;
+        auto* anchors = ev.exchange < JournalStream::N_EX ? st.anchors[ev.exchange] : nullptr;
+
+        auto flags = [&q, end, &ev]() {
+            if (q >= end) return false;
+            ev.flags = *q++;
+            ev.seq.checksum.reset();
+            if (ev.flags & JOURNAL_FLAG_CHECKSUM) {
+                uint64_t c;
+                if (!getVarint(q, end, c)) return false;
+                ev.seq.checksum = static_cast<int32_t>(unzigzag(c));
+            }
+            return true;
+        };
+
+        switch (type) {
+            case JournalRecord::SPEC: {
+                uint64_t ps, tick, qs;
+                if (!getVarint(q, end, ps) || !getVarint(q, end, tick) || !getVarint(q, end, qs)) return false;
+                ev.spec.price_scale = static_cast<int64_t>(ps);
+                ev.spec.tick_raw    = static_cast<int64_t>(tick);
+                ev.spec.qty_scale   = static_cast<int64_t>(qs);
+                return true;
+            }
+            case JournalRecord::SNAPSHOT:
+                return anchors && getVarint(q, end, ev.update_id) && flags() &&
+                       getSide(q, end, ev.bids, anchors[0]) && getSide(q, end, ev.asks, anchors[1]);
+
+            case JournalRecord::DELTA:
+                ev.flags = 0;
+                return anchors && getVarint(q, end, ev.update_id) &&
+                       getSide(q, end, ev.bids, anchors[0]) && getSide(q, end, ev.asks, anchors[1]);
+
+            case JournalRecord::SEQ_DELTA:
+                return anchors && getVarint(q, end, ev.seq.first) && getVarint(q, end, ev.seq.last) &&
+                       getVarint(q, end, ev.seq.prev) && flags() &&
+                       getSide(q, end, ev.bids, anchors[0]) && getSide(q, end, ev.asks, anchors[1]);
+
+            case JournalRecord::LEVEL: {
+                uint64_t d, lots;
+                if (!anchors || q >= end) return false;
+                ev.is_bid = *q++ != 0;
+                if (!getVarint(q, end, d) || !getVarint(q, end, lots)) return false;
+                int64_t& anchor = anchors[ev.is_bid ? 0 : 1];
+                anchor += unzigzag(d);
+                auto& side = ev.is_bid ? ev.bids : ev.asks;
+                (ev.is_bid ? ev.asks : ev.bids).clear();
+                side.assign(1, { anchor, static_cast<int64_t>(lots) });
+                return true;
+            }
+            case JournalRecord::CLEAR:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    std::vector<StreamState> streams_;
+    int follow_ = -1;
+};
+
+#endif // BOOK_JOURNAL_HPP
@@ -0,0 +1,2 @@
+#include "book_signals.hpp"
+// Implementation is inline in header.
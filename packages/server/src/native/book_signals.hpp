@@ -0,0 +1,256 @@
+#pragma once
+#include "orderbook.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ── Book signals ──────────────────────────────────────────────
+// Top-of-book microprice and order-book imbalance, per venue and
+// consolidated, recomputed on every book change rather than at the
+// 250ms broadcast, so short-lived imbalance shows up.
+//
+// Imbalance is (bid − ask) / (bid + ask) lots, in [−1, 1], over:
+//   - the best 1 / 5 / 10 / 25 price levels of each side, and
+//   - each DepthBands distance from the touch (the books' running band
+//     depth, so O(1)).
+// Consolidated depth is the sum over the fresh venues of each one's own
+// best N levels / own band, as DepthSummary sums bands: O(venues) from
+// per-venue sums cached when that venue changes, where merging the
+// venues' price levels on every delta cost several times the delta.
+// The consolidated touch is the best bid / ask across venues, with the
+// size of every venue quoting it. Microprice is the touch weighted by
+// the opposite size: (bid·ask_qty + ask·bid_qty) / (bid_qty + ask_qty).
+//
+// Rolling windows are time-weighted EMAs of each imbalance over 1s, 10s
+// and 60s: the signal is held until the next change, so an update decays
+// toward the previous value over the elapsed time — O(1) per update,
+// independent of the update rate. Each venue also keeps its last
+// SIGNAL_HISTORY samples, updates within the same millisecond sharing
+// one; the rings are allocated on the first sample.
+//
+// Called by CrossExchangeAggregator with its write lock held; reads take
+// the shared lock.
+
+constexpr size_t SIGNAL_VENUES = static_cast<size_t>(ExchangeID::MAX_EXCHANGES) + 1;   // + consolidated
+constexpr size_t SIGNAL_ALL    = SIGNAL_VENUES - 1;
+constexpr std::array<size_t, 4> SIGNAL_DEPTHS = { 1, 5, 10, 25 };
+constexpr size_t SIGNAL_MAX_DEPTH  = 25;
+constexpr size_t SIGNAL_IMBALANCES = SIGNAL_DEPTHS.size() + MAX_DEPTH_BANDS;   // depths, then bands
+constexpr size_t SIGNAL_WINDOWS    = 3;
+constexpr std::array<int64_t, SIGNAL_WINDOWS> SIGNAL_WINDOW_MS = { 1'000, 10'000, 60'000 };
+constexpr size_t SIGNAL_HISTORY    = 2048;
+
+// One sample as exported, SIGNAL_FIELDS doubles:
+//   [ts_ms, bid, ask, microprice, imbalance × SIGNAL_IMBALANCES]
+constexpr size_t SIGNAL_FIELDS = 4 + SIGNAL_IMBALANCES;
+
+struct BookSignal {
+    int64_t ts_ms      = 0;   // 0 = no sample yet
+    double  bid        = 0;   // touch, quote units
+    double  ask        = 0;
+    double  microprice = 0;
+    std::array<float, SIGNAL_IMBALANCES> imbalance{};
+
+    double mid() const { return (bid + ask) / 2; }
+};
+
+struct BookSignalsSnapshot {
+    int64_t    ts_ms = 0;
+    DepthBands bands;         // what the band imbalances are measured over
+    std::array<BookSignal, SIGNAL_VENUES> latest;
+    std::array<std::array<std::array<float, SIGNAL_IMBALANCES>, SIGNAL_WINDOWS>, SIGNAL_VENUES> windows;   // [venue][window]
+};
+
+class BookSignals {
+public:
+    // Venue `touched` changed: resample it and the consolidated book
+    template <size_t N>
+    void update(const std::array<ExchangeBook, N>& books, size_t touched, const DepthBands& bands,
+                int64_t price_scale, int64_t now_ms) {
+        static_assert(N + 1 == SIGNAL_VENUES, "one signal slot per exchange book");
+        BookSignal s;
+        if (touched < N) {
+            Depth& depth = slots_[touched].depth;
+            depth.valid = venueDepth(books[touched], depth);
+            if (depth.valid) {
+                venue(books[touched], depth, bands, price_scale, now_ms, s);
+                record(touched, s);
+            }
+        }
+        if (consolidated(books, bands, price_scale, now_ms, s)) record(SIGNAL_ALL, s);
+    }
+
+    // Latest samples, with the windows decayed to now_ms
+    BookSignalsSnapshot snapshot(int64_t now_ms) const {
+        BookSignalsSnapshot out;
+        out.ts_ms = now_ms;
+        for (size_t v = 0; v < SIGNAL_VENUES; ++v) {
+            const Slot& slot = slots_[v];
+            out.latest[v] = slot.last;
+            for (size_t w = 0; w < SIGNAL_WINDOWS; ++w) {
+                out.windows[v][w] = slot.ema[w];
+                if (slot.last.ts_ms == 0) continue;
+                const double k = decay(now_ms - slot.last.ts_ms, w);
+                for (size_t j = 0; j < SIGNAL_IMBALANCES; ++j) {
+                    out.windows[v][w][j] = static_cast<float>(slot.last.imbalance[j] + (slot.ema[w][j] - slot.last.imbalance[j]) * k);
+                }
+            }
+        }
+        return out;
+    }
+
+    // Samples of `venue` newer than since_ms, oldest first, SIGNAL_FIELDS
+    // doubles each. Returns the count.
+    size_t series(size_t v, int64_t since_ms, std::vector<double>& out) const {
+        out.clear();
+        if (v >= SIGNAL_VENUES || !slots_[v].ring) return 0;
+        const Slot& slot = slots_[v];
+        const size_t n = std::min<uint64_t>(slot.count, SIGNAL_HISTORY);
+        for (uint64_t i = slot.count - n; i < slot.count; ++i) {
+            const BookSignal& s = (*slot.ring)[i % SIGNAL_HISTORY];
+            if (s.ts_ms <= since_ms) continue;
+            out.insert(out.end(), { static_cast<double>(s.ts_ms), s.bid, s.ask, s.microprice });
+            out.insert(out.end(), s.imbalance.begin(), s.imbalance.end());
+        }
+        return out.size() / SIGNAL_FIELDS;
+    }
+
+    void reset() { slots_ = {}; }
+
+private:
+    // Per-venue sums behind the consolidated sample
+    struct Depth {
+        bool    valid    = false;
+        int64_t bid_px   = 0;
+        int64_t bid_lots = 0;
+        int64_t ask_px   = 0;
+        int64_t ask_lots = 0;
+        std::array<int64_t, SIGNAL_DEPTHS.size()> bid_cum{};
+        std::array<int64_t, SIGNAL_DEPTHS.size()> ask_cum{};
+    };
+
+    struct Slot {
+        Depth      depth;
+        BookSignal last;
+        std::array<std::array<float, SIGNAL_IMBALANCES>, SIGNAL_WINDOWS> ema{};
+        std::unique_ptr<std::array<BookSignal, SIGNAL_HISTORY>> ring;
+        uint64_t count = 0;   // samples ever recorded; ring index = count % SIGNAL_HISTORY
+    };
+
+    static float imbalance(int64_t bid, int64_t ask) {
+        return bid + ask > 0 ? static_cast<float>(static_cast<double>(bid - ask) / static_cast<double>(bid + ask)) : 0.0f;
+    }
+
+    // exp(−dt / window): the weight an EMA value keeps after dt ms
+    static double decay(int64_t dt_ms, size_t w) {
+        return dt_ms <= 0 ? 1.0 : std::exp(-static_cast<double>(dt_ms) / static_cast<double>(SIGNAL_WINDOW_MS[w]));
+    }
+
+    static void touch(BookSignal& s, int64_t bid_px, int64_t bid_lots, int64_t ask_px, int64_t ask_lots, int64_t price_scale) {
+        s.bid = static_cast<double>(bid_px) / price_scale;
+        s.ask = static_cast<double>(ask_px) / price_scale;
+        const double bq = static_cast<double>(bid_lots), aq = static_cast<double>(ask_lots);
+        s.microprice = bq + aq > 0 ? (s.bid * aq + s.ask * bq) / (bq + aq) : s.mid();
+    }
+
+    // A venue's touch and cumulative lots at each SIGNAL_DEPTHS
+    static bool venueDepth(const ExchangeBook& book, Depth& d) {
+        if (!book.initialized || book.bids.empty() || book.asks.empty()) return false;
+        const Level* bid = book.bids.data();
+        const Level* ask = book.asks.data();
+        d.bid_px   = bid[0].price_raw;
+        d.bid_lots = bid[0].qty_lots;
+        d.ask_px   = ask[0].price_raw;
+        d.ask_lots = ask[0].qty_lots;
+        const size_t nb = std::min(book.bids.size(), SIGNAL_MAX_DEPTH), na = std::min(book.asks.size(), SIGNAL_MAX_DEPTH);
+        int64_t bid_cum = 0, ask_cum = 0;
+        for (size_t k = 0, i = 0; k < SIGNAL_DEPTHS.size(); ++k) {
+            for (; i < SIGNAL_DEPTHS[k]; ++i) {
+                if (i < nb) bid_cum += bid[i].qty_lots;
+                if (i < na) ask_cum += ask[i].qty_lots;
+            }
+            d.bid_cum[k] = bid_cum;
+            d.ask_cum[k] = ask_cum;
+        }
+        return true;
+    }
+
+    static void venue(const ExchangeBook& book, const Depth& d, const DepthBands& bands, int64_t price_scale,
+                      int64_t now_ms, BookSignal& s) {
+        s.ts_ms = now_ms;
+        touch(s, d.bid_px, d.bid_lots, d.ask_px, d.ask_lots, price_scale);
+        for (size_t k = 0; k < SIGNAL_DEPTHS.size(); ++k) s.imbalance[k] = imbalance(d.bid_cum[k], d.ask_cum[k]);
+        const DepthStats& bs = book.bids.stats();
+        const DepthStats& as = book.asks.stats();
+        for (size_t k = 0; k < MAX_DEPTH_BANDS; ++k) {
+            s.imbalance[SIGNAL_DEPTHS.size() + k] = k < bands.count ? imbalance(bs.band_lots[k], as.band_lots[k]) : 0.0f;
+        }
+    }
+
+    template <size_t N>
+    bool consolidated(const std::array<ExchangeBook, N>& books, const DepthBands& bands, int64_t price_scale,
+                      int64_t now_ms, BookSignal& s) const {
+        Depth all;
+        std::array<int64_t, MAX_DEPTH_BANDS> bid_band{}, ask_band{};
+        bool any = false;
+        for (size_t i = 0; i < N; ++i) {
+            const Depth& d = slots_[i].depth;
+            if (!d.valid || !books[i].initialized || books[i].isStale(now_ms)) continue;
+            if (!any || d.bid_px > all.bid_px) {
+                all.bid_px   = d.bid_px;
+                all.bid_lots = 0;
+            }
+            if (!any || d.ask_px < all.ask_px) {
+                all.ask_px   = d.ask_px;
+                all.ask_lots = 0;
+            }
+            any = true;
+            if (d.bid_px == all.bid_px) all.bid_lots += d.bid_lots;
+            if (d.ask_px == all.ask_px) all.ask_lots += d.ask_lots;
+            for (size_t k = 0; k < SIGNAL_DEPTHS.size(); ++k) {
+                all.bid_cum[k] += d.bid_cum[k];
+                all.ask_cum[k] += d.ask_cum[k];
+            }
+            for (size_t k = 0; k < bands.count; ++k) {
+                bid_band[k] += books[i].bids.stats().band_lots[k];
+                ask_band[k] += books[i].asks.stats().band_lots[k];
+            }
+        }
+        if (!any) return false;
+
+        s.ts_ms = now_ms;
+        touch(s, all.bid_px, all.bid_lots, all.ask_px, all.ask_lots, price_scale);
+        for (size_t k = 0; k < SIGNAL_DEPTHS.size(); ++k) s.imbalance[k] = imbalance(all.bid_cum[k], all.ask_cum[k]);
+        for (size_t k = 0; k < MAX_DEPTH_BANDS; ++k) {
+            s.imbalance[SIGNAL_DEPTHS.size() + k] = k < bands.count ? imbalance(bid_band[k], ask_band[k]) : 0.0f;
+        }
+        return true;
+    }
+
+    void record(size_t v, const BookSignal& s) {
+        Slot& slot = slots_[v];
+        if (slot.last.ts_ms == 0) {
+            for (auto& e : slot.ema) e = s.imbalance;
+        } else {
+            // The previous value held from its sample until now
+            for (size_t w = 0; w < SIGNAL_WINDOWS; ++w) {
+                const float k = static_cast<float>(decay(s.ts_ms - slot.last.ts_ms, w));
+                for (size_t j = 0; j < SIGNAL_IMBALANCES; ++j) {
+                    slot.ema[w][j] = slot.last.imbalance[j] + (slot.ema[w][j] - slot.last.imbalance[j]) * k;
+                }
+            }
+        }
+
+        if (!slot.ring) slot.ring = std::make_unique<std::array<BookSignal, SIGNAL_HISTORY>>();
+        if (slot.count > 0 && slot.last.ts_ms == s.ts_ms) {
+            (*slot.ring)[(slot.count - 1) % SIGNAL_HISTORY] = s;   // same millisecond
+        } else {
+            (*slot.ring)[slot.count++ % SIGNAL_HISTORY] = s;
+        }
+        slot.last = s;
+    }
+
+    std::array<Slot, SIGNAL_VENUES> slots_;
+};
@@ -0,0 +1,2 @@
+#include "candle_engine.hpp"
+// Implementation is inline in header.
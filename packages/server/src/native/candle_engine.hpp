@@ -0,0 +1,314 @@
+#pragma once
+#include "types.hpp"
+#include "symbol_registry.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ── Multi-interval candle engine ──────────────────────────────
+// Cross-exchange candles for every registered symbol at 1m … 1M, built
+// from the adapters' trades. Each (symbol, interval) has one fixed slot
+// in a flat array — a trade touches the symbol's 8 contiguous slots and
+// nothing else: no keys, no maps, no allocation.
+//
+// A trade landing in a later window closes the slot's candle into a
+// ring; the broadcast timer drains closed candles and the live ones it
+// touched since the last drain in one batch. A trade older than the
+// slot's window (a venue lagging behind another) is folded into the
+// current candle rather than reopening a closed one.
+//
+// Every candle also carries a footprint: aggressive buy / sell volume
+// in FOOTPRINT_BUCKETS price rows centred on its open, in a block taken
+// from a pool and handed back once the closed candle is drained. The 1d
+// candle's footprint is the session volume profile. The point of control
+// (busiest row) is kept per trade; the 70% value area around it is
+// derived when the candle is exported.
+//
+// Single-threaded: ingest and drain both run on the JS thread.
+
+constexpr size_t CANDLE_INTERVALS = 8;
+constexpr std::array<int64_t, CANDLE_INTERVALS> CANDLE_INTERVAL_SEC = {
+    60, 300, 900, 3600, 14400, 86400, 604800, 2592000   // 1m 5m 15m 1h 4h 1d 1w 1M
+};
+
+// Footprint height as a fraction of the open price, per interval. The
+// row step is the 1/2/5 × 10^n at or above open × span / rows; trades
+// beyond the edge rows are counted in them.
+constexpr size_t FOOTPRINT_BUCKETS = 256;
+constexpr std::array<double, CANDLE_INTERVALS> FOOTPRINT_SPAN = {
+    0.01, 0.02, 0.03, 0.05, 0.10, 0.20, 0.40, 1.0
+};
+constexpr double VALUE_AREA = 0.70;
+
+// One candle as the drain hands it out: a fixed stride of doubles
+//   [symbol, interval_sec, open_time_sec, open, high, low, close,
+//    volume, quote_volume, trades, buy_volume, sell_volume, poc,
+//    value_area_low, value_area_high, footprint_price0, footprint_step,
+//    volume per ExchangeID × 7]
+constexpr size_t CANDLE_FIELDS = 17 + static_cast<size_t>(ExchangeID::MAX_EXCHANGES);
+
+// Aggressor side of a trade
+enum class TradeSide : int8_t { SELL = -1, UNKNOWN = 0, BUY = 1 };
+
+// Buy and sell of a row share a cache line
+struct FootprintRow {
+    double buy  = 0;
+    double sell = 0;
+};
+// Padded past 4KB: a symbol's 8 blocks are used at similar rows, and
+// exact 4KB strides would put those rows in the same L1 set.
+struct FootprintBlock : std::array<FootprintRow, FOOTPRINT_BUCKETS> {
+    uint8_t pad[64];
+};
+
+struct CandleAccumulator {
+    static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+    int64_t  open_time = -1;    // window start, unix seconds; -1 = no trade yet
+    double   open = 0, high = 0, low = 0, close = 0;
+    double   volume = 0;        // base
+    double   quote  = 0;        // Σ price × qty — VWAP numerator
+    double   buy_volume = 0, sell_volume = 0;
+    uint32_t trades = 0;
+    std::array<double, static_cast<size_t>(ExchangeID::MAX_EXCHANGES)> ex_volume{};
+
+    uint32_t fp        = NO_BLOCK;   // footprint block in the pool
+    double   fp_price0 = 0;          // low edge of row 0
+    double   fp_step   = 0;
+    double   fp_inv_step = 0;
+    uint32_t poc       = 0;          // row with the most volume
+    double   poc_volume = 0;
+
+    void start(int64_t window, double price, size_t k) {
+        open_time = window;
+        open = high = low = close = price;
+        volume = quote = buy_volume = sell_volume = 0;
+        trades = 0;
+        ex_volume.fill(0);
+
+        fp_step    = niceStep(price * FOOTPRINT_SPAN[k] / FOOTPRINT_BUCKETS);
+        fp_inv_step = 1 / fp_step;
+        fp_price0  = (std::floor(price / fp_step) - static_cast<double>(FOOTPRINT_BUCKETS / 2)) * fp_step;
+        poc        = FOOTPRINT_BUCKETS / 2;
+        poc_volume = 0;
+    }
+
+    size_t row(double price) const {
+        // Clamped first, so truncation is floor — no libm call on the trade path
+        const double r = std::clamp((price - fp_price0) * fp_inv_step, 0.0, static_cast<double>(FOOTPRINT_BUCKETS - 1));
+        return static_cast<size_t>(r);
+    }
+
+    static double niceStep(double raw) {
+        const double mag = std::pow(10.0, std::floor(std::log10(raw)));
+        for (double m : { 1.0, 2.0, 5.0 }) {
+            if (m * mag >= raw) return m * mag;
+        }
+        return 10 * mag;
+    }
+};
+
+struct CandleDrainStats {
+    uint32_t closed  = 0;
+    uint32_t live    = 0;
+    uint64_t dropped = 0;       // closed candles overwritten before a drain, ever
+};
+
+class CandleEngine {
+public:
+    static constexpr size_t RING_CAPACITY = 4096;   // closed candles between drains
+
+    CandleEngine()
+        : slots_(new CandleAccumulator[MAX_SYMBOLS * CANDLE_INTERVALS]),
+          ring_(new double[RING_CAPACITY * CANDLE_FIELDS]),
+          ring_fp_(new uint32_t[RING_CAPACITY]) {}
+
+    // Unknown venues (MAX_EXCHANGES) count toward the candle but not the
+    // split; trades of unknown side toward the candle but not the footprint.
+    void ingest(SymbolID sym, ExchangeID ex, double price, double qty, int64_t ts_ms, TradeSide side) {
+        if (sym >= MAX_SYMBOLS || !(price > 0) || !(qty >= 0) || !std::isfinite(price * qty)) return;
+        const int64_t ts_sec = floorDiv(ts_ms, 1000);
+        const size_t ex_i = static_cast<size_t>(ex);
+        CandleAccumulator* slot = &slots_[sym * CANDLE_INTERVALS];
+
+        for (size_t k = 0; k < CANDLE_INTERVALS; ++k, ++slot) {
+            // Divide only when the trade leaves the open window
+            if (slot->open_time < 0 || ts_sec >= slot->open_time + CANDLE_INTERVAL_SEC[k]) {
+                if (slot->open_time >= 0) push(sym, k, *slot);
+                slot->start(floorDiv(ts_sec, CANDLE_INTERVAL_SEC[k]) * CANDLE_INTERVAL_SEC[k], price, k);
+                slot->fp = acquire();
+            }
+            slot->high   = std::max(slot->high, price);
+            slot->low    = std::min(slot->low, price);
+            slot->close  = price;
+            slot->volume += qty;
+            slot->quote  += price * qty;
+            slot->trades += 1;
+            if (ex_i < slot->ex_volume.size()) slot->ex_volume[ex_i] += qty;
+            if (side == TradeSide::UNKNOWN) continue;
+
+            FootprintRow& row = pool_[slot->fp][slot->row(price)];
+            if (side == TradeSide::BUY) {
+                slot->buy_volume += qty;
+                row.buy += qty;
+            } else {
+                slot->sell_volume += qty;
+                row.sell += qty;
+            }
+            const double at_row = row.buy + row.sell;
+            if (at_row > slot->poc_volume) {
+                slot->poc = static_cast<uint32_t>(&row - pool_[slot->fp].data());
+                slot->poc_volume = at_row;
+            }
+        }
+        dirty_[sym] = true;
+        ++ingested_;
+    }
+
+    // Closed candles (oldest first) then the live candle of every slot a
+    // trade touched since the last drain, CANDLE_FIELDS doubles each. With
+    // `footprints`, also each candle's rows as FOOTPRINT_BUCKETS (buy,
+    // sell) pairs, in the same order.
+    CandleDrainStats drain(std::vector<double>& out, std::vector<float>* footprints = nullptr) {
+        CandleDrainStats st;
+        out.clear();
+        const size_t live = dirtyCount() * CANDLE_INTERVALS;
+        out.reserve((count_ + live) * CANDLE_FIELDS);
+        if (footprints) {
+            footprints->clear();
+            footprints->reserve((count_ + live) * FOOTPRINT_BUCKETS * 2);
+        }
+
+        const size_t first = (head_ + RING_CAPACITY - count_) % RING_CAPACITY;
+        for (size_t i = 0; i < count_; ++i) {
+            const size_t at = (first + i) % RING_CAPACITY;
+            const double* rec = &ring_[at * CANDLE_FIELDS];
+            out.insert(out.end(), rec, rec + CANDLE_FIELDS);
+            if (footprints) appendFootprint(*footprints, pool_[ring_fp_[at]]);
+            release(ring_fp_[at]);
+        }
+        st.closed = static_cast<uint32_t>(count_);
+        count_ = 0;
+
+        for (size_t sym = 0; sym < MAX_SYMBOLS; ++sym) {
+            if (!dirty_[sym]) continue;
+            dirty_[sym] = false;
+            for (size_t k = 0; k < CANDLE_INTERVALS; ++k) {
+                const CandleAccumulator& c = slots_[sym * CANDLE_INTERVALS + k];
+                const size_t at = out.size();
+                out.resize(at + CANDLE_FIELDS);
+                write(&out[at], static_cast<SymbolID>(sym), k, c, pool_[c.fp]);
+                if (footprints) appendFootprint(*footprints, pool_[c.fp]);
+                ++st.live;
+            }
+        }
+        st.dropped = dropped_;
+        return st;
+    }
+
+    // The open candle, or nullptr before the symbol's first trade
+    const CandleAccumulator* live(SymbolID sym, size_t k) const {
+        const CandleAccumulator* c = sym < MAX_SYMBOLS && k < CANDLE_INTERVALS ? &slots_[sym * CANDLE_INTERVALS + k] : nullptr;
+        return c && c->open_time >= 0 ? c : nullptr;
+    }
+    const FootprintBlock& footprint(const CandleAccumulator& c) const { return pool_[c.fp]; }
+    uint64_t ingested() const { return ingested_; }
+    size_t   pooledBlocks() const { return pool_.size(); }
+
+    // Rows [lo, hi] holding VALUE_AREA of the volume: grown from the POC
+    // one row at a time toward the busier neighbour.
+    static void valueArea(const CandleAccumulator& c, const FootprintBlock& fp, size_t& lo, size_t& hi) {
+        lo = hi = c.poc;
+        const double total  = c.buy_volume + c.sell_volume;
+        double       inside = c.poc_volume;
+        while (inside < total * VALUE_AREA && (lo > 0 || hi + 1 < FOOTPRINT_BUCKETS)) {
+            const double below = lo > 0 ? fp[lo - 1].buy + fp[lo - 1].sell : -1;
+            const double above = hi + 1 < FOOTPRINT_BUCKETS ? fp[hi + 1].buy + fp[hi + 1].sell : -1;
+            if (above >= below) {
+                inside += above;
+                ++hi;
+            } else {
+                inside += below;
+                --lo;
+            }
+        }
+    }
+
+private:
+    static int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+    static void write(double* rec, SymbolID sym, size_t k, const CandleAccumulator& c, const FootprintBlock& fp) {
+        size_t lo, hi;
+        valueArea(c, fp, lo, hi);
+        rec[0]  = sym;
+        rec[1]  = static_cast<double>(CANDLE_INTERVAL_SEC[k]);
+        rec[2]  = static_cast<double>(c.open_time);
+        rec[3]  = c.open;
+        rec[4]  = c.high;
+        rec[5]  = c.low;
+        rec[6]  = c.close;
+        rec[7]  = c.volume;
+        rec[8]  = c.quote;
+        rec[9]  = c.trades;
+        rec[10] = c.buy_volume;
+        rec[11] = c.sell_volume;
+        rec[12] = c.fp_price0 + (c.poc + 0.5) * c.fp_step;
+        rec[13] = c.fp_price0 + lo * c.fp_step;
+        rec[14] = c.fp_price0 + (hi + 1) * c.fp_step;
+        rec[15] = c.fp_price0;
+        rec[16] = c.fp_step;
+        std::copy(c.ex_volume.begin(), c.ex_volume.end(), rec + 17);
+    }
+
+    static void appendFootprint(std::vector<float>& out, const FootprintBlock& fp) {
+        for (const FootprintRow& row : fp) {
+            out.push_back(static_cast<float>(row.buy));
+            out.push_back(static_cast<float>(row.sell));
+        }
+    }
+
+    // Full ring: the oldest closed candle is overwritten and counted. The
+    // closed candle keeps its footprint block until drained.
+    void push(SymbolID sym, size_t k, const CandleAccumulator& c) {
+        if (count_ == RING_CAPACITY) {
+            release(ring_fp_[head_]);
+            ++dropped_;
+        } else {
+            ++count_;
+        }
+        write(&ring_[head_ * CANDLE_FIELDS], sym, k, c, pool_[c.fp]);
+        ring_fp_[head_] = c.fp;
+        head_ = (head_ + 1) % RING_CAPACITY;
+    }
+
+    // Zeroed block from the free list; the pool only grows, to the most
+    // candles ever open or undrained at once.
+    uint32_t acquire() {
+        if (free_.empty()) {
+            pool_.emplace_back();
+            free_.push_back(static_cast<uint32_t>(pool_.size() - 1));
+        }
+        const uint32_t b = free_.back();
+        free_.pop_back();
+        pool_[b].fill(FootprintRow{});
+        return b;
+    }
+
+    void release(uint32_t b) { free_.push_back(b); }
+
+    size_t dirtyCount() const { return static_cast<size_t>(std::count(dirty_.begin(), dirty_.end(), true)); }
+
+    std::unique_ptr<CandleAccumulator[]> slots_;   // [symbol × CANDLE_INTERVALS]
+    std::unique_ptr<double[]>            ring_;    // [RING_CAPACITY × CANDLE_FIELDS]
+    std::unique_ptr<uint32_t[]>          ring_fp_; // footprint block per ring entry
+    std::vector<FootprintBlock>          pool_;
+    std::vector<uint32_t>                free_;
+    size_t   head_  = 0;                            // next write
+    size_t   count_ = 0;                            // undrained closed candles
+    uint64_t dropped_  = 0;
+    uint64_t ingested_ = 0;
+    std::array<bool, MAX_SYMBOLS> dirty_{};
+};
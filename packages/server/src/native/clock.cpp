@@ -0,0 +1,2 @@
+#include "clock.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// ── Clock ─────────────────────────────────────────────────────
+// Every staleness check and output timestamp reads time through a Clock
+// instead of calling system_clock itself, so one read can serve a whole
+// call and replay can substitute event time:
+//
+//   REAL       unix ms, kept monotonic — the wall time at construction
+//              plus steady_clock elapsed since (NTP steps can't make a
+//              book look stale or fresh).
+//   COARSE     the REAL value cached by tick(), which the owner calls once
+//              per batch; nowMs() is then a single relaxed load.
+//   SIMULATED  driven by advanceTo() with event timestamps — staleness in a
+//              100× replay is judged against the recording, not the wall.
+//
+// The process clock is shared by the live aggregators and VWAF; a replay
+// owns its own SIMULATED instance and hands it to its aggregator.
+
+enum class ClockMode : uint8_t {
+    REAL      = 0,
+    COARSE    = 1,
+    SIMULATED = 2
+};
+
+class Clock {
+public:
+    Clock()
+        : origin_(std::chrono::steady_clock::now()),
+          epoch_ms_(std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count()),
+          cached_ms_(epoch_ms_) {}
+
+    explicit Clock(ClockMode mode, int64_t start_ms = 0) : Clock() { setMode(mode, start_ms); }
+
+    static Clock& process() {
+        static Clock clock;
+        return clock;
+    }
+
+    int64_t nowMs() const {
+        if (mode_.load(std::memory_order_relaxed) == ClockMode::REAL) return realMs();
+        return cached_ms_.load(std::memory_order_relaxed);
+    }
+
+    ClockMode mode() const { return mode_.load(std::memory_order_relaxed); }
+
+    // SIMULATED starts at `start_ms` (0 = now); the others resync to REAL
+    void setMode(ClockMode mode, int64_t start_ms = 0) {
+        const int64_t t = (mode == ClockMode::SIMULATED && start_ms != 0) ? start_ms : realMs();
+        cached_ms_.store(t, std::memory_order_relaxed);
+        mode_.store(mode, std::memory_order_relaxed);
+    }
+
+    // Once per batch: refresh the COARSE value. No-op in the other modes.
+    void tick() {
+        if (mode_.load(std::memory_order_relaxed) == ClockMode::COARSE) {
+            cached_ms_.store(realMs(), std::memory_order_relaxed);
+        }
+    }
+
+    // SIMULATED: move time forward to an event timestamp. Out-of-order
+    // events never move it back — use setMode() to seek.
+    void advanceTo(int64_t ts_ms) {
+        if (mode_.load(std::memory_order_relaxed) != ClockMode::SIMULATED) return;
+        int64_t cur = cached_ms_.load(std::memory_order_relaxed);
+        while (ts_ms > cur && !cached_ms_.compare_exchange_weak(cur, ts_ms, std::memory_order_relaxed)) {}
+    }
+
+private:
+    int64_t realMs() const {
+        return epoch_ms_ + std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    const std::chrono::steady_clock::time_point origin_;
+    const int64_t          epoch_ms_;
+    std::atomic<ClockMode> mode_{ ClockMode::REAL };
+    std::atomic<int64_t>   cached_ms_;
+};
@@ -0,0 +1,2 @@
+#include "depth_history.hpp"
+// Implementation is inline in header.
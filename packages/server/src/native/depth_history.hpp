@@ -0,0 +1,617 @@
+#ifndef DEPTH_HISTORY_HPP
+#define DEPTH_HISTORY_HPP
+
+#include "aggregator.hpp"
+#include "book_journal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Resting-liquidity history for heatmaps: consolidated depth sampled on a
+// fixed interval into a time × price grid, kept for weeks at a few bytes
+// per changed cell.
+//
+// A sample is one column: the consolidated size (all live venues, both
+// sides) in each `step`-wide price row — row r holds [r·step, (r+1)·step)
+// — of a window of 2 × rows_per_side rows around the mid, in units of
+// `quantum` base. Columns go to one
+// mmapped file per symbol per UTC day (depth-BTCUSDT-20260115.tdh):
+//
+//   header     4KB: magic, version, day, interval, rows, step, quantum,
+//              columns and bytes written so far.
+//   keyframes  up to MAX_KEYFRAMES (ts, offset) pairs, one a minute, so a
+//              reader starts decoding at most a minute before its window.
+//   columns    [varint length][u8 bit width | 0x40 sparse | 0x80
+//              keyframe][zigzag ms since previous column][zigzag base-row
+//              change][changed rows][zigzag deltas of the changed rows,
+//              bit-packed]. Changed rows are a bitmap, or — when fewer
+//              bytes (sparse) — a count and varint gaps between them.
+//
+// Deltas are against the same price row in the previous column (a
+// keyframe: against zero), so a quiet row costs one bitmap bit.
+//
+// Writer and reader are meant for the JS thread. POSIX only; on Windows
+// nothing is recorded and slices come back empty.
+
+struct DepthHistoryHeader {
+    static constexpr uint32_t MAGIC   = 0x54524D44;   // "TRMD"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    int64_t  day_ms;         // UTC midnight this file covers
+    int64_t  interval_ms;
+    double   step;           // row height, quote units
+    double   quantum;        // cell unit, base units
+    uint32_t rows;
+    uint32_t keyframes;
+    uint64_t columns;
+    uint64_t bytes;          // column bytes after DATA_OFFSET
+    int64_t  last_ms;
+    char     symbol[32];
+};
+
+struct DepthKeyframe {
+    int64_t  ts_ms;
+    uint64_t offset;         // from DATA_OFFSET
+};
+
+struct DepthHistoryOptions {
+    std::string dir;
+    int64_t     interval_ms   = 100;
+    double      step          = 0;       // 0 = 10 ticks of the instrument at file creation
+    size_t      rows_per_side = 200;
+    double      quantum       = 0.001;
+};
+
+struct DepthHistoryStats {
+    uint64_t columns   = 0;
+    uint64_t bytes     = 0;   // column bytes, all files this session
+    uint64_t keyframes = 0;
+    uint64_t files     = 0;
+    uint64_t encode_ns = 0;   // sampling + encoding
+};
+
+// Time bins × price rows of resting size in base units, row 0 the lowest
+// price. Each cell is the largest size seen in that row during the bin.
+struct DepthSlice {
+    int64_t  from_ms = 0;
+    int64_t  bin_ms  = 0;
+    size_t   bins    = 0;
+    size_t   rows    = 0;
+    double   price0  = 0;    // price of row 0
+    double   step    = 0;
+    uint64_t columns = 0;    // stored columns that fell in the window
+    std::vector<float> qty;  // [bin * rows + row]
+};
+
+namespace DepthHistoryCodec {
+
+constexpr size_t   HEADER_BYTES  = 4096;
+constexpr size_t   MAX_KEYFRAMES = 2048;
+constexpr size_t   DATA_OFFSET   = HEADER_BYTES + MAX_KEYFRAMES * sizeof(DepthKeyframe);
+constexpr int64_t  DAY_MS        = 86'400'000;
+constexpr int64_t  KEYFRAME_MS   = 60'000;
+constexpr uint8_t  KEY_FLAG      = 0x80;
+constexpr uint8_t  SPARSE_FLAG   = 0x40;
+constexpr uint8_t  WIDTH_MASK    = 0x3F;   // zigzag of a cell delta never needs all 64 bits
+static_assert(sizeof(DepthHistoryHeader) <= HEADER_BYTES, "depth history header fits its page");
+
+inline unsigned bitWidth(uint64_t v) {
+    unsigned n = 0;
+    while (v) { ++n; v >>= 1; }
+    return n;
+}
+
+inline size_t varintSize(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) { v >>= 7; ++n; }
+    return n;
+}
+
+// One column, delta against `prev` (rows starting at `prev_base`; a
+// keyframe ignores it)
+inline void encode(JournalCodec::Buffer& out, const std::vector<int64_t>& cur, int64_t base,
+                   const std::vector<int64_t>& prev, int64_t prev_base, int64_t dt_ms, bool key,
+                   std::vector<uint64_t>& deltas, std::vector<uint32_t>& changed) {
+    using namespace JournalCodec;
+    const size_t  rows  = cur.size();
+    const int64_t shift = base - prev_base;
+    const size_t  bitmap_bytes = (rows + 7) / 8;
+
+    deltas.clear();
+    changed.clear();
+    uint64_t widest = 0;
+    size_t gap_bytes = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        const int64_t pr = static_cast<int64_t>(r) + shift;
+        const int64_t before = (!key && pr >= 0 && pr < static_cast<int64_t>(rows)) ? prev[static_cast<size_t>(pr)] : 0;
+        if (cur[r] == before) continue;
+        gap_bytes += varintSize(changed.empty() ? r : r - changed.back() - 1);
+        changed.push_back(static_cast<uint32_t>(r));
+        const uint64_t z = zigzag(cur[r] - before);
+        widest |= z;
+        deltas.push_back(z);
+    }
+    const unsigned width = std::min<unsigned>(bitWidth(widest), WIDTH_MASK);
+    const size_t packed_bytes = (deltas.size() * width + 7) / 8;
+    const bool sparse = varintSize(changed.size()) + gap_bytes < bitmap_bytes;
+    const size_t rows_bytes = sparse ? varintSize(changed.size()) + gap_bytes : bitmap_bytes;
+    const uint64_t zdt = zigzag(dt_ms), zbase = zigzag(key ? base : shift);
+    const size_t len = 1 + varintSize(zdt) + varintSize(zbase) + rows_bytes + packed_bytes;
+
+    out.varint(len);
+    out.u8(static_cast<uint8_t>(width) | (sparse ? SPARSE_FLAG : 0) | (key ? KEY_FLAG : 0));
+    out.varint(zdt);
+    out.varint(zbase);
+    if (sparse) {
+        out.varint(changed.size());
+        for (size_t i = 0; i < changed.size(); ++i) out.varint(i == 0 ? changed[0] : changed[i] - changed[i - 1] - 1);
+    } else {
+        out.reserve(bitmap_bytes);
+        uint8_t* bm = out.end();
+        std::memset(bm, 0, bitmap_bytes);
+        for (uint32_t r : changed) bm[r >> 3] |= static_cast<uint8_t>(1u << (r & 7));
+        out.advance(bitmap_bytes);
+    }
+
+    // Little-endian bit stream, flushed a word at a time
+    out.reserve(packed_bytes + 8);
+    uint8_t* p = out.end();
+    uint64_t acc = 0;
+    unsigned filled = 0;
+    for (uint64_t z : deltas) {
+        acc |= z << filled;
+        filled += width;
+        if (filled >= 64) {
+            std::memcpy(p, &acc, 8);
+            p += 8;
+            filled -= 64;
+            acc = filled ? z >> (width - filled) : 0;
+        }
+    }
+    std::memcpy(p, &acc, 8);   // reserved above
+    out.advance(packed_bytes);
+}
+
+// Up to 8 bytes at `p`, zero-padded past `end`
+inline uint64_t load64(const uint8_t* p, const uint8_t* end) {
+    uint64_t v = 0;
+    std::memcpy(&v, p, std::min<size_t>(8, static_cast<size_t>(end - p)));
+    return v;
+}
+
+struct ColumnState {
+    std::vector<int64_t> cells;
+    int64_t base  = 0;
+    int64_t ts_ms = 0;
+};
+
+// Decode the column at `p` over `st` (the previous column); false on a
+// malformed record. `day_ms` anchors keyframe timestamps.
+inline bool decode(const uint8_t*& p, const uint8_t* end, ColumnState& st, int64_t day_ms,
+                   std::vector<int64_t>& scratch, std::vector<uint32_t>& changed) {
+    using namespace JournalCodec;
+    uint64_t len;
+    if (!getVarint(p, end, len) || len > static_cast<uint64_t>(end - p) || len == 0) return false;
+    const uint8_t* q = p;
+    const uint8_t* rec_end = p + len;
+    p = rec_end;
+
+    const uint8_t head = *q++;
+    const bool key    = head & KEY_FLAG;
+    const bool sparse = head & SPARSE_FLAG;
+    const unsigned width = head & WIDTH_MASK;
+    uint64_t dt, db;
+    if (!getVarint(q, rec_end, dt) || !getVarint(q, rec_end, db)) return false;
+
+    const size_t rows = st.cells.size();
+    changed.clear();
+    if (sparse) {
+        uint64_t n, gap, r = 0;
+        if (!getVarint(q, rec_end, n) || n > rows) return false;
+        for (uint64_t i = 0; i < n; ++i) {
+            if (!getVarint(q, rec_end, gap)) return false;
+            r += gap + (i > 0);
+            if (r >= rows) return false;
+            changed.push_back(static_cast<uint32_t>(r));
+        }
+    } else {
+        const size_t bitmap_bytes = (rows + 7) / 8;
+        if (static_cast<size_t>(rec_end - q) < bitmap_bytes) return false;
+        for (size_t byte = 0; byte < bitmap_bytes; ++byte) {
+            const uint8_t bits = q[byte];
+            for (unsigned k = 0; k < 8 && (bits >> k); ++k) {
+                if ((bits >> k) & 1) changed.push_back(static_cast<uint32_t>(byte * 8 + k));
+            }
+        }
+        q += bitmap_bytes;
+        if (!changed.empty() && changed.back() >= rows) return false;
+    }
+    if (changed.size() * width > static_cast<size_t>(rec_end - q) * 8) return false;
+
+    // Shift the previous column onto this one's rows
+    if (key) {
+        st.ts_ms = day_ms + unzigzag(dt);
+        st.base  = unzigzag(db);
+        std::fill(st.cells.begin(), st.cells.end(), 0);
+    } else {
+        st.ts_ms += unzigzag(dt);
+        const int64_t shift = unzigzag(db);
+        st.base += shift;
+        if (shift != 0) {
+            scratch.assign(rows, 0);
+            for (size_t r = 0; r < rows; ++r) {
+                const int64_t pr = static_cast<int64_t>(r) + shift;
+                if (pr >= 0 && pr < static_cast<int64_t>(rows)) scratch[r] = st.cells[static_cast<size_t>(pr)];
+            }
+            st.cells.swap(scratch);
+        }
+    }
+
+    const uint64_t mask = (uint64_t(1) << width) - 1;
+    uint64_t bitpos = 0;
+    for (uint32_t r : changed) {
+        uint64_t v = 0;
+        if (width) {
+            const uint8_t* at = q + (bitpos >> 3);
+            const unsigned off = static_cast<unsigned>(bitpos & 7);
+            v = load64(at, rec_end) >> off;
+            if (off + width > 64 && at + 8 < rec_end) v |= static_cast<uint64_t>(at[8]) << (64 - off);
+            v &= mask;
+        }
+        bitpos += width;
+        st.cells[r] += unzigzag(v);
+    }
+    return true;
+}
+
+// Civil date of a day number (days since 1970-01-01), as YYYYMMDD
+inline unsigned yyyymmdd(int64_t days) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+    const unsigned d   = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m   = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t  y   = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+    return static_cast<unsigned>(y) * 10000 + m * 100 + d;
+}
+
+inline std::string filePath(const std::string& dir, const std::string& symbol, int64_t day_ms) {
+    char name[96];
+    std::snprintf(name, sizeof(name), "/depth-%.40s-%08u.tdh", symbol.c_str(), yyyymmdd(day_ms / DAY_MS));
+    return dir + name;
+}
+
+inline int64_t dayOf(int64_t ts_ms) {
+    return (ts_ms >= 0 ? ts_ms / DAY_MS : (ts_ms - DAY_MS + 1) / DAY_MS) * DAY_MS;
+}
+
+} // namespace DepthHistoryCodec
+
+// ── Writer ───────────────────────────────────────────────────────
+class DepthHistory {
+public:
+    ~DepthHistory() { close(); }
+
+    // Start recording `symbol` into opts.dir. Files are created lazily,
+    // at the first sample with a live book. An existing file for the day
+    // is appended to with its own grid settings.
+    bool enable(const DepthHistoryOptions& opts, const std::string& symbol) {
+#ifdef _WIN32
+        (void)opts; (void)symbol;
+        return false;
+#else
+        close();
+        if (opts.dir.empty() || opts.interval_ms <= 0 || opts.rows_per_side == 0 || opts.quantum <= 0) return false;
+        ::mkdir(opts.dir.c_str(), 0755);
+        struct stat st{};
+        if (::stat(opts.dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+        opts_    = opts;
+        symbol_  = symbol;
+        enabled_ = true;
+        return true;
+#endif
+    }
+
+    bool enabled() const { return enabled_; }
+    const DepthHistoryStats& stats() const { return stats_; }
+
+    // Record a column if an interval has passed since the last one.
+    // True if one was written.
+    bool sample(const CrossExchangeAggregator& agg, int64_t now_ms) {
+        if (!enabled_ || (last_ms_ != 0 && now_ms - last_ms_ < interval_ms_)) return false;
+        const auto t0 = std::chrono::steady_clock::now();
+
+        if (!map_ || DepthHistoryCodec::dayOf(now_ms) != header()->day_ms) {
+            if (!openDay(agg, now_ms)) return false;
+        }
+        int64_t qty_scale = QTY_SCALE;
+        const int64_t base = agg.getDepthRows(header()->step, lots_, qty_scale);
+        if (base == INT64_MIN) return false;
+
+        const double lots_per_cell = static_cast<double>(qty_scale) * header()->quantum;
+        for (size_t r = 0; r < cur_.size(); ++r) {
+            cur_[r] = lots_[r] > 0 ? static_cast<int64_t>(std::llround(lots_[r] / lots_per_cell)) : 0;
+        }
+
+        // A keyframe restarts the deltas; it is indexed while the table has room
+        const auto* h = header();
+        const bool key = force_key_ || h->columns == 0 || now_ms - last_key_ms_ >= DepthHistoryCodec::KEYFRAME_MS;
+        buf_.clear();
+        DepthHistoryCodec::encode(buf_, cur_, base, prev_, prev_base_, key ? now_ms - h->day_ms : now_ms - h->last_ms,
+                                  key, deltas_, changed_);
+        if (!append(key, now_ms)) return false;
+        force_key_ = false;
+
+        prev_.swap(cur_);
+        prev_base_ = base;
+        last_ms_   = now_ms;
+        stats_.encode_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+        return true;
+    }
+
+    void close() {
+        closeDay();
+        enabled_ = false;
+        last_ms_ = 0;
+    }
+
+private:
+    DepthHistoryHeader* header() const { return reinterpret_cast<DepthHistoryHeader*>(map_); }
+    DepthKeyframe* keyframes() const { return reinterpret_cast<DepthKeyframe*>(map_ + DepthHistoryCodec::HEADER_BYTES); }
+
+    bool openDay(const CrossExchangeAggregator& agg, int64_t now_ms) {
+#ifdef _WIN32
+        (void)agg; (void)now_ms;
+        return false;
+#else
+        closeDay();
+        const int64_t day = DepthHistoryCodec::dayOf(now_ms);
+        const std::string path = DepthHistoryCodec::filePath(opts_.dir, symbol_, day);
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) return false;
+
+        struct stat st{};
+        ::fstat(fd_, &st);
+        const bool existing = static_cast<size_t>(st.st_size) >= DepthHistoryCodec::DATA_OFFSET;
+        if (!mapTo(std::max<size_t>(static_cast<size_t>(st.st_size), DepthHistoryCodec::DATA_OFFSET + INITIAL_BYTES))) {
+            closeDay();
+            return false;
+        }
+
+        auto* h = header();
+        if (existing) {
+            if (h->magic != DepthHistoryHeader::MAGIC || h->version != DepthHistoryHeader::VERSION || h->rows == 0) {
+                closeDay();
+                return false;
+            }
+        } else {
+            const InstrumentSpec spec = agg.spec();
+            std::memset(map_, 0, DepthHistoryCodec::DATA_OFFSET);
+            h->magic       = DepthHistoryHeader::MAGIC;
+            h->version     = DepthHistoryHeader::VERSION;
+            h->day_ms      = day;
+            h->interval_ms = opts_.interval_ms;
+            h->step        = opts_.step > 0 ? opts_.step : spec.toPrice(10 * spec.tick_raw);
+            h->quantum     = opts_.quantum;
+            h->rows        = static_cast<uint32_t>(2 * opts_.rows_per_side);
+            std::snprintf(h->symbol, sizeof(h->symbol), "%s", symbol_.c_str());
+            ++stats_.files;
+        }
+        interval_ms_   = h->interval_ms;
+        lots_.assign(h->rows, 0);
+        cur_.assign(h->rows, 0);
+        prev_.assign(h->rows, 0);
+        prev_base_   = 0;
+        last_key_ms_ = h->keyframes ? keyframes()[h->keyframes - 1].ts_ms : 0;
+        force_key_   = true;
+        return true;
+#endif
+    }
+
+    bool append(bool key, int64_t now_ms) {
+        const size_t need = DepthHistoryCodec::DATA_OFFSET + header()->bytes + buf_.size();
+        if (need > mapped_ && !mapTo(std::max(need, mapped_ * 2))) return false;
+
+        auto* h = header();
+        std::memcpy(map_ + DepthHistoryCodec::DATA_OFFSET + h->bytes, buf_.data(), buf_.size());
+        if (key) {
+            if (h->keyframes < DepthHistoryCodec::MAX_KEYFRAMES) keyframes()[h->keyframes++] = DepthKeyframe{ now_ms, h->bytes };
+            last_key_ms_ = now_ms;
+            ++stats_.keyframes;
+        }
+        h->bytes   += buf_.size();
+        h->columns += 1;
+        h->last_ms  = now_ms;
+        stats_.bytes   += buf_.size();
+        stats_.columns += 1;
+        return true;
+    }
+
+    bool mapTo(size_t bytes) {
+#ifdef _WIN32
+        (void)bytes;
+        return false;
+#else
+        if (map_) ::munmap(map_, mapped_);
+        map_ = nullptr;
+        mapped_ = 0;
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) return false;
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        map_ = static_cast<uint8_t*>(p);
+        mapped_ = bytes;
+        return true;
+#endif
+    }
+
+    // Trim the file to what was written
+    void closeDay() {
+#ifndef _WIN32
+        if (map_) {
+            const size_t used = DepthHistoryCodec::DATA_OFFSET + header()->bytes;
+            ::munmap(map_, mapped_);
+            if (::ftruncate(fd_, static_cast<off_t>(used)) != 0) {}
+        }
+        if (fd_ >= 0) ::close(fd_);
+#endif
+        map_ = nullptr;
+        mapped_ = 0;
+        fd_ = -1;
+    }
+
+    static constexpr size_t INITIAL_BYTES = size_t(16) << 20;
+
+    DepthHistoryOptions opts_;
+    std::string         symbol_;
+    bool                enabled_ = false;
+    DepthHistoryStats   stats_;
+
+    int      fd_     = -1;
+    uint8_t* map_    = nullptr;
+    size_t   mapped_ = 0;
+    int64_t  interval_ms_   = 100;
+    int64_t  last_ms_       = 0;
+    int64_t  last_key_ms_   = 0;
+    bool     force_key_     = false;   // no previous column in memory
+
+    std::vector<int64_t>   lots_, cur_, prev_;
+    int64_t                prev_base_ = 0;
+    std::vector<uint64_t>  deltas_;
+    std::vector<uint32_t>  changed_;
+    JournalCodec::Buffer   buf_;
+};
+
+// ── Reader ───────────────────────────────────────────────────────
+class DepthHistoryReader {
+public:
+    static constexpr size_t MAX_ROWS  = 4096;
+    static constexpr size_t MAX_CELLS = size_t(16) << 20;
+
+    // Fill `out` with [from_ms, to_ms] × [price_lo, price_hi] of `symbol`,
+    // at most `max_bins` time bins wide (0 = one per stored column). Rows
+    // follow the step of the first file in range; days recorded with
+    // another step are skipped. False if nothing in range was recorded.
+    static bool slice(const std::string& dir, const std::string& symbol, int64_t from_ms, int64_t to_ms,
+                      double price_lo, double price_hi, size_t max_bins, DepthSlice& out) {
+        out = DepthSlice{};
+        if (to_ms < from_ms || !(price_hi > price_lo)) return false;
+        using namespace DepthHistoryCodec;
+
+        int64_t row_lo = 0;
+        double quantum = 0;
+        ColumnState st;
+        std::vector<int64_t> scratch;
+        std::vector<uint32_t> changed;
+        bool any = false;
+
+        for (int64_t day = dayOf(from_ms); day <= to_ms; day += DAY_MS) {
+            MappedFile f;
+            if (!f.open(filePath(dir, symbol, day))) continue;
+            const auto* h = reinterpret_cast<const DepthHistoryHeader*>(f.base);
+            if (h->magic != DepthHistoryHeader::MAGIC || h->version != DepthHistoryHeader::VERSION ||
+                h->rows == 0 || !(h->step > 0) || h->interval_ms <= 0) continue;
+
+            if (!any) {
+                any = true;
+                out.step  = h->step;
+                quantum = h->quantum;
+                row_lo  = static_cast<int64_t>(std::floor(price_lo / h->step));
+                const int64_t row_hi = static_cast<int64_t>(std::floor(price_hi / h->step));
+                out.rows   = static_cast<size_t>(std::min<int64_t>(row_hi - row_lo + 1, MAX_ROWS));
+                out.price0 = static_cast<double>(row_lo) * h->step;
+                out.from_ms = from_ms;
+                const int64_t span = to_ms - from_ms + 1;
+                out.bin_ms = max_bins ? std::max<int64_t>(h->interval_ms, (span + static_cast<int64_t>(max_bins) - 1) / static_cast<int64_t>(max_bins))
+                                    : h->interval_ms;
+                out.bins = static_cast<size_t>((span + out.bin_ms - 1) / out.bin_ms);
+                if (out.bins * out.rows > MAX_CELLS) {
+                    out.bin_ms = (span * static_cast<int64_t>(out.rows) + static_cast<int64_t>(MAX_CELLS) - 1) / static_cast<int64_t>(MAX_CELLS);
+                    out.bins   = static_cast<size_t>((span + out.bin_ms - 1) / out.bin_ms);
+                }
+                out.qty.assign(out.bins * out.rows, 0.0f);
+            } else if (std::abs(h->step - out.step) > 1e-9 * out.step) {
+                continue;
+            }
+
+            // Latest indexed keyframe at or before the window
+            const auto* keys = reinterpret_cast<const DepthKeyframe*>(f.base + HEADER_BYTES);
+            const size_t nkeys = std::min<size_t>(h->keyframes, MAX_KEYFRAMES);
+            size_t k = 0;
+            while (k + 1 < nkeys && keys[k + 1].ts_ms <= from_ms) ++k;
+            const uint64_t bytes = std::min<uint64_t>(h->bytes, f.size - DATA_OFFSET);
+            const uint8_t* p   = f.base + DATA_OFFSET + (nkeys ? std::min<uint64_t>(keys[k].offset, bytes) : 0);
+            const uint8_t* end = f.base + DATA_OFFSET + bytes;
+
+            st.cells.assign(h->rows, 0);
+            const int64_t rows = static_cast<int64_t>(h->rows);
+            while (p < end && decode(p, end, st, h->day_ms, scratch, changed)) {
+                if (st.ts_ms > to_ms) break;
+                if (st.ts_ms < from_ms) continue;
+                ++out.columns;
+
+                float* bin = out.qty.data() + static_cast<size_t>((st.ts_ms - from_ms) / out.bin_ms) * out.rows;
+                // Output rows i map to column rows c = row_lo + i - base
+                const int64_t lo = std::max<int64_t>(0, st.base - row_lo);
+                const int64_t hi = std::min<int64_t>(static_cast<int64_t>(out.rows), st.base + rows - row_lo);
+                for (int64_t i = lo; i < hi; ++i) {
+                    const float q = static_cast<float>(st.cells[static_cast<size_t>(row_lo + i - st.base)] * quantum);
+                    if (q > bin[i]) bin[i] = q;
+                }
+            }
+        }
+        return any;
+    }
+
+private:
+    struct MappedFile {
+        const uint8_t* base = nullptr;
+        size_t         size = 0;
+
+        bool open(const std::string& path) {
+#ifdef _WIN32
+            (void)path;
+            return false;
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < DepthHistoryCodec::DATA_OFFSET) {
+                ::close(fd);
+                return false;
+            }
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            base = static_cast<const uint8_t*>(p);
+            size = static_cast<size_t>(st.st_size);
+            return true;
+#endif
+        }
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if (base) ::munmap(const_cast<uint8_t*>(base), size);
+#endif
+        }
+    };
+};
+
+#endif // DEPTH_HISTORY_HPP
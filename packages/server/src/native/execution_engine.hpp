@@ -30,13 +30,21 @@ public:
     }
 
 private:
+    static constexpr size_t MAX_BATCH = 256;   // events between mirror-throttle checks
+
     void run() {
         RingBufferEvent event;
         auto last_mirror_update = std::chrono::steady_clock::now();
         
         while (running) {
             if (ring_buffer.pop(event)) {
-                processEvent(event);
+                // Drain what's queued as one batch — a COARSE clock is read
+                // once for all of it
+                aggregator.clock().tick();
+                size_t batch = 0;
+                do {
+                    processEvent(event);
+                } while (++batch < MAX_BATCH && ring_buffer.pop(event));
                 
                 // Throttled Mirror Update (60Hz) to prevent UI/Bridge starvation
                 auto now = std::chrono::steady_clock::now();
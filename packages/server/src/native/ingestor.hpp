@@ -144,7 +144,7 @@ private:
         ev.type = EventType::MARKET_UPDATE;
         ev.payload.market.source = ex;
         ev.payload.market.price = static_cast<int64_t>(p * PRICE_SCALE);
-        ev.payload.market.quantity = q;
+        ev.payload.market.qty = q;
         ev.payload.market.is_bid = is_bid;
         ev.payload.market.is_snapshot = is_snap;
         ev.payload.market.timestamp = 0; // Will be set by engine
@@ -158,7 +158,7 @@ private:
     }
 
     void parseBinanceTrade(simdjson::dom::element& doc) {
-        // Binance Trade: {"e":"trade","E":1625... "p":"123.4", "q":"1.0", "m":true}
+        // Binance Trade: {"e":"trade","E":1625... "T":1625..., "p":"123.4", "q":"1.0", "m":true}
         double price, qty;
         std::string_view p_str, q_str;
         if (doc["p"].get(p_str) || doc["q"].get(q_str)) return;
@@ -168,6 +168,8 @@ private:
 
         bool is_sell = false;
         doc["m"].get(is_sell); // m: true means buyer is market maker -> sell
+        int64_t trade_ms = 0;
+        doc["T"].get(trade_ms);
 
         RingBufferEvent ev;
         ev.type = EventType::TRADE;
@@ -175,6 +177,8 @@ private:
         ev.payload.market.qty = qty;
         ev.payload.market.source = ExchangeID::BINANCE;
         ev.payload.market.is_bid = !is_sell; // buy if not sell
+        ev.payload.market.is_snapshot = false;
+        ev.payload.market.timestamp = trade_ms;   // 0 = stamped by engine
         
         if (!ring_buffer.push(ev)) dropped_count++;
     }
@@ -0,0 +1,2 @@
+#include "journal_replay.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,337 @@
+#ifndef JOURNAL_REPLAY_HPP
+#define JOURNAL_REPLAY_HPP
+
+#include "aggregator.hpp"
+#include "book_journal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Rebuilds past books from the book journal (book_journal.hpp).
+//
+// JournalReader maps every segment of a journal directory read-only and
+// indexes the checkpoints by symbol — only record framing and checkpoint
+// headers are read, so opening a day of journal costs a scan of its
+// length prefixes, not a decode.
+//
+// A JournalReplay session seeks to the latest checkpoint of its symbol at
+// or before the start time, loads it into a private aggregator and
+// fast-forwards to the start. From there the caller steps it forward to
+// a target time (paced replay) or by an event budget (as fast as
+// possible). The aggregator runs on its own SIMULATED clock driven by the
+// record timestamps, so staleness is judged against the recording.
+//
+// Symbol ids are per process, so a stream is followed by name: the
+// session binds to the stream of the first checkpoint carrying its symbol
+// and lets go when another name checkpoints on that id (a later run).
+// Only a (re)binding or recovery checkpoint is loaded into the books;
+// routine ones are skipped, as reloading one would drop deltas the live
+// book had buffered for a resync and the replay would no longer match
+// it. A recovery checkpoint follows a record the journal lost, so the
+// replayed book has already drifted and the checkpoint is the live one.
+//
+// POSIX only; on Windows open() returns false.
+
+struct JournalCheckpoint {
+    uint32_t segment;
+    uint64_t offset;     // of the CHECKPOINT record within the segment
+    uint16_t stream;
+    int64_t  ts_ms;
+    uint32_t symbol;     // index into JournalReader::symbols()
+};
+
+// ── Reader ────────────────────────────────────────────────────────
+class JournalReader {
+public:
+    ~JournalReader() { close(); }
+
+    bool open(const std::string& dir) {
+#ifdef _WIN32
+        (void)dir;
+        return false;
+#else
+        close();
+        std::vector<uint64_t> indices;
+        if (DIR* d = ::opendir(dir.c_str())) {
+            while (const dirent* e = ::readdir(d)) {
+                unsigned long long i = 0;
+                char ext[8] = {};
+                if (std::sscanf(e->d_name, "journal-%8llu.%3s", &i, ext) == 2 && std::strcmp(ext, "tjl") == 0) {
+                    indices.push_back(i);
+                }
+            }
+            ::closedir(d);
+        } else {
+            return false;
+        }
+        std::sort(indices.begin(), indices.end());
+
+        for (uint64_t i : indices) {
+            const std::string path = BookJournal::segmentPath(dir, i);
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) continue;
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+                ::close(fd);
+                continue;
+            }
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) continue;
+
+            const auto* h = static_cast<const JournalSegmentHeader*>(p);
+            if (h->magic != JournalSegmentHeader::MAGIC || h->version != JournalSegmentHeader::VERSION) {
+                ::munmap(p, static_cast<size_t>(st.st_size));
+                continue;
+            }
+            segments_.push_back(Segment{ static_cast<const uint8_t*>(p), static_cast<size_t>(st.st_size), i });
+        }
+        buildIndex();
+        return !segments_.empty();
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        for (const auto& s : segments_) ::munmap(const_cast<uint8_t*>(s.base), s.size);
+#endif
+        segments_.clear();
+        checkpoints_.clear();
+        symbols_.clear();
+    }
+
+    size_t segments() const { return segments_.size(); }
+    const uint8_t* recordsBegin(size_t seg) const { return segments_[seg].base + sizeof(JournalSegmentHeader); }
+    const uint8_t* recordsEnd(size_t seg)   const { return segments_[seg].base + segments_[seg].size; }
+
+    const std::vector<std::string>&       symbols()     const { return symbols_; }
+    const std::vector<JournalCheckpoint>& checkpoints() const { return checkpoints_; }
+
+    // Latest checkpoint of `symbol` at or before `ts_ms`, else its first.
+    // nullptr if the symbol never checkpointed.
+    const JournalCheckpoint* seek(const std::string& symbol, int64_t ts_ms) const {
+        const JournalCheckpoint* first = nullptr;
+        const JournalCheckpoint* best  = nullptr;
+        for (const auto& cp : checkpoints_) {
+            if (symbols_[cp.symbol] != symbol) continue;
+            if (!first) first = &cp;
+            if (cp.ts_ms <= ts_ms) best = &cp;
+        }
+        return best ? best : first;
+    }
+
+private:
+    struct Segment {
+        const uint8_t* base;
+        size_t         size;
+        uint64_t       index;
+    };
+
+    // Walk the length prefixes of every record; parse checkpoint headers
+    void buildIndex() {
+        using namespace JournalCodec;
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            const uint8_t* p   = recordsBegin(s);
+            const uint8_t* end = recordsEnd(s);
+
+            while (p < end && *p != static_cast<uint8_t>(JournalRecord::END)) {
+                const uint8_t* rec = p;
+                const uint8_t* q   = p + 1;
+                uint64_t len;
+                if (!getVarint(q, end, len) || len > static_cast<uint64_t>(end - q)) break;
+                p = q + len;
+                if (*rec != static_cast<uint8_t>(JournalRecord::CHECKPOINT)) continue;
+
+                uint64_t stream, ts, name_len;
+                if (!getVarint(q, p, stream) || !getVarint(q, p, ts) ||
+                    !getVarint(q, p, name_len) || name_len > static_cast<uint64_t>(p - q)) continue;
+                const std::string name(reinterpret_cast<const char*>(q), static_cast<size_t>(name_len));
+
+                auto it = std::find(symbols_.begin(), symbols_.end(), name);
+                if (it == symbols_.end()) it = symbols_.insert(symbols_.end(), name);
+
+                checkpoints_.push_back(JournalCheckpoint{
+                    static_cast<uint32_t>(s),
+                    static_cast<uint64_t>(rec - segments_[s].base),
+                    static_cast<uint16_t>(stream),
+                    unzigzag(ts),
+                    static_cast<uint32_t>(it - symbols_.begin()) });
+            }
+        }
+    }
+
+    std::vector<Segment>           segments_;
+    std::vector<JournalCheckpoint> checkpoints_;
+    std::vector<std::string>       symbols_;
+};
+
+// ── Replay session ────────────────────────────────────────────────
+class JournalReplay {
+public:
+    struct Stats {
+        uint64_t applied = 0;   // events of the symbol applied to the book
+        uint64_t scanned = 0;   // records read, any symbol
+        uint64_t busy_ns = 0;
+    };
+
+    explicit JournalReplay(std::shared_ptr<const JournalReader> reader)
+        : reader_(std::move(reader)), agg_(std::make_unique<CrossExchangeAggregator>()) {
+        agg_->setClock(clock_);
+    }
+
+    // Position at `from_ms`: the books after every event stamped up to
+    // it. False if the symbol isn't in the journal.
+    bool start(const std::string& symbol, int64_t from_ms, int64_t to_ms = INT64_MAX) {
+        const JournalCheckpoint* cp = reader_->seek(symbol, from_ms);
+        if (!cp) return false;
+
+        symbol_  = symbol;
+        to_ms_   = to_ms;
+        seg_     = cp->segment;
+        pos_     = reader_->recordsBegin(seg_) + (cp->offset - sizeof(JournalSegmentHeader));
+        bound_   = false;
+        seeding_ = false;
+        pending_ = false;
+        decoder_.reset();
+        decoder_.follow(-1);
+        clock_.setMode(ClockMode::SIMULATED, cp->ts_ms);
+        agg_ = std::make_unique<CrossExchangeAggregator>();   // scales only grow; start from the default
+        agg_->setClock(clock_);
+
+        advance(from_ms, SIZE_MAX);
+        stats_ = Stats{};
+        return true;
+    }
+
+    // Apply the symbol's events stamped up to `until_ms`, at most
+    // `max_events` of them; returns how many. The clock ends at until_ms
+    // (or the last event, for until_ms = INT64_MAX).
+    size_t advance(int64_t until_ms, size_t max_events) {
+        const auto t0 = std::chrono::steady_clock::now();
+        until_ms = std::min(until_ms, to_ms_);
+
+        size_t n = 0;
+        while (n < max_events && (pending_ || fetch())) {
+            if (ev_.ts_ms > until_ms) break;
+            clock_.advanceTo(ev_.ts_ms);
+            apply(ev_);
+            pending_ = false;
+            ++n;
+        }
+        if (until_ms != INT64_MAX && n < max_events) clock_.advanceTo(until_ms);
+
+        stats_.applied += n;
+        stats_.busy_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+        return n;
+    }
+
+    // No events left before the end time (or in the journal)
+    bool done() {
+        if (!pending_ && !fetch()) return true;
+        return ev_.ts_ms > to_ms_;
+    }
+
+    int64_t timeMs() const { return clock_.nowMs(); }
+    const std::string& symbol() const { return symbol_; }
+    const Stats& stats() const { return stats_; }
+    CrossExchangeAggregator& aggregator() { return *agg_; }
+
+private:
+    // Next record of our symbol into ev_; false at the end of the journal
+    bool fetch() {
+        while (seg_ < reader_->segments()) {
+            const uint8_t* end = reader_->recordsEnd(seg_);
+            while (decoder_.next(pos_, end, ev_)) {
+                ++stats_.scanned;
+                if (ev_.type == JournalRecord::CHECKPOINT) {
+                    if (ev_.name == symbol_) {
+                        if (bound_ && ev_.stream == stream_ && !(ev_.flags & JOURNAL_FLAG_RECOVERY)) continue;
+                        bound_   = true;
+                        seeding_ = true;
+                        stream_  = ev_.stream;
+                        decoder_.follow(stream_);
+                        return pending_ = true;
+                    }
+                    if (bound_ && ev_.stream == stream_) {   // id reused by another symbol
+                        bound_ = false;
+                        decoder_.follow(-1);
+                    }
+                    continue;
+                }
+                if (!bound_ || !ev_.synced || ev_.stream != stream_) continue;
+                const bool from_checkpoint = ev_.type == JournalRecord::SNAPSHOT && (ev_.flags & JOURNAL_FLAG_CHECKPOINT);
+                if (!from_checkpoint) seeding_ = false;
+                else if (!seeding_) continue;
+                return pending_ = true;
+            }
+            if (++seg_ < reader_->segments()) pos_ = reader_->recordsBegin(seg_);
+        }
+        return false;
+    }
+
+    void apply(const JournalEvent& e) {
+        const auto ex = static_cast<ExchangeID>(e.exchange);
+        switch (e.type) {
+            case JournalRecord::CHECKPOINT:
+                agg_->clearAll();
+                agg_->setSpec(e.spec);
+                break;
+            case JournalRecord::SPEC:
+                agg_->setSpec(e.spec);
+                break;
+            case JournalRecord::SNAPSHOT:
+                agg_->initSnapshot(ex, e.update_id, e.bids, e.asks, e.seq.checksum);
+                break;
+            case JournalRecord::DELTA:
+                agg_->applyDelta(ex, e.update_id, e.bids, e.asks);
+                break;
+            case JournalRecord::SEQ_DELTA:
+                agg_->applySequenced(ex, e.seq, e.bids, e.asks);
+                break;
+            case JournalRecord::LEVEL: {
+                const auto& lv = (e.is_bid ? e.bids : e.asks)[0];
+                const MarketPayload m{ ex, e.is_bid, false, lv.first, agg_->spec().toQty(lv.second), e.ts_ms };
+                agg_->processUpdate(m);
+                break;
+            }
+            case JournalRecord::CLEAR:
+                if (e.exchange == ALL_EXCHANGES) agg_->clearAll();
+                else                             agg_->clearExchange(ex);
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::shared_ptr<const JournalReader>     reader_;
+    Clock                                    clock_{ ClockMode::SIMULATED };
+    std::unique_ptr<CrossExchangeAggregator> agg_;
+    JournalDecoder decoder_;
+    JournalEvent   ev_;
+    std::string    symbol_;
+    size_t         seg_ = 0;
+    const uint8_t* pos_ = nullptr;
+    uint16_t       stream_  = 0;
+    bool           bound_   = false;
+    bool           seeding_ = false;   // loading a binding or recovery checkpoint's books
+    bool           pending_ = false;   // ev_ fetched but not yet applied
+    int64_t        to_ms_   = INT64_MAX;
+    Stats          stats_;
+};
+
+#endif // JOURNAL_REPLAY_HPP
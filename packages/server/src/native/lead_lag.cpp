@@ -0,0 +1,2 @@
+#include "lead_lag.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,196 @@
+#pragma once
+#include "orderbook.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+// ── Cross-venue lead-lag ──────────────────────────────────────
+// Which venue moves first. Each venue's mid is sampled, at receive time,
+// into LEADLAG_BIN_MS bins (the last mid seen in the bin); a bin's return
+// is the log change from the previous bin's mid, in bps. For every pair
+// (a, b) and lag k of up to ±LEADLAG_MAX_LAG bins the engine keeps
+//
+//   S_ab(k) = Σ r_a(t) · r_b(t − k)     and   V_a = Σ r_a(t)²
+//
+// over the last LEADLAG_WINDOW bins; S / √(V_a V_b) is the lagged
+// correlation. A product enters when the later of its two bins closes and
+// leaves LEADLAG_WINDOW bins later, so closing a bin only touches pairs
+// with a venue that moved in the bin being added or the one expiring —
+// a bin where nothing moved costs a few compares. The worst case (every
+// venue moving every bin) is pairs × (2·LEADLAG_MAX_LAG + 1) × 2
+// multiply-adds per bin.
+//
+// Every LEADLAG_PUBLISH_MS the sums are turned into a LeadLagMatrix: per
+// pair the correlation at each lag, the lag of the peak |correlation|,
+// and the lead-lag ratio Σρ²(a leads) / Σρ²(b leads) (Huth & Abergel).
+// Lags are the time a leads b by: positive = a moved first.
+//
+// The mid only changes when a touch moves, so the aggregator feeds this
+// from the same touch-moved signal as the BBO tracker. Books without a
+// two-sided touch hold a mid of 0: no return until they quote again.
+// State is allocated on the first mid. Write lock held by the caller.
+
+constexpr int64_t LEADLAG_BIN_MS     = 5;
+constexpr int     LEADLAG_MAX_LAG    = 40;                    // bins: ±200ms
+constexpr size_t  LEADLAG_LAGS       = 2 * LEADLAG_MAX_LAG + 1;
+constexpr int64_t LEADLAG_WINDOW     = 12'000;                // bins: 60s
+constexpr int64_t LEADLAG_PUBLISH_MS = 1'000;
+
+template <size_t N>
+struct LeadLagMatrix {
+    static constexpr size_t PAIRS = N * (N - 1) / 2;
+
+    int64_t ts_ms = 0;                        // 0 = nothing published yet
+    std::array<uint32_t, N> moves{};          // bins with a return, per venue, in the window
+    // Pair p = (a, b), a < b, in row order (0,1), (0,2) … (1,2) …;
+    // curve[p][j] = correlation with a leading b by (j − LEADLAG_MAX_LAG) bins
+    std::array<std::array<float, LEADLAG_LAGS>, PAIRS> curve{};
+    // [a][b], antisymmetric / reciprocal: ms a leads b at the peak, the
+    // peak correlation, the lead-lag ratio (> 1 = a leads)
+    std::array<std::array<double, N>, N> lead_ms{};
+    std::array<std::array<double, N>, N> peak{};
+    std::array<std::array<double, N>, N> ratio{};
+};
+
+template <size_t N>
+class LeadLagEngine {
+public:
+    static constexpr size_t PAIRS = LeadLagMatrix<N>::PAIRS;
+
+    // Venue v's book changed its touch at now_ms
+    void onTouch(size_t v, const ExchangeBook& book, const InstrumentSpec& spec, int64_t now_ms) {
+        if (v >= N) return;
+        const bool quoted = book.initialized && !book.bids.empty() && !book.asks.empty();
+        if (!state_) {
+            if (!quoted) return;
+            state_ = std::make_unique<State>();
+            state_->bin = floorDiv(now_ms, LEADLAG_BIN_MS);
+            state_->published_ms = now_ms;
+        }
+        advance(now_ms);
+        state_->mid[v] = quoted ? spec.toPrice(book.bids.bestPrice() + book.asks.bestPrice()) / 2 : 0;
+    }
+
+    const LeadLagMatrix<N>& matrix() const { return published_; }
+
+    void reset() {
+        state_.reset();
+        published_ = LeadLagMatrix<N>{};
+    }
+
+private:
+    static constexpr int64_t RING = 16384;   // ≥ LEADLAG_WINDOW + LEADLAG_MAX_LAG + 1, power of two
+    static_assert(RING > LEADLAG_WINDOW + LEADLAG_MAX_LAG, "ring must cover window + lags");
+
+    struct State {
+        int64_t bin = 0;                         // open bin
+        int64_t published_ms = 0;
+        std::array<double, N> mid{};             // last mid seen, 0 = not quoted
+        std::array<double, N> closed_mid{};      // mid at the last closed bin
+        std::array<std::array<float, RING>, N> ret{};   // bps, by bin & (RING − 1)
+        std::array<std::array<double, LEADLAG_LAGS>, PAIRS> sum{};   // S_ab(k) at [k + MAX_LAG]
+        std::array<double, N>   var{};
+        std::array<int64_t, N>  moves{};
+    };
+
+    std::unique_ptr<State> state_;
+    LeadLagMatrix<N> published_;
+
+    static int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+    float ret(size_t v, int64_t bin) const { return state_->ret[v][static_cast<size_t>(bin & (RING - 1))]; }
+
+    // Close every bin that ended before now_ms
+    void advance(int64_t now_ms) {
+        State& s = *state_;
+        const int64_t bin = floorDiv(now_ms, LEADLAG_BIN_MS);
+        if (bin - s.bin > LEADLAG_WINDOW + LEADLAG_MAX_LAG) {
+            // Quiet for longer than the window: every product has expired
+            // and the bins in between carry no returns. Returns restart
+            // from the next mids rather than spanning the gap.
+            for (auto& r : s.ret) r.fill(0);
+            for (auto& p : s.sum) p.fill(0);
+            s.var.fill(0);
+            s.moves.fill(0);
+            s.closed_mid.fill(0);
+            s.bin = bin;
+            publish(bin * LEADLAG_BIN_MS);
+        }
+        while (s.bin < bin) {
+            closeBin();
+            ++s.bin;
+            if ((s.bin * LEADLAG_BIN_MS) - s.published_ms >= LEADLAG_PUBLISH_MS) publish(s.bin * LEADLAG_BIN_MS);
+        }
+    }
+
+    void closeBin() {
+        State& s = *state_;
+        const int64_t t = s.bin, gone = t - LEADLAG_WINDOW;
+        for (size_t v = 0; v < N; ++v) {
+            const double m = s.mid[v], prev = s.closed_mid[v];
+            const float r = m > 0 && prev > 0 && m != prev ? static_cast<float>(std::log(m / prev) * 1e4) : 0.f;
+            s.closed_mid[v] = m;
+            const float old = ret(v, gone);
+            s.ret[v][static_cast<size_t>(t & (RING - 1))] = r;
+            s.var[v]   += static_cast<double>(r) * r - static_cast<double>(old) * old;
+            s.moves[v] += (r != 0) - (old != 0);
+        }
+        size_t p = 0;
+        for (size_t a = 0; a < N; ++a) {
+            for (size_t b = a + 1; b < N; ++b, ++p) {
+                accumulate(s.sum[p], a, b, t, 1);
+                accumulate(s.sum[p], a, b, gone, -1);
+            }
+        }
+    }
+
+    // Products whose later bin is `t`: r_a(t)·r_b(t − k) for k ≥ 0 and
+    // r_a(t − |k|)·r_b(t) for k < 0
+    void accumulate(std::array<double, LEADLAG_LAGS>& sum, size_t a, size_t b, int64_t t, double sign) const {
+        const double ra = ret(a, t), rb = ret(b, t);
+        if (ra != 0) {
+            for (int k = 0; k <= LEADLAG_MAX_LAG; ++k) sum[k + LEADLAG_MAX_LAG] += sign * ra * ret(b, t - k);
+        }
+        if (rb != 0) {
+            for (int k = 1; k <= LEADLAG_MAX_LAG; ++k) sum[LEADLAG_MAX_LAG - k] += sign * rb * ret(a, t - k);
+        }
+    }
+
+    void publish(int64_t ts_ms) {
+        State& s = *state_;
+        s.published_ms = ts_ms;
+        LeadLagMatrix<N>& m = published_;
+        m.ts_ms = ts_ms;
+        for (size_t v = 0; v < N; ++v) m.moves[v] = static_cast<uint32_t>(std::max<int64_t>(0, s.moves[v]));
+
+        size_t p = 0;
+        for (size_t a = 0; a < N; ++a) {
+            m.lead_ms[a][a] = 0;
+            m.peak[a][a]    = 1;
+            m.ratio[a][a]   = 1;
+            for (size_t b = a + 1; b < N; ++b, ++p) {
+                const double norm = s.var[a] > 0 && s.var[b] > 0 ? std::sqrt(s.var[a] * s.var[b]) : 0;
+                double best = 0, a_leads = 0, b_leads = 0;
+                int best_lead = 0;
+                for (int j = 0; j < static_cast<int>(LEADLAG_LAGS); ++j) {
+                    // sum index k + MAX_LAG with k = −lead: r_a(t)·r_b(t + lead)
+                    const int lead = j - LEADLAG_MAX_LAG;
+                    const double rho = norm > 0 ? s.sum[p][LEADLAG_MAX_LAG - lead] / norm : 0;
+                    m.curve[p][j] = static_cast<float>(rho);
+                    if (std::abs(rho) > std::abs(best)) {
+                        best = rho;
+                        best_lead = lead;
+                    }
+                    if (lead > 0) a_leads += rho * rho;
+                    if (lead < 0) b_leads += rho * rho;
+                }
+                const double lead_ms = static_cast<double>(best_lead * LEADLAG_BIN_MS);
+                const double ratio = a_leads > 0 && b_leads > 0 ? a_leads / b_leads : 1;
+                m.lead_ms[a][b] = lead_ms;   m.lead_ms[b][a] = -lead_ms;
+                m.peak[a][b]    = best;      m.peak[b][a]    = best;
+                m.ratio[a][b]   = ratio;     m.ratio[b][a]   = 1 / ratio;
+            }
+        }
+    }
+};
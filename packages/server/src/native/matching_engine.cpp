@@ -0,0 +1,2 @@
+#include "matching_engine.hpp"
+// Implementation is inline in header.
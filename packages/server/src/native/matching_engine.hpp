@@ -0,0 +1,355 @@
+#ifndef MATCHING_ENGINE_HPP
+#define MATCHING_ENGINE_HPP
+
+#include "types.hpp"
+#include "ring_buffer.hpp"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// ── Internal CLOB for user orders ─────────────────────────────────
+// Price-time priority. Every allocation happens in the constructor:
+//   - orders live in a fixed slab, linked into per-level FIFO queues
+//     through intrusive prev/next indices (no node allocation)
+//   - price levels come from a second slab; each side keeps a sorted
+//     array of level indices ordered worst → best, so the best level is
+//     back() and inserts near the touch shift almost nothing
+//   - order_id → slab slot via an open-addressing table, so cancel is
+//     a hash probe plus an O(1) unlink
+// Fills are pushed to an SPSC ring owned by the caller.
+
+struct Fill {
+    uint64_t taker_order_id;
+    uint64_t maker_order_id;
+    uint64_t taker_account_id;
+    uint64_t maker_account_id;
+    int64_t  price;       // integer-scaled, maker's price
+    int64_t  quantity;
+    bool     taker_is_buy;
+};
+
+using FillRing = RingBuffer<Fill, 65536>;
+
+enum class OrderStatus : uint8_t {
+    RESTING,          // nothing matched, full qty on book
+    PARTIAL,          // some matched, remainder on book
+    FILLED,           // fully matched
+    CANCELLED,        // market/liquidation remainder dropped (no liquidity)
+    REJECTED          // bad params, duplicate id or pool exhausted
+};
+
+class MatchingEngine {
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    explicit MatchingEngine(FillRing& fills, uint32_t max_orders = 65536, uint32_t max_levels = 4096)
+        : fills_(fills)
+    {
+        orders_.resize(max_orders);
+        levels_.resize(max_levels);
+        bid_levels_.reserve(max_levels);
+        ask_levels_.reserve(max_levels);
+
+        // Free lists thread through the `next` index of unused slots
+        for (uint32_t i = 0; i < max_orders; ++i) orders_[i].next = i + 1 < max_orders ? i + 1 : NIL;
+        for (uint32_t i = 0; i < max_levels; ++i) levels_[i].next_free = i + 1 < max_levels ? i + 1 : NIL;
+        free_order_ = max_orders > 0 ? 0 : NIL;
+        free_level_ = max_levels > 0 ? 0 : NIL;
+
+        // Index sized to 2x capacity (power of two) keeps probe chains short
+        size_t cap = 1;
+        while (cap < static_cast<size_t>(max_orders) * 2) cap <<= 1;
+        index_.assign(cap, IndexSlot{0, NIL});
+        index_mask_ = cap - 1;
+    }
+
+    // Submit a new order. price == 0 (or is_liquidation) → market order,
+    // which never rests. Matching fills are pushed to the fill ring.
+    OrderStatus submit(const OrderPayload& o) {
+        if (o.quantity <= 0 || o.order_id == 0 || o.price < 0) return OrderStatus::REJECTED;
+        if (indexFind(o.order_id) != NIL) return OrderStatus::REJECTED;
+
+        const bool is_market = o.price == 0 || o.is_liquidation;
+        int64_t remaining = o.is_buy
+            ? matchAgainst(ask_levels_, o, is_market, [](int64_t lvl, int64_t lim) { return lvl <= lim; })
+            : matchAgainst(bid_levels_, o, is_market, [](int64_t lvl, int64_t lim) { return lvl >= lim; });
+
+        if (remaining == 0) return OrderStatus::FILLED;
+        if (is_market) return OrderStatus::CANCELLED;
+
+        if (!rest(o, remaining)) return remaining == o.quantity ? OrderStatus::REJECTED : OrderStatus::CANCELLED;
+        return remaining == o.quantity ? OrderStatus::RESTING : OrderStatus::PARTIAL;
+    }
+
+    // Cancel a resting order by id. Returns false if unknown / already done.
+    bool cancel(uint64_t order_id) {
+        uint32_t slot = indexFind(order_id);
+        if (slot == NIL) return false;
+
+        const uint32_t li  = orders_[slot].level;
+        const bool is_bid  = orders_[slot].is_buy;
+        PriceLevel& lvl = levels_[li];
+        lvl.total_qty -= orders_[slot].remaining;
+        unlink(slot);
+        indexErase(order_id);
+        freeOrder(slot);
+
+        // Empty levels are reclaimed lazily — at the touch by matching,
+        // elsewhere by compact() when the level slab runs dry.
+        if (lvl.head == NIL) {
+            auto& side = is_bid ? bid_levels_ : ask_levels_;
+            if (!side.empty() && side.back() == li) {
+                side.pop_back();
+                freeLevel(li);
+            }
+        }
+        ++cancels_;
+        return true;
+    }
+
+    int64_t bestBid() const { return bestOf(bid_levels_); }
+    int64_t bestAsk() const { return bestOf(ask_levels_); }
+
+    // Aggregate resting qty at a price (0 if no such level)
+    int64_t depthAt(bool is_bid, int64_t price) const {
+        const auto& side = is_bid ? bid_levels_ : ask_levels_;
+        size_t pos = lowerBound(side, price, is_bid);
+        if (pos < side.size() && levels_[side[pos]].price == price) return levels_[side[pos]].total_qty;
+        return 0;
+    }
+
+    size_t   restingOrders() const { return resting_; }
+    uint64_t matchCount()    const { return matches_; }
+    uint64_t cancelCount()   const { return cancels_; }
+    uint64_t droppedFills()  const { return dropped_fills_; }
+
+private:
+    struct Order {
+        uint64_t order_id   = 0;
+        uint64_t account_id = 0;
+        int64_t  remaining  = 0;
+        uint32_t prev       = NIL;
+        uint32_t next       = NIL;   // doubles as free-list link
+        uint32_t level      = NIL;
+        bool     is_buy     = false;
+    };
+
+    struct PriceLevel {
+        int64_t  price     = 0;
+        int64_t  total_qty = 0;
+        uint32_t head      = NIL;
+        uint32_t tail      = NIL;
+        uint32_t next_free = NIL;
+    };
+
+    struct IndexSlot {
+        uint64_t key;     // 0 = empty
+        uint32_t slot;
+    };
+
+    // ── Matching ─────────────────────────────────────────────────
+    template<typename Crosses>
+    int64_t matchAgainst(std::vector<uint32_t>& side, const OrderPayload& taker, bool is_market, Crosses crosses) {
+        int64_t remaining = taker.quantity;
+
+        while (remaining > 0 && !side.empty()) {
+            uint32_t li = side.back();
+            PriceLevel& lvl = levels_[li];
+
+            if (lvl.head == NIL) {          // lazily-emptied level at the touch
+                side.pop_back();
+                freeLevel(li);
+                continue;
+            }
+            if (!is_market && !crosses(lvl.price, taker.price)) break;
+
+            while (remaining > 0 && lvl.head != NIL) {
+                uint32_t mi = lvl.head;
+                Order& maker = orders_[mi];
+                int64_t qty = std::min(remaining, maker.remaining);
+
+                emitFill(Fill{
+                    taker.order_id, maker.order_id,
+                    taker.account_id, maker.account_id,
+                    lvl.price, qty, taker.is_buy
+                });
+
+                remaining       -= qty;
+                maker.remaining -= qty;
+                lvl.total_qty   -= qty;
+
+                if (maker.remaining == 0) {
+                    unlink(mi);
+                    indexErase(maker.order_id);
+                    freeOrder(mi);
+                }
+            }
+
+            if (lvl.head == NIL) {
+                side.pop_back();
+                freeLevel(li);
+            }
+        }
+        return remaining;
+    }
+
+    void emitFill(const Fill& f) {
+        ++matches_;
+        if (!fills_.push(f)) ++dropped_fills_;
+    }
+
+    // ── Resting ──────────────────────────────────────────────────
+    bool rest(const OrderPayload& o, int64_t remaining) {
+        if (free_order_ == NIL) return false;
+
+        uint32_t li = findOrCreateLevel(o.is_buy, o.price);
+        if (li == NIL) return false;
+
+        uint32_t oi = free_order_;
+        free_order_ = orders_[oi].next;
+
+        Order& ord = orders_[oi];
+        ord.order_id   = o.order_id;
+        ord.account_id = o.account_id;
+        ord.remaining  = remaining;
+        ord.is_buy     = o.is_buy;
+        ord.level      = li;
+        ord.next       = NIL;
+
+        PriceLevel& lvl = levels_[li];
+        ord.prev = lvl.tail;
+        if (lvl.tail != NIL) orders_[lvl.tail].next = oi;
+        else                 lvl.head = oi;
+        lvl.tail = oi;
+        lvl.total_qty += remaining;
+
+        indexInsert(o.order_id, oi);
+        ++resting_;
+        return true;
+    }
+
+    uint32_t findOrCreateLevel(bool is_bid, int64_t price) {
+        auto& side = is_bid ? bid_levels_ : ask_levels_;
+        size_t pos = lowerBound(side, price, is_bid);
+        if (pos < side.size() && levels_[side[pos]].price == price) return side[pos];
+
+        if (free_level_ == NIL) {
+            compact();
+            if (free_level_ == NIL) return NIL;
+            pos = lowerBound(side, price, is_bid);
+        }
+
+        uint32_t li = free_level_;
+        free_level_ = levels_[li].next_free;
+        levels_[li] = PriceLevel{price, 0, NIL, NIL, NIL};
+        side.insert(side.begin() + pos, li);
+        return li;
+    }
+
+    // Sides are sorted worst → best: bids ascending, asks descending.
+    size_t lowerBound(const std::vector<uint32_t>& side, int64_t price, bool is_bid) const {
+        auto it = std::lower_bound(side.begin(), side.end(), price,
+            [this, is_bid](uint32_t li, int64_t p) {
+                return is_bid ? levels_[li].price < p : levels_[li].price > p;
+            });
+        return static_cast<size_t>(it - side.begin());
+    }
+
+    int64_t bestOf(const std::vector<uint32_t>& side) const {
+        for (auto it = side.rbegin(); it != side.rend(); ++it) {
+            if (levels_[*it].head != NIL) return levels_[*it].price;
+        }
+        return 0;
+    }
+
+    // Reclaim lazily-emptied levels left behind by deep cancels
+    void compact() {
+        for (auto* side : { &bid_levels_, &ask_levels_ }) {
+            auto keep = std::remove_if(side->begin(), side->end(), [this](uint32_t li) {
+                if (levels_[li].head != NIL) return false;
+                freeLevel(li);
+                return true;
+            });
+            side->erase(keep, side->end());
+        }
+    }
+
+    void unlink(uint32_t oi) {
+        Order& ord = orders_[oi];
+        PriceLevel& lvl = levels_[ord.level];
+        if (ord.prev != NIL) orders_[ord.prev].next = ord.next;
+        else                 lvl.head = ord.next;
+        if (ord.next != NIL) orders_[ord.next].prev = ord.prev;
+        else                 lvl.tail = ord.prev;
+    }
+
+    void freeOrder(uint32_t oi) {
+        orders_[oi].order_id = 0;
+        orders_[oi].next = free_order_;
+        free_order_ = oi;
+        --resting_;
+    }
+
+    void freeLevel(uint32_t li) {
+        levels_[li].next_free = free_level_;
+        free_level_ = li;
+    }
+
+    // ── order_id → slot (linear probing, backward-shift delete) ──
+    static size_t hashId(uint64_t k) {
+        k ^= k >> 33; k *= 0xff51afd7ed558ccdULL; k ^= k >> 33;
+        return static_cast<size_t>(k);
+    }
+
+    uint32_t indexFind(uint64_t id) const {
+        for (size_t i = hashId(id) & index_mask_;; i = (i + 1) & index_mask_) {
+            if (index_[i].key == id) return index_[i].slot;
+            if (index_[i].key == 0)  return NIL;
+        }
+    }
+
+    void indexInsert(uint64_t id, uint32_t slot) {
+        size_t i = hashId(id) & index_mask_;
+        while (index_[i].key != 0) i = (i + 1) & index_mask_;
+        index_[i] = IndexSlot{id, slot};
+    }
+
+    void indexErase(uint64_t id) {
+        size_t i = hashId(id) & index_mask_;
+        while (index_[i].key != id) {
+            if (index_[i].key == 0) return;
+            i = (i + 1) & index_mask_;
+        }
+        // Shift later entries of the cluster back so probes never see a hole
+        size_t j = i;
+        for (;;) {
+            j = (j + 1) & index_mask_;
+            if (index_[j].key == 0) break;
+            size_t home = hashId(index_[j].key) & index_mask_;
+            bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                index_[i] = index_[j];
+                i = j;
+            }
+        }
+        index_[i] = IndexSlot{0, NIL};
+    }
+
+    FillRing& fills_;
+
+    std::vector<Order>      orders_;
+    std::vector<PriceLevel> levels_;
+    std::vector<uint32_t>   bid_levels_;
+    std::vector<uint32_t>   ask_levels_;
+    std::vector<IndexSlot>  index_;
+    size_t   index_mask_  = 0;
+    uint32_t free_order_  = NIL;
+    uint32_t free_level_  = NIL;
+
+    size_t   resting_       = 0;
+    uint64_t matches_       = 0;
+    uint64_t cancels_       = 0;
+    uint64_t dropped_fills_ = 0;
+};
+
+#endif // MATCHING_ENGINE_HPP
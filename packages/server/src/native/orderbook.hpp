@@ -1,39 +1,60 @@
 #pragma once
 #include "types.hpp"
+#include "simd_depth.hpp"
 #include <algorithm>
 #include <mutex>
 #include <vector>
-#include <chrono>
 #include <array>
 
+constexpr size_t MAX_DEPTH_BANDS = 8;
+
+// Distances from the touch, in basis points, that running depth is kept
+// for (10bps = within 0.1% of the best price). Any order; up to 8.
+struct DepthBands {
+    size_t  count = 4;
+    int32_t bps[MAX_DEPTH_BANDS] = { 10, 50, 100, 200 };
+};
+
+// Running aggregates of one side. total/band sizes are exact lots;
+// notional is Σ price_raw × qty_lots (divide by price_scale × qty_scale
+// for quote units) and is re-summed from scratch on every snapshot.
+struct DepthStats {
+    int64_t total_lots   = 0;
+    double  notional_raw = 0;
+    int64_t band_lots[MAX_DEPTH_BANDS]{};   // parallel to DepthBands::bps
+};
+
 // ── OrderbookSide ─────────────────────────────────────────────
 // One side (bid or ask) of a single exchange's orderbook.
-// Backed by std::map<int64_t, double> for automatic sorted order.
-// Bids: map ordered high→low (use std::greater as comparator)
-// Asks: map ordered low→high (default)
+// Quantities are integer lots (see InstrumentSpec::qty_scale).
+// Backed by a sorted fixed array, best price first.
+// Bids: ordered high→low (use std::greater as comparator)
+// Asks: ordered low→high (default)
+//
+// DepthStats are maintained on every upsert/remove: O(1) for totals
+// and for band sizes unless the touch moves, in which case the bands
+// are re-summed over just the levels inside the widest one.
 
 template<typename Comparator>
 class OrderbookSide {
 public:
     OrderbookSide() {
-        levels_.fill(Level{0, 0.0});
+        levels_.fill(Level{0, 0});
     }
 
     // Apply a single delta. qty=0 → remove the level.
     // Returns true if the best price changed (triggers BBO update).
-    bool applyDelta(int64_t price_raw, double qty) {
-        if (qty == 0.0 || qty < 1e-12) {
-            return removeLevel(price_raw);
-        } else {
-            return upsertLevel(price_raw, qty);
-        }
+    bool applyDelta(int64_t price_raw, int64_t qty_lots) {
+        bool changed = qty_lots <= 0 ? removeLevel(price_raw) : upsertLevel(price_raw, qty_lots);
+        if (changed) rebuildBands();
+        return changed;
     }
 
     // Replace entire side from snapshot (REST seed).
-    void applySnapshot(const std::vector<std::pair<int64_t, double>>& data) {
+    void applySnapshot(const std::vector<std::pair<int64_t, int64_t>>& data) {
         count_ = 0;
         for (const auto& pair : data) {
-            if (pair.second > 1e-12 && count_ < MAX_LEVELS) {
+            if (pair.second > 0 && count_ < MAX_LEVELS) {
                 levels_[count_++] = Level{pair.first, pair.second};
             }
         }
@@ -42,6 +63,7 @@ public:
                  [](const Level& a, const Level& b) { return Comparator()(a.price_raw, b.price_raw); });
         
         last_best_ = count_ > 0 ? levels_[0].price_raw : 0;
+        rebuildStats();
     }
 
     // Copy top N levels into output array. Returns count written.
@@ -51,10 +73,13 @@ public:
         return to_copy;
     }
 
-    double totalQty() const {
-        double sum = 0;
-        for (size_t i = 0; i < count_; ++i) sum += levels_[i].qty;
-        return sum;
+    int64_t totalQty() const { return stats_.total_lots; }
+    const DepthStats& stats() const { return stats_; }
+
+    void setBands(const DepthBands& bands) {
+        bands_ = bands;
+        bands_.count = std::min(bands_.count, MAX_DEPTH_BANDS);
+        rebuildBands();
     }
 
     int64_t bestPrice() const {
@@ -64,15 +89,77 @@ public:
     bool empty() const { return count_ == 0; }
     size_t size() const { return count_; }
 
+    // Read-only view of all levels in book order (best first) — no copy
+    const Level* data() const { return levels_.data(); }
+
+    // Re-key every level for finer scales (factors = new/old scale)
+    void rescale(int64_t price_factor, int64_t qty_factor) {
+        for (size_t i = 0; i < count_; ++i) {
+            levels_[i].price_raw *= price_factor;
+            levels_[i].qty_lots  *= qty_factor;
+        }
+        last_best_ *= price_factor;
+        rebuildStats();
+    }
+
 private:
     static constexpr size_t MAX_LEVELS = 500;
+    static constexpr bool   IS_BID = Comparator()(1, 0);
     std::array<Level, MAX_LEVELS> levels_;
     size_t count_ = 0;
     int64_t last_best_ = 0;
 
+    DepthBands bands_;
+    int64_t    band_edge_[MAX_DEPTH_BANDS]{};   // worst price inside each band
+    size_t     widest_band_ = 0;
+    DepthStats stats_;
+
+    bool inBand(int64_t price, size_t k) const { return !Comparator()(band_edge_[k], price); }
+
+    // Size change at one price. Band sizes are left to rebuildBands() when
+    // the touch moved, since every edge moves with it.
+    void account(int64_t price, int64_t d_lots) {
+        stats_.total_lots   += d_lots;
+        stats_.notional_raw += static_cast<double>(price) * static_cast<double>(d_lots);
+        if (count_ == 0) return;
+        for (size_t k = 0; k < bands_.count; ++k) {
+            if (inBand(price, k)) stats_.band_lots[k] += d_lots;
+        }
+    }
+
+    void rebuildBands() {
+        std::fill(std::begin(stats_.band_lots), std::end(stats_.band_lots), 0);
+        if (count_ == 0) return;
+
+        const int64_t best = levels_[0].price_raw;
+        widest_band_ = 0;
+        for (size_t k = 0; k < bands_.count; ++k) {
+            // best × bps / 1e4 without overflowing at fine scales
+            const int64_t off = (best / 10000) * bands_.bps[k] + (best % 10000) * bands_.bps[k] / 10000;
+            band_edge_[k] = IS_BID ? best - off : best + off;
+            if (bands_.bps[k] > bands_.bps[widest_band_]) widest_band_ = k;
+        }
+        for (size_t i = 0; i < count_ && bands_.count > 0 && inBand(levels_[i].price_raw, widest_band_); ++i) {
+            for (size_t k = 0; k < bands_.count; ++k) {
+                if (inBand(levels_[i].price_raw, k)) stats_.band_lots[k] += levels_[i].qty_lots;
+            }
+        }
+    }
+
+    void rebuildStats() {
+        stats_.total_lots   = SimdDepth::sumQty(levels_.data(), count_);
+        stats_.notional_raw = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            stats_.notional_raw += static_cast<double>(levels_[i].price_raw) * static_cast<double>(levels_[i].qty_lots);
+        }
+        rebuildBands();
+    }
+
     bool removeLevel(int64_t price) {
         for (size_t i = 0; i < count_; ++i) {
             if (levels_[i].price_raw == price) {
+                account(price, -levels_[i].qty_lots);
+
                 // Shift everything left
                 std::move(levels_.begin() + i + 1, levels_.begin() + count_, levels_.begin() + i);
                 count_--;
@@ -87,10 +174,11 @@ private:
         return false;
     }
 
-    bool upsertLevel(int64_t price, double qty) {
+    bool upsertLevel(int64_t price, int64_t qty) {
         for (size_t i = 0; i < count_; ++i) {
             if (levels_[i].price_raw == price) {
-                levels_[i].qty = qty; // Update existing
+                account(price, qty - levels_[i].qty_lots);
+                levels_[i].qty_lots = qty; // Update existing
                 return false;         // Best price doesn't change on simply updating qty
             }
             if (Comparator()(price, levels_[i].price_raw)) {
@@ -100,12 +188,14 @@ private:
                     count_++;
                 } else if (i < MAX_LEVELS) {
                     // Drops worst price if full
+                    account(levels_[MAX_LEVELS - 1].price_raw, -levels_[MAX_LEVELS - 1].qty_lots);
                     std::move_backward(levels_.begin() + i, levels_.begin() + MAX_LEVELS - 1, levels_.begin() + MAX_LEVELS);
                 } else {
                     return false; // Fits past MAX_LEVELS, ignore
                 }
                 
                 levels_[i] = Level{price, qty};
+                account(price, qty);
                 int64_t new_best = count_ > 0 ? levels_[0].price_raw : 0;
                 bool changed = (new_best != last_best_);
                 last_best_ = new_best;
@@ -116,6 +206,7 @@ private:
         // Append if room
         if (count_ < MAX_LEVELS) {
             levels_[count_++] = Level{price, qty};
+            account(price, qty);
             int64_t new_best = levels_[0].price_raw;
             bool changed = (new_best != last_best_);
             last_best_ = new_best;
@@ -140,45 +231,56 @@ struct ExchangeBook {
 
     void applySnapshot(
         uint64_t update_id,
-        const std::vector<std::pair<int64_t,double>>& bid_data,
-        const std::vector<std::pair<int64_t,double>>& ask_data
+        const std::vector<std::pair<int64_t,int64_t>>& bid_data,
+        const std::vector<std::pair<int64_t,int64_t>>& ask_data,
+        int64_t now_ms
     ) {
         last_update_id = update_id;
         initialized = true;
         bids.applySnapshot(bid_data);
         asks.applySnapshot(ask_data);
-        last_seen_ms = currentMs();
+        last_seen_ms = now_ms;
     }
 
-    void applyDelta(
+    // Returns true if the best bid or ask price moved (a snapshot counts)
+    bool applyDelta(
         uint64_t update_id,
-        const std::vector<std::pair<int64_t,double>>& bid_deltas,
-        const std::vector<std::pair<int64_t,double>>& ask_deltas,
+        const std::vector<std::pair<int64_t,int64_t>>& bid_deltas,
+        const std::vector<std::pair<int64_t,int64_t>>& ask_deltas,
+        int64_t now_ms,
         bool is_snap = false
     ) {
         if (is_snap) {
-            applySnapshot(update_id, bid_deltas, ask_deltas);
-            return;
+            applySnapshot(update_id, bid_deltas, ask_deltas, now_ms);
+            return true;
         }
 
-        if (!initialized) return;
-        // Ignore stale deltas (sequence gap detection)
-        if (update_id != 0 && update_id <= last_update_id) return;
+        if (!initialized) return false;
+        // Ignore stale deltas (venue-aware gap detection is SequenceGuard's job)
+        if (update_id != 0 && update_id <= last_update_id) return false;
 
-        for (const auto& pair : bid_deltas) bids.applyDelta(pair.first, pair.second);
-        for (const auto& pair : ask_deltas) asks.applyDelta(pair.first, pair.second);
+        bool moved = false;
+        for (const auto& pair : bid_deltas) moved |= bids.applyDelta(pair.first, pair.second);
+        for (const auto& pair : ask_deltas) moved |= asks.applyDelta(pair.first, pair.second);
         if (update_id != 0) last_update_id = update_id;
-        last_seen_ms = currentMs();
+        last_seen_ms = now_ms;
+        return moved;
     }
 
-    bool isStale() const {
-        // Mark exchange as stale if no update in 5 seconds
-        return initialized && (currentMs() - last_seen_ms) > 5000;
+    void rescale(int64_t price_factor, int64_t qty_factor) {
+        bids.rescale(price_factor, qty_factor);
+        asks.rescale(price_factor, qty_factor);
     }
 
-private:
-    static int64_t currentMs() {
-        using namespace std::chrono;
-        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    void setBands(const DepthBands& bands) {
+        bids.setBands(bands);
+        asks.setBands(bands);
+    }
+
+    // No update in STALE_MS of the caller's clock (see clock.hpp)
+    bool isStale(int64_t now_ms) const {
+        return initialized && (now_ms - last_seen_ms) > STALE_MS;
     }
+
+    static constexpr int64_t STALE_MS = 5000;
 };
@@ -0,0 +1,2 @@
+#include "pg_copy.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,2 @@
+#include "risk_engine.hpp"
+// Implementation is inline in header.
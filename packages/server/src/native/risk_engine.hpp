@@ -3,8 +3,10 @@
 
 #include "types.hpp"
 #include "ring_buffer.hpp"
+#include "matching_engine.hpp"
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 class RiskEngine {
 public:
@@ -18,37 +20,61 @@ public:
     void onEvent(const RingBufferEvent& event) {
         if (event.type == EventType::ORACLE_TICK) {
             checkAllPositions(event.payload.oracle.price);
-        } else if (event.type == EventType::USER_ORDER) {
-            handleUserOrder(event.payload.order);
         }
     }
 
-    void handleUserOrder(const OrderPayload& order) {
-        // Find or create account (simplified for demo)
+    // Positions move only on execution — both sides of every fill from
+    // the internal MatchingEngine are booked here.
+    void onFill(const Fill& fill) {
+        applyFill(fill.taker_account_id, fill.taker_is_buy, fill.quantity, fill.price);
+        applyFill(fill.maker_account_id, !fill.taker_is_buy, fill.quantity, fill.price);
+    }
+
+    // nullptr for an account that never traded
+    const Account* find(uint64_t account_id) const {
+        for (const auto& acc : accounts) {
+            if (acc.account_id == account_id) return &acc;
+        }
+        return nullptr;
+    }
+
+private:
+    Account& findOrCreate(uint64_t account_id) {
         // In a real system, this would use a fast hash map or direct indexing
         for (auto& acc : accounts) {
-            if (acc.account_id == order.account_id) {
-                // Update position (simplified)
-                if (order.is_buy) {
-                    acc.position_size += order.quantity;
-                } else {
-                    acc.position_size -= order.quantity;
-                }
-                return;
-            }
+            if (acc.account_id == account_id) return acc;
         }
-        
-        // New account
+
         Account new_acc;
-        new_acc.account_id = order.account_id;
+        new_acc.account_id = account_id;
         new_acc.wallet_balance = 1000000; // $10,000 initial (scaled)
-        new_acc.position_size = order.is_buy ? order.quantity : -order.quantity;
         new_acc.maintenance_margin_bps = 50; // 0.5%
-        new_acc.is_frozen = false;
         accounts.push_back(new_acc);
+        return accounts.back();
+    }
+
+    void applyFill(uint64_t account_id, bool is_buy, int64_t qty, int64_t price) {
+        Account& acc = findOrCreate(account_id);
+        int64_t signed_qty = is_buy ? qty : -qty;
+        int64_t pos = acc.position_size;
+
+        if (pos == 0 || (pos > 0) == is_buy) {
+            // Opening / adding — volume-weighted entry
+            int64_t new_pos = pos + signed_qty;
+            acc.entry_price = (acc.entry_price * std::abs(pos) + price * qty) / std::abs(new_pos);
+            acc.position_size = new_pos;
+            return;
+        }
+
+        // Reducing / flipping — realise PnL on the closed part
+        int64_t closed = std::min(qty, std::abs(pos));
+        int64_t pnl_per = pos > 0 ? (price - acc.entry_price) : (acc.entry_price - price);
+        acc.wallet_balance += pnl_per * closed;
+        acc.position_size = pos + signed_qty;
+        if (acc.position_size == 0)              acc.entry_price = 0;
+        else if ((acc.position_size > 0) != (pos > 0)) acc.entry_price = price;
     }
 
-private:
     void checkAllPositions(int64_t mark_price) {
         for (auto& acc : accounts) {
             if (acc.position_size == 0 || acc.is_frozen) continue;
@@ -0,0 +1,2 @@
+#include "sequence_guard.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,161 @@
+#pragma once
+#include "types.hpp"
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// ── Venue sequence validation ─────────────────────────────────
+// Each venue numbers its depth stream differently; a delta is only safe
+// to apply if it continues exactly from the last one applied (or from
+// the snapshot it is applied on top of):
+//
+//   LINKED_RANGE  Binance  U/u/pu — first/last id of the event, pu = u of
+//                 the previous event. After a snapshot at L the first
+//                 event must straddle it (U <= L+1 <= u+1).
+//   CONTIGUOUS    Bybit    u — every delta is exactly previous u + 1.
+//   LINKED        OKX      seqId/prevSeqId — prevSeqId equals the seqId
+//                 of the previous message (equal ids = no-change beat).
+//
+// On a gap the guard switches to resyncing: deltas are buffered instead
+// of applied until the next snapshot, which then replays whatever in the
+// buffer is newer than it. The book itself is never cleared. Venues
+// without ids (NONE) can't be ordered against a snapshot, so their buffer
+// is dropped instead of replayed.
+
+enum class SeqMode : uint8_t {
+    NONE         = 0,   // venue without usable sequence ids — apply everything
+    LINKED_RANGE = 1,
+    CONTIGUOUS   = 2,
+    LINKED       = 3
+};
+
+inline SeqMode seqModeFor(ExchangeID ex) {
+    switch (ex) {
+        case ExchangeID::BINANCE: return SeqMode::LINKED_RANGE;
+        case ExchangeID::BYBIT:   return SeqMode::CONTIGUOUS;
+        case ExchangeID::OKX:     return SeqMode::LINKED;
+        default:                  return SeqMode::NONE;
+    }
+}
+
+// Ids carried by one delta. 0 = not provided.
+struct DeltaSeq {
+    uint64_t first = 0;   // Binance U
+    uint64_t last  = 0;   // Binance u, Bybit u, OKX seqId
+    uint64_t prev  = 0;   // Binance pu, OKX prevSeqId
+    std::optional<int32_t> checksum;   // OKX / Bitget top-25 CRC32 (book_checksum.hpp)
+};
+
+enum class SeqStatus : uint8_t {
+    APPLIED  = 0,
+    STALE    = 1,   // already covered by the book — dropped
+    BUFFERED = 2,   // held until the next snapshot
+    GAP      = 3,   // gap found just now — caller should request a snapshot
+    CHECKSUM = 4    // applied, but the venue checksum disagrees — ditto
+};
+
+inline bool needsResync(SeqStatus s) { return s == SeqStatus::GAP || s == SeqStatus::CHECKSUM; }
+
+using LevelDeltas = std::vector<std::pair<int64_t, int64_t>>;
+
+struct PendingDelta {
+    DeltaSeq    seq;
+    LevelDeltas bids;
+    LevelDeltas asks;
+};
+
+class SequenceGuard {
+public:
+    static constexpr size_t MAX_PENDING = 4096;   // ~7 min of Binance 100ms deltas
+
+    enum class Verdict : uint8_t { APPLY, STALE, GAP };
+
+    explicit SequenceGuard(SeqMode mode = SeqMode::NONE) : mode_(mode) {}
+
+    SeqMode mode() const { return mode_; }
+    bool resyncing() const { return resyncing_; }
+    bool synced() const { return synced_; }
+    uint64_t lastId() const { return last_id_; }
+    size_t pending() const { return pending_.size(); }
+
+    // Whether `seq` continues the stream. Snapshot id 0 means the snapshot
+    // carried no id, so the first delta after it is taken on trust.
+    Verdict check(const DeltaSeq& seq) const {
+        const uint64_t L = last_id_;
+        const bool anchored = L != 0 || synced_;
+
+        switch (mode_) {
+            case SeqMode::NONE:
+                return Verdict::APPLY;
+
+            case SeqMode::LINKED_RANGE:
+                if (anchored && seq.last <= L) return Verdict::STALE;
+                if (!synced_) return (L != 0 && seq.first > L + 1) ? Verdict::GAP : Verdict::APPLY;
+                return seq.prev == L ? Verdict::APPLY : Verdict::GAP;
+
+            case SeqMode::CONTIGUOUS:
+                if (anchored && seq.last <= L) return Verdict::STALE;
+                if (!anchored) return Verdict::APPLY;
+                return seq.last == L + 1 ? Verdict::APPLY : Verdict::GAP;
+
+            case SeqMode::LINKED:
+                if (!anchored || seq.prev == L) return Verdict::APPLY;
+                return seq.last <= L ? Verdict::STALE : Verdict::GAP;
+        }
+        return Verdict::APPLY;
+    }
+
+    // Record an applied delta
+    void commit(const DeltaSeq& seq) {
+        if (seq.last != 0) last_id_ = seq.last;
+        synced_ = true;
+    }
+
+    // Snapshot applied at `id`: ends any resync
+    void onSnapshot(uint64_t id) {
+        last_id_   = id;
+        synced_    = false;
+        resyncing_ = false;
+    }
+
+    void beginResync() { resyncing_ = true; }
+
+    // Warm restart (state_snapshot.hpp): continue from a saved position
+    // as if its deltas had just been applied here
+    void restore(uint64_t last_id, bool synced) {
+        reset();
+        last_id_ = last_id;
+        synced_  = synced;
+    }
+
+    // Oldest deltas go first on overflow — the snapshot that ends the
+    // resync is newer than they are anyway.
+    void buffer(const DeltaSeq& seq, const LevelDeltas& bids, const LevelDeltas& asks) {
+        if (pending_.size() >= MAX_PENDING) pending_.pop_front();
+        pending_.push_back(PendingDelta{ seq, bids, asks });
+    }
+
+    std::deque<PendingDelta> takePending() {
+        std::deque<PendingDelta> out;
+        out.swap(pending_);
+        return out;
+    }
+
+    void restorePending(std::deque<PendingDelta>&& rest) { pending_ = std::move(rest); }
+
+    void reset() {
+        last_id_   = 0;
+        synced_    = false;
+        resyncing_ = false;
+        pending_.clear();
+    }
+
+private:
+    SeqMode  mode_;
+    uint64_t last_id_   = 0;
+    bool     synced_    = false;   // a delta has been applied since the snapshot
+    bool     resyncing_ = false;
+    std::deque<PendingDelta> pending_;
+};
@@ -0,0 +1,2 @@
+#include "shared_mirror.hpp"
+// Implementation is inline in header.
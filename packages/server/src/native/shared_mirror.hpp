@@ -0,0 +1,171 @@
+#ifndef SHARED_MIRROR_HPP
+#define SHARED_MIRROR_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Cross-process snapshot mirror over a named POSIX shared-memory segment.
+//
+// The ingest process owns the segment and publishes every StateMirror
+// update into it under a seqlock: `seq` is odd while a write is in
+// progress, and readers retry if it was odd or moved during their copy.
+// WebSocket fan-out processes attach read-only and copy the latest book
+// straight out of the mapping — no IPC, no serialization.
+//
+// POSIX only; on Windows open()/attach() return false.
+
+struct SharedMirrorSegment {
+    static constexpr uint32_t MAGIC  = 0x54524D53;   // "TRMS"
+    static constexpr uint32_t LAYOUT = 3;            // bump when AggregatedSnapshot changes
+
+    uint32_t magic;
+    uint32_t layout;
+    uint64_t snapshot_size;
+    alignas(64) std::atomic<uint64_t> seq;
+    std::atomic<uint64_t>             version;
+    alignas(64) AggregatedSnapshot    snap;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics across processes");
+
+// ── Writer (ingest process) ─────────────────────────────────────
+class SharedMirrorWriter {
+public:
+    ~SharedMirrorWriter() { close(); }
+
+    bool open(const std::string& name) {
+#ifdef _WIN32
+        (void)name;
+        return false;
+#else
+        close();
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, sizeof(SharedMirrorSegment)) != 0) { ::close(fd); return false; }
+
+        void* p = ::mmap(nullptr, sizeof(SharedMirrorSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        seg_ = static_cast<SharedMirrorSegment*>(p);
+        seg_->seq.store(0, std::memory_order_relaxed);
+        seg_->version.store(0, std::memory_order_relaxed);
+        seg_->snapshot_size = sizeof(AggregatedSnapshot);
+        seg_->layout = SharedMirrorSegment::LAYOUT;
+        std::atomic_thread_fence(std::memory_order_release);
+        seg_->magic = SharedMirrorSegment::MAGIC;
+        name_ = name;
+        return true;
+#endif
+    }
+
+    void publish(const AggregatedSnapshot& snap, uint64_t version) {
+        if (!seg_) return;
+        uint64_t s = seg_->seq.load(std::memory_order_relaxed);
+        seg_->seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(static_cast<void*>(&seg_->snap), &snap, sizeof(AggregatedSnapshot));
+        seg_->version.store(version, std::memory_order_relaxed);
+        seg_->seq.store(s + 2, std::memory_order_release);
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (seg_) {
+            ::munmap(seg_, sizeof(SharedMirrorSegment));
+            ::shm_unlink(name_.c_str());
+        }
+#endif
+        seg_ = nullptr;
+        name_.clear();
+    }
+
+    bool isOpen() const { return seg_ != nullptr; }
+
+private:
+    SharedMirrorSegment* seg_ = nullptr;
+    std::string name_;
+};
+
+// ── Reader (fan-out processes) ──────────────────────────────────
+class SharedMirrorReader {
+public:
+    ~SharedMirrorReader() { detach(); }
+
+    bool attach(const std::string& name) {
+#ifdef _WIN32
+        (void)name;
+        return false;
+#else
+        detach();
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedMirrorSegment)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* p = ::mmap(nullptr, sizeof(SharedMirrorSegment), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        auto* seg = static_cast<const SharedMirrorSegment*>(p);
+        if (seg->magic != SharedMirrorSegment::MAGIC ||
+            seg->layout != SharedMirrorSegment::LAYOUT ||
+            seg->snapshot_size != sizeof(AggregatedSnapshot)) {
+            ::munmap(p, sizeof(SharedMirrorSegment));
+            return false;
+        }
+        seg_ = seg;
+        return true;
+#endif
+    }
+
+    // Copy the latest snapshot if its version is > `since`. Returns false
+    // when nothing newer exists or the writer kept it busy for every retry.
+    bool readIfNewer(uint64_t since, AggregatedSnapshot& out, uint64_t& version_out) const {
+        if (!seg_) return false;
+        for (int attempt = 0; attempt < MAX_RETRIES; ++attempt) {
+            uint64_t s1 = seg_->seq.load(std::memory_order_acquire);
+            if (s1 & 1) continue;
+
+            uint64_t v = seg_->version.load(std::memory_order_relaxed);
+            if (v <= since) return false;
+
+            std::memcpy(&out, static_cast<const void*>(&seg_->snap), sizeof(AggregatedSnapshot));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seg_->seq.load(std::memory_order_relaxed) == s1) {
+                version_out = v;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void detach() {
+#ifndef _WIN32
+        if (seg_) ::munmap(const_cast<SharedMirrorSegment*>(seg_), sizeof(SharedMirrorSegment));
+#endif
+        seg_ = nullptr;
+    }
+
+    bool isAttached() const { return seg_ != nullptr; }
+
+private:
+    static constexpr int MAX_RETRIES = 64;
+    const SharedMirrorSegment* seg_ = nullptr;
+};
+
+#endif // SHARED_MIRROR_HPP
@@ -0,0 +1,2 @@
+#include "simd_depth.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,127 @@
+#pragma once
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// ── Depth reductions over Level arrays ────────────────────────
+// Total and cumulative quantity of a run of levels, in integer lots.
+// Level is {int64 price, int64 qty}, so one 256-bit load holds two levels
+// and the qty lanes are the odd ones — no shuffling for the total.
+//
+// AVX2 is picked at runtime (the addon is built without -mavx2); other
+// CPUs and non-x86 builds use the scalar loops, which give identical
+// results since integer addition is exact in any order.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TERMINUS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TERMINUS_TARGET_AVX2
+#else
+#define TERMINUS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace SimdDepth {
+
+static_assert(sizeof(Level) == 16, "SIMD depth sums assume {int64 price, int64 qty} levels");
+
+// ── Scalar reference ──────────────────────────────────────────
+inline int64_t sumQtyScalar(const Level* lv, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += lv[i].qty_lots;
+    return sum;
+}
+
+inline int64_t cumulativeQtyScalar(const Level* lv, size_t n, int64_t* out) {
+    int64_t run = 0;
+    for (size_t i = 0; i < n; ++i) out[i] = run += lv[i].qty_lots;
+    return run;
+}
+
+#ifdef TERMINUS_SIMD_X86
+inline bool hasAvx2() {
+    static const bool supported = [] {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }();
+    return supported;
+}
+
+// ── AVX2 ──────────────────────────────────────────────────────
+// Four accumulators (8 levels per iteration) to hide add latency.
+TERMINUS_TARGET_AVX2 inline int64_t sumQtyAvx2(const Level* lv, size_t n) {
+    const auto* p = reinterpret_cast<const __m256i*>(lv);
+    __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8, p += 4) {
+        a0 = _mm256_add_epi64(a0, _mm256_loadu_si256(p));
+        a1 = _mm256_add_epi64(a1, _mm256_loadu_si256(p + 1));
+        a2 = _mm256_add_epi64(a2, _mm256_loadu_si256(p + 2));
+        a3 = _mm256_add_epi64(a3, _mm256_loadu_si256(p + 3));
+    }
+    for (; i + 2 <= n; i += 2, ++p) a0 = _mm256_add_epi64(a0, _mm256_loadu_si256(p));
+
+    // Lanes are [price, qty, price, qty] — keep the qty ones
+    __m256i acc = _mm256_add_epi64(_mm256_add_epi64(a0, a1), _mm256_add_epi64(a2, a3));
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    int64_t sum = lanes[1] + lanes[3];
+
+    if (i < n) sum += lv[i].qty_lots;
+    return sum;
+}
+
+// In-register inclusive scan of four qty lanes per step, carried across
+// steps by broadcasting the last lane.
+TERMINUS_TARGET_AVX2 inline int64_t cumulativeQtyAvx2(const Level* lv, size_t n, int64_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i carry = zero;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lv + i));       // p0 q0 p1 q1
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lv + i + 2));   // p2 q2 p3 q3
+        __m256i q = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), _MM_SHUFFLE(3, 1, 2, 0));   // q0 q1 q2 q3
+
+        q = _mm256_add_epi64(q, _mm256_blend_epi32(_mm256_permute4x64_epi64(q, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+        q = _mm256_add_epi64(q, _mm256_blend_epi32(_mm256_permute4x64_epi64(q, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+        q = _mm256_add_epi64(q, carry);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), q);
+        carry = _mm256_permute4x64_epi64(q, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    int64_t run = i > 0 ? out[i - 1] : 0;
+    for (; i < n; ++i) out[i] = run += lv[i].qty_lots;
+    return run;
+}
+#endif
+
+// ── Dispatch ──────────────────────────────────────────────────
+inline int64_t sumQty(const Level* lv, size_t n) {
+#ifdef TERMINUS_SIMD_X86
+    if (n >= 8 && hasAvx2()) return sumQtyAvx2(lv, n);
+#endif
+    return sumQtyScalar(lv, n);
+}
+
+// out[i] = qty of levels [0, i]; returns the total
+inline int64_t cumulativeQty(const Level* lv, size_t n, int64_t* out) {
+#ifdef TERMINUS_SIMD_X86
+    if (n >= 8 && hasAvx2()) return cumulativeQtyAvx2(lv, n, out);
+#endif
+    return cumulativeQtyScalar(lv, n, out);
+}
+
+} // namespace SimdDepth
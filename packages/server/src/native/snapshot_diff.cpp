@@ -0,0 +1,2 @@
+#include "snapshot_diff.hpp"
+// Implementation is inline in header.
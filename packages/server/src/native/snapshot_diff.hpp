@@ -0,0 +1,174 @@
+#pragma once
+#include "types.hpp"
+#include <map>
+#include <vector>
+#include <functional>
+
+// Tracks the consolidated top-N book across successive snapshots and
+// stamps every level with the version at which it last changed.
+// A broadcast can then ship only what moved since the version the client
+// already holds, instead of the full 50×2 levels every tick.
+//
+// Removed levels stay as tombstones for RETAIN_VERSIONS versions; a client
+// further behind than that (or at version 0) gets a full replacement.
+
+// UPSERT covers both new and resized levels. REMOVED is emitted for every
+// level dropped since `since`; clients delete it if they hold it.
+enum class LevelChangeKind : uint8_t { UPSERT, REMOVED };
+
+struct LevelChange {
+    int64_t         price_raw;
+    int64_t         qty_lots;  // 0 for REMOVED
+    LevelChangeKind kind;
+
+    double price_f(int64_t scale) const { return static_cast<double>(price_raw) / scale; }
+    double qty_f(int64_t scale)   const { return static_cast<double>(qty_lots) / scale; }
+};
+
+struct AggregatedDiff {
+    uint64_t from_version  = 0;
+    uint64_t version       = 0;
+    bool     full          = false;   // changes are the whole book — replace, don't patch
+    bool     walls_changed = false;
+    std::vector<LevelChange> bids;    // in book order (best first)
+    std::vector<LevelChange> asks;
+    AggregatedSnapshot snap{};        // latest snapshot — BBO, walls
+};
+
+class SnapshotDiffTracker {
+public:
+    static constexpr uint64_t RETAIN_VERSIONS = 256;
+
+    // Fold in a new snapshot; bumps the version only if something changed.
+    void observe(const AggregatedSnapshot& snap) {
+        const uint64_t v = version_ + 1;
+        bool changed = false;
+        changed |= observeSide(bids_, snap.bids, snap.bid_count, v);
+        changed |= observeSide(asks_, snap.asks, snap.ask_count, v);
+
+        if (wallsDiffer(snap)) {
+            walls_version_ = v;
+            changed = true;
+        }
+
+        last_ = snap;
+        if (!changed) return;
+        version_ = v;
+
+        if (version_ > RETAIN_VERSIONS) {
+            pruneTombstones(bids_, version_ - RETAIN_VERSIONS);
+            pruneTombstones(asks_, version_ - RETAIN_VERSIONS);
+        }
+    }
+
+    void diffSince(uint64_t since, AggregatedDiff& out) const {
+        out.from_version = since;
+        out.version      = version_;
+        out.full         = since == 0 || since < horizon_ || since > version_;
+        out.walls_changed = out.full || walls_version_ > since;
+        out.snap         = last_;
+        out.bids.clear();
+        out.asks.clear();
+
+        collect(bids_, since, out.full, out.bids);
+        collect(asks_, since, out.full, out.asks);
+    }
+
+    uint64_t version() const { return version_; }
+
+    void reset() { *this = SnapshotDiffTracker{}; }
+
+    // Forget every level but keep the version counter, so any client
+    // holding an older version gets a full book next (price keys changed).
+    void rebase() {
+        bids_.clear();
+        asks_.clear();
+        last_ = AggregatedSnapshot{};
+        horizon_ = version_ + 1;
+    }
+
+private:
+    struct Tracked {
+        int64_t  qty;       // lots
+        uint64_t changed;   // version of last insert/update/remove
+        bool     removed;
+    };
+
+    template<typename Map>
+    static bool observeSide(Map& side, const Level* levels, size_t n, uint64_t v) {
+        bool changed = false;
+
+        // Present levels: insert / update / revive
+        for (size_t i = 0; i < n; ++i) {
+            auto [it, inserted] = side.try_emplace(levels[i].price_raw, Tracked{ levels[i].qty_lots, v, false });
+            if (inserted) { changed = true; continue; }
+
+            Tracked& t = it->second;
+            if (t.removed || t.qty != levels[i].qty_lots) {
+                t.removed = false;
+                t.qty = levels[i].qty_lots;
+                t.changed = v;
+                changed = true;
+            }
+        }
+
+        // Absent levels: tombstone. Both sequences are in book order, so a
+        // single merge walk finds them.
+        size_t i = 0;
+        for (auto& [price, t] : side) {
+            while (i < n && typename Map::key_compare()(levels[i].price_raw, price)) ++i;
+            bool present = i < n && levels[i].price_raw == price;
+            if (!present && !t.removed) {
+                t.removed = true;
+                t.qty = 0;
+                t.changed = v;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    template<typename Map>
+    void pruneTombstones(Map& side, uint64_t older_than) {
+        for (auto it = side.begin(); it != side.end();) {
+            if (it->second.removed && it->second.changed < older_than) {
+                if (it->second.changed > horizon_) horizon_ = it->second.changed;
+                it = side.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    template<typename Map>
+    static void collect(const Map& side, uint64_t since, bool full, std::vector<LevelChange>& out) {
+        for (const auto& [price, t] : side) {
+            if (full) {
+                if (!t.removed) out.push_back(LevelChange{ price, t.qty, LevelChangeKind::UPSERT });
+                continue;
+            }
+            if (t.changed <= since) continue;
+            out.push_back(t.removed
+                ? LevelChange{ price, 0,     LevelChangeKind::REMOVED }
+                : LevelChange{ price, t.qty, LevelChangeKind::UPSERT });
+        }
+    }
+
+    bool wallsDiffer(const AggregatedSnapshot& s) const {
+        if (s.bid_wall_count != last_.bid_wall_count || s.ask_wall_count != last_.ask_wall_count) return true;
+        for (size_t i = 0; i < s.bid_wall_count; ++i) {
+            if (s.bid_walls[i].price != last_.bid_walls[i].price || s.bid_walls[i].qty != last_.bid_walls[i].qty) return true;
+        }
+        for (size_t i = 0; i < s.ask_wall_count; ++i) {
+            if (s.ask_walls[i].price != last_.ask_walls[i].price || s.ask_walls[i].qty != last_.ask_walls[i].qty) return true;
+        }
+        return false;
+    }
+
+    std::map<int64_t, Tracked, std::greater<int64_t>> bids_;
+    std::map<int64_t, Tracked, std::less<int64_t>>    asks_;
+    AggregatedSnapshot last_{};
+    uint64_t version_       = 0;
+    uint64_t walls_version_ = 0;
+    uint64_t horizon_       = 0;   // oldest `since` we can still diff from
+};
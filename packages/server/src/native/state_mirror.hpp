@@ -2,30 +2,83 @@
 #define STATE_MIRROR_HPP
 
 #include "types.hpp"
+#include "shared_mirror.hpp"
 #include <atomic>
-#include <mutex>
-#include <cstring>
+#include <cstdint>
+#include <string>
 
-// Dual-buffered state mirror for zero-blocking reads from Node.js
+// Triple-buffered state mirror for zero-blocking reads from Node.js.
+//
+// Three slots rotate between writer (back), a shared hand-off (middle) and
+// the reader (front). Publishing swaps back↔middle with one atomic exchange;
+// reading swaps middle↔front only when the middle holds something newer.
+// Neither side ever waits on the other and the reader always sees a
+// complete snapshot.
+//
+// Single writer (ExecutionEngine thread or the N-API thread — not both),
+// single reader (Node main thread). Pointers returned by readIfNewer stay
+// valid until the reader's next call.
+//
+// Optionally every publish is also written to a named shared-memory
+// segment (see shared_mirror.hpp) for out-of-process readers.
 class StateMirror {
 public:
     void update(const AggregatedSnapshot& snap) {
-        // Simple mutex for the mirror update is fine as it's not on the matching hot-path
-        // (The ExecutionEngine calls this after the match is done)
-        std::lock_guard<std::mutex> lock(mutex_);
-        current_state_ = snap;
-        version_.fetch_add(1, std::memory_order_release);
+        Slot& back = slots_[back_];
+        back.snap    = snap;
+        back.version = ++write_version_;
+
+        uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel);
+        back_ = prev & INDEX_MASK;
+        version_.store(write_version_, std::memory_order_release);
+
+        shared_.publish(snap, write_version_);
     }
 
+    // Writer-side: start mirroring into shm segment `name` (e.g. "/terminus_book")
+    bool enableShared(const std::string& name) { return shared_.open(name); }
+    void disableShared()                       { shared_.close(); }
+
     AggregatedSnapshot read() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return current_state_;
+        acquireLatest();
+        return slots_[front_].snap;
+    }
+
+    // Latest snapshot if its version is > `since`, else nullptr — lets the
+    // broadcast timer skip serialization entirely when nothing changed.
+    const AggregatedSnapshot* readIfNewer(uint64_t since, uint64_t& version_out) {
+        if (version_.load(std::memory_order_acquire) <= since) return nullptr;
+        acquireLatest();
+        const Slot& front = slots_[front_];
+        if (front.version <= since) return nullptr;
+        version_out = front.version;
+        return &front.snap;
     }
 
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
 private:
-    std::mutex mutex_;
-    AggregatedSnapshot current_state_;
-    std::atomic<uint64_t> version_{0};
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH      = 0x4;   // middle holds an unread publish
+
+    void acquireLatest() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return;
+        uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & INDEX_MASK;
+    }
+
+    struct alignas(64) Slot {
+        AggregatedSnapshot snap{};
+        uint64_t version = 0;
+    };
+
+    Slot slots_[3];
+    alignas(64) std::atomic<uint8_t>  middle_{1};
+    alignas(64) uint8_t               back_  = 2;     // writer-owned
+    uint64_t                          write_version_ = 0;
+    alignas(64) uint8_t               front_ = 0;     // reader-owned
+    alignas(64) std::atomic<uint64_t> version_{0};
+    SharedMirrorWriter                shared_;
 };
 
 #endif // STATE_MIRROR_HPP
@@ -0,0 +1,2 @@
+#include "state_snapshot.hpp"
+// Implementation is inline in header.
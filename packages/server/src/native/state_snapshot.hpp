@@ -0,0 +1,193 @@
+#ifndef STATE_SNAPSHOT_HPP
+#define STATE_SNAPSHOT_HPP
+
+#include "symbol_registry.hpp"
+#include "vwaf.hpp"
+#include "book_journal.hpp"
+#include "book_checksum.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Warm-restart file: every symbol's books and the VWAF inputs in one
+// binary file, so a restarted process serves the last books — with their
+// venue sequence positions — in milliseconds instead of waiting on a REST
+// snapshot per venue per symbol.
+//
+//   header   64 bytes: magic, version, saved ms, body length, CRC32 of
+//            the body.
+//   body     sections [u8 tag][varint length][payload]. SYMBOL carries the
+//            name then CrossExchangeAggregator::saveState(); VWAF carries
+//            VWAFEngine::saveState(). Unknown tags are skipped, so a later
+//            version can add sections without breaking older files.
+//
+// Saved to <path>.tmp and renamed over <path>, so a crash mid-save keeps
+// the previous file. Levels use the journal's codec (book_journal.hpp).
+
+enum class StateSection : uint8_t {
+    END    = 0,
+    SYMBOL = 1,   // name, aggregator state
+    VWAF   = 2
+};
+
+struct StateFileHeader {
+    static constexpr uint32_t MAGIC   = 0x54524D53;   // "TRMS"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    int64_t  saved_ms;
+    uint64_t bytes;          // body length
+    uint32_t crc;            // CRC32 of the body
+    uint8_t  reserved[36];
+};
+static_assert(sizeof(StateFileHeader) == 64, "state file header is 64 bytes on disk");
+
+struct StateFileStats {
+    bool        ok       = false;
+    const char* error    = "";    // why not ok: "missing", "io", "corrupt", "version"
+    size_t      symbols  = 0;
+    size_t      books    = 0;
+    uint64_t    bytes    = 0;     // file size
+    int64_t     saved_ms = 0;
+    uint64_t    elapsed_ns = 0;
+};
+
+class StateSnapshot {
+public:
+    static StateFileStats save(const std::string& path, SymbolRegistry& registry, const VWAFEngine& vwaf,
+                               int64_t now_ms) {
+        const auto t0 = std::chrono::steady_clock::now();
+        StateFileStats st;
+        JournalCodec::Buffer body, section;
+
+        for (size_t id = 0; id < registry.size(); ++id) {
+            SymbolBook* book = registry.get(static_cast<SymbolID>(id));
+            if (!book) continue;
+            const std::string& name = registry.name(static_cast<SymbolID>(id));
+            section.clear();
+            section.bytes(name.data(), name.size());
+            st.books += book->aggregator.saveState(section);
+            putSection(body, StateSection::SYMBOL, section);
+            ++st.symbols;
+        }
+        section.clear();
+        vwaf.saveState(section);
+        putSection(body, StateSection::VWAF, section);
+
+        StateFileHeader h{};
+        h.magic    = StateFileHeader::MAGIC;
+        h.version  = StateFileHeader::VERSION;
+        h.saved_ms = now_ms;
+        h.bytes    = body.size();
+        h.crc      = BookChecksum::crc32(reinterpret_cast<const char*>(body.data()), body.size());
+
+        const std::string tmp = path + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return fail(st, "io");
+        bool written = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+                       std::fwrite(body.data(), 1, body.size(), f) == body.size() &&
+                       std::fflush(f) == 0;
+#ifndef _WIN32
+        written = written && ::fsync(::fileno(f)) == 0;
+#endif
+        written = std::fclose(f) == 0 && written;
+#ifdef _WIN32
+        if (written) std::remove(path.c_str());   // rename() won't replace on Windows
+#endif
+        if (!written || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return fail(st, "io");
+        }
+
+        st.ok       = true;
+        st.bytes    = sizeof(h) + body.size();
+        st.saved_ms = now_ms;
+        st.elapsed_ns = elapsedNs(t0);
+        return st;
+    }
+
+    // All-or-nothing per section: a symbol whose payload doesn't parse is
+    // left as it was; a bad header or CRC restores nothing.
+    static StateFileStats load(const std::string& path, SymbolRegistry& registry, VWAFEngine& vwaf) {
+        const auto t0 = std::chrono::steady_clock::now();
+        StateFileStats st;
+
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return fail(st, "missing");
+        StateFileHeader h{};
+        std::vector<uint8_t> body;
+        bool read = std::fread(&h, sizeof(h), 1, f) == 1;
+        if (read && h.magic == StateFileHeader::MAGIC && h.version == StateFileHeader::VERSION && h.bytes < (uint64_t(1) << 32)) {
+            body.resize(static_cast<size_t>(h.bytes));
+            read = std::fread(body.data(), 1, body.size(), f) == body.size();
+        }
+        std::fclose(f);
+
+        if (!read) return fail(st, "corrupt");
+        if (h.magic != StateFileHeader::MAGIC) return fail(st, "corrupt");
+        if (h.version != StateFileHeader::VERSION) return fail(st, "version");
+        if (BookChecksum::crc32(reinterpret_cast<const char*>(body.data()), body.size()) != h.crc) {
+            return fail(st, "corrupt");
+        }
+
+        using namespace JournalCodec;
+        const uint8_t* p   = body.data();
+        const uint8_t* end = p + body.size();
+        while (p < end) {
+            const auto tag = static_cast<StateSection>(*p++);
+            uint64_t len;
+            if (!getVarint(p, end, len) || len > static_cast<uint64_t>(end - p)) return fail(st, "corrupt");
+            const uint8_t* q = p;
+            const uint8_t* section_end = p + len;
+            p = section_end;
+
+            if (tag == StateSection::SYMBOL) {
+                uint64_t name_len;
+                if (!getVarint(q, section_end, name_len) || name_len > static_cast<uint64_t>(section_end - q)) continue;
+                const std::string name(reinterpret_cast<const char*>(q), static_cast<size_t>(name_len));
+                q += name_len;
+
+                SymbolBook* book = registry.get(registry.intern(name));
+                size_t books = 0;
+                if (book && book->aggregator.restoreState(q, section_end, books)) {
+                    ++st.symbols;
+                    st.books += books;
+                }
+            } else if (tag == StateSection::VWAF) {
+                vwaf.restoreState(q, section_end);
+            }
+        }
+
+        st.ok       = true;
+        st.bytes    = sizeof(h) + body.size();
+        st.saved_ms = h.saved_ms;
+        st.elapsed_ns = elapsedNs(t0);
+        return st;
+    }
+
+private:
+    static void putSection(JournalCodec::Buffer& out, StateSection tag, const JournalCodec::Buffer& payload) {
+        out.u8(static_cast<uint8_t>(tag));
+        out.bytes(reinterpret_cast<const char*>(payload.data()), payload.size());
+    }
+
+    static StateFileStats fail(StateFileStats& st, const char* error) {
+        st.ok    = false;
+        st.error = error;
+        return st;
+    }
+
+    static uint64_t elapsedNs(std::chrono::steady_clock::time_point t0) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+    }
+};
+
+#endif // STATE_SNAPSHOT_HPP
@@ -0,0 +1,2 @@
+#include "symbol_registry.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,92 @@
+#pragma once
+#include "aggregator.hpp"
+#include "depth_history.hpp"
+#include "trade_flow.hpp"
+#include "trade_tape.hpp"
+#include "state_mirror.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// ── Symbol registry ───────────────────────────────────────────
+// Interns instrument names ("BTCUSDT", "SOLUSDT", ...) to dense ids and
+// owns one aggregator + mirror per id, so a single process can keep many
+// books warm at once and a symbol switch is just a different id.
+//
+// The pool is allocated once up front (~11MB for 64 symbols); ids are
+// never recycled, so a SymbolBook pointer stays valid for the process
+// lifetime. Lookup by id is lock-free; only interning takes the mutex.
+
+using SymbolID = uint16_t;
+
+constexpr size_t   MAX_SYMBOLS    = 64;
+constexpr SymbolID INVALID_SYMBOL = UINT16_MAX;
+
+// Everything the bindings keep per instrument
+struct SymbolBook {
+    SymbolID                id = INVALID_SYMBOL;
+    CrossExchangeAggregator aggregator;
+    StateMirror             mirror;
+    DepthHistory            history;                // heatmap columns, when enabled
+    TradeFlowEngine         flow;                   // CVD, trade sizes, rolling imbalance
+    TradeTape               tape;                   // recent trades, when enabled
+    uint8_t                 last_active      = 0;   // activeMask at last mirror publish
+    uint64_t                mirrored_version = 0;   // diff version last pushed to the mirror
+};
+
+class SymbolRegistry {
+public:
+    SymbolRegistry() : pool_(new SymbolBook[MAX_SYMBOLS]) {}
+
+    // Id for `name`, registering it on first sight. INVALID_SYMBOL when full.
+    SymbolID intern(const std::string& name) {
+        std::lock_guard lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+
+        size_t n = count_.load(std::memory_order_relaxed);
+        if (n >= MAX_SYMBOLS || name.empty()) return INVALID_SYMBOL;
+
+        const auto id = static_cast<SymbolID>(n);
+        names_[id] = name;
+        pool_[id].id = id;
+        if (journal_) pool_[id].aggregator.setJournal(journal_, id, name);
+        ids_.emplace(name, id);
+        count_.store(n + 1, std::memory_order_release);   // publishes names_[id]
+        return id;
+    }
+
+    SymbolID find(const std::string& name) const {
+        std::lock_guard lock(mutex_);
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : INVALID_SYMBOL;
+    }
+
+    SymbolBook* get(SymbolID id) {
+        return id < count_.load(std::memory_order_acquire) ? &pool_[id] : nullptr;
+    }
+
+    // Journal every symbol's book inputs — current ones and any interned
+    // later — or stop with nullptr. Stream ids are symbol ids.
+    void setJournal(BookJournal* journal) {
+        std::lock_guard lock(mutex_);
+        journal_ = journal;
+        const size_t n = count_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            pool_[i].aggregator.setJournal(journal, static_cast<uint16_t>(i), names_[i]);
+        }
+    }
+
+    const std::string& name(SymbolID id) const { return names_[id]; }
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<SymbolBook[]> pool_;
+    std::string                   names_[MAX_SYMBOLS];
+    std::unordered_map<std::string, SymbolID> ids_;
+    std::atomic<size_t>           count_{ 0 };
+    BookJournal*                  journal_ = nullptr;
+    mutable std::mutex            mutex_;
+};
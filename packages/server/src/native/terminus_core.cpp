@@ -5,18 +5,45 @@
 
 #include <napi.h>
 #include "aggregator.hpp"
+#include "symbol_registry.hpp"
 #include "vwaf.hpp"
+#include "matching_engine.hpp"
+#include "risk_engine.hpp"
+#include "state_mirror.hpp"
+#include "simd_depth.hpp"
+#include "book_journal.hpp"
+#include "journal_replay.hpp"
+#include "state_snapshot.hpp"
+#include "depth_history.hpp"
+#include "candle_engine.hpp"
+#include "pg_copy.hpp"
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <numeric>
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 
 using namespace Napi;
 
 // ── Global singletons — created once, live for process lifetime ──
-static CrossExchangeAggregator g_aggregator;
+static BookJournal              g_journal;         // declared first: outlives the aggregators writing to it
+static SymbolRegistry           g_symbols;         // one aggregator + mirror per instrument
 static VWAFEngine               g_vwaf;
+static CandleEngine             g_candles;         // aggregated candles, all symbols × intervals
+static Napi::FunctionReference  g_on_resync;       // (symbol, exchange) → fetch a snapshot
+static Napi::FunctionReference  g_on_bbo;          // (symbol, events) → crosses / deviations
+static std::unordered_map<uint32_t, std::unique_ptr<JournalReplay>> g_replays;   // JS thread only
+static std::unique_ptr<FillRing>       g_fills;       // internal user-order book, created on first order
+static std::unique_ptr<MatchingEngine> g_matching;
+static std::unique_ptr<RingBuffer<RingBufferEvent, 65536>> g_risk_events;   // liquidations raised by g_risk
+static std::unique_ptr<RiskEngine>     g_risk;        // positions booked from g_matching's fills
+static uint32_t                 g_next_replay = 1;
+static std::unordered_map<uint32_t, std::unique_ptr<SharedMirrorReader>> g_shared_readers;   // fan-out processes only
+static uint32_t                 g_next_shared_reader = 1;
 
 // ── Gaussian PDF ──────────────────────────────────────────────────────────
 double normalPdf(double x) {
@@ -46,6 +73,10 @@ double normalPpf(double p) {
     return t - ((c[2] * t + c[1]) * t + c[0]) / (((d[2] * t + d[1]) * t + d[0]) * t + 1.0);
 }
 
+static const char* EXCHANGE_NAMES[] = {
+    "binance","bybit","okx","hyperliquid","gate","mexc","bitget"
+};
+
 // ── Helper: parse exchange ID from JS value (string or number) ──
 ExchangeID parseExchange(const Napi::Value& val) {
     if (val.IsNumber()) {
@@ -68,9 +99,30 @@ ExchangeID parseExchange(const Napi::Value& val) {
     return ExchangeID::MAX_EXCHANGES;
 }
 
+// ── Helper: resolve symbol arg (interned id or name) → its book ──
+// Names are interned on first use, so callers may skip registerSymbol.
+// Every book binding passes through here once, so this is also where a
+// COARSE process clock takes its once-per-call reading.
+SymbolBook& parseSymbol(const Napi::Value& val) {
+    Clock::process().tick();
+    SymbolID id = INVALID_SYMBOL;
+    if (val.IsNumber()) {
+        id = static_cast<SymbolID>(std::min<uint32_t>(val.As<Napi::Number>().Uint32Value(), INVALID_SYMBOL));
+    } else if (val.IsString()) {
+        id = g_symbols.intern(val.As<Napi::String>().Utf8Value());
+    }
+    SymbolBook* book = g_symbols.get(id);
+    if (!book) throw std::invalid_argument("Unknown symbol");
+    return *book;
+}
+
 // ── Helper: parse [[price_str, qty_str], ...] from JS Array ──────
-std::vector<std::pair<int64_t,double>> parseLevels(const Napi::Array& arr) {
-    std::vector<std::pair<int64_t,double>> out;
+// → [(price_raw, qty_lots)] at the book's scales. `scale` is the price
+// scale — a compile-time constant for the common ones (see
+// withPriceScale), int64_t otherwise.
+template<typename Scale>
+std::vector<std::pair<int64_t,int64_t>> parseLevelsScaled(const Napi::Array& arr, Scale scale, int64_t qty_scale) {
+    std::vector<std::pair<int64_t,int64_t>> out;
     out.reserve(arr.Length());
     for (uint32_t i = 0; i < arr.Length(); ++i) {
         Napi::Array level = arr.Get(i).As<Napi::Array>();
@@ -91,36 +143,188 @@ std::vector<std::pair<int64_t,double>> parseLevels(const Napi::Array& arr) {
             qty_f = level.Get(static_cast<uint32_t>(1)).As<Napi::Number>().DoubleValue();
         }
 
-        int64_t price_raw = static_cast<int64_t>(std::round(price_f * PRICE_SCALE));
-        out.emplace_back(price_raw, qty_f);
+        int64_t price_raw = static_cast<int64_t>(std::llround(price_f * static_cast<double>(scale)));
+        int64_t qty_lots  = static_cast<int64_t>(std::llround(qty_f * static_cast<double>(qty_scale)));
+        out.emplace_back(price_raw, qty_lots);
     }
     return out;
 }
 
+std::vector<std::pair<int64_t,int64_t>> parseLevels(const Napi::Array& arr, const InstrumentSpec& spec) {
+    return withPriceScale(spec.price_scale, [&arr, &spec](auto s) { return parseLevelsScaled(arr, s, spec.qty_scale); });
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: registerSymbol(name) → symbolId
+// Interns an instrument name; the id is stable for the process lifetime.
+// Every book binding takes this id (or the name) as its first argument.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value RegisterSymbol(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Symbol name expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    SymbolID id = g_symbols.intern(info[0].As<Napi::String>().Utf8Value());
+    if (id == INVALID_SYMBOL) {
+        Napi::RangeError::New(env, "Symbol registry full").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return Napi::Number::New(env, id);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: listSymbols() → [{ id, name }]
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ListSymbols(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    const size_t n = g_symbols.size();
+    auto arr = Napi::Array::New(env, n);
+    for (size_t i = 0; i < n; ++i) {
+        auto sym = Napi::Object::New(env);
+        sym.Set("id",   Napi::Number::New(env, static_cast<double>(i)));
+        sym.Set("name", Napi::String::New(env, g_symbols.name(static_cast<SymbolID>(i))));
+        arr.Set(static_cast<uint32_t>(i), sym);
+    }
+    return arr;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: setInstrument(symbol, { tickSize?, lotSize?, priceScale? })
+//   → { price_scale, tick_size, qty_scale }
+// Integer price / quantity scales are derived from tick and lot size
+// (smallest power of ten making each exact) unless priceScale is given.
+// Scales only grow — live books are re-keyed in place, no reseed needed.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value SetInstrument(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        if (info.Length() < 2 || !info[1].IsObject()) throw std::invalid_argument("Instrument spec expected");
+        auto opts = info[1].As<Napi::Object>();
+
+        auto number = [&opts](const char* key) {
+            auto v = opts.Get(key);
+            return v.IsNumber() ? v.As<Napi::Number>().DoubleValue() : 0.0;
+        };
+        const double tick = number("tickSize");
+        const double lot  = number("lotSize");
+        if (tick < 0 || lot < 0) throw std::invalid_argument("Tick and lot size must be positive");
+
+        InstrumentSpec spec = book.aggregator.spec();
+        const InstrumentSpec derived = InstrumentSpec::fromTick(tick, lot);
+        if (tick > 0) {
+            spec.price_scale = derived.price_scale;
+            spec.tick_raw    = derived.tick_raw;
+        }
+        if (lot > 0) spec.qty_scale = derived.qty_scale;
+
+        const double scale = number("priceScale");
+        if (scale != 0) {
+            if (scale < 1 || scale > static_cast<double>(MAX_PRICE_SCALE)) throw std::invalid_argument("Invalid price scale");
+            spec.price_scale = static_cast<int64_t>(scale);
+            if (tick > 0) spec.tick_raw = std::max<int64_t>(1, spec.toRaw(tick));
+        }
+        book.aggregator.setSpec(spec);
+
+        const auto applied = book.aggregator.spec();
+        auto obj = Napi::Object::New(env);
+        obj.Set("price_scale", Napi::Number::New(env, static_cast<double>(applied.price_scale)));
+        obj.Set("tick_size",   Napi::Number::New(env, applied.tickSize()));
+        obj.Set("qty_scale",   Napi::Number::New(env, static_cast<double>(applied.qty_scale)));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Null();
+}
+
+// ── Sequence gaps → JS resync callback ──────────────────────────
+static const char* SEQ_STATUS_NAMES[] = { "applied", "stale", "buffered", "gap", "checksum" };
+
+// Optional venue checksum argument (signed int32 CRC32)
+std::optional<int32_t> parseChecksum(const Napi::Value& val) {
+    if (!val.IsNumber()) return std::nullopt;
+    return static_cast<int32_t>(val.As<Napi::Number>().Int64Value());
+}
+
+void notifyResync(Napi::Env env, const SymbolBook& book, ExchangeID ex) {
+    if (g_on_resync.IsEmpty()) return;
+    g_on_resync.Call({
+        Napi::String::New(env, g_symbols.name(book.id)),
+        Napi::String::New(env, EXCHANGE_NAMES[static_cast<size_t>(ex)])
+    });
+}
+
+// ── BBO crosses / deviations → JS callback ──────────────────────
+static const char* BBO_EVENT_NAMES[] = { "cross", "cross_end", "deviation", "deviation_end" };
+
+Napi::Object bboEventToJs(Napi::Env env, const BboEvent& e) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("type", Napi::String::New(env, BBO_EVENT_NAMES[static_cast<size_t>(e.kind)]));
+    if (e.kind == BboEventKind::CROSS || e.kind == BboEventKind::CROSS_END) {
+        obj.Set("buy",  Napi::String::New(env, EXCHANGE_NAMES[e.buy]));
+        obj.Set("sell", Napi::String::New(env, EXCHANGE_NAMES[e.sell]));
+        obj.Set("ask",  Napi::Number::New(env, e.buy_px));
+        obj.Set("bid",  Napi::Number::New(env, e.sell_px));
+        obj.Set("qty",  Napi::Number::New(env, e.qty));
+    } else {
+        obj.Set("exchange", Napi::String::New(env, EXCHANGE_NAMES[e.buy]));
+        obj.Set("mid",      Napi::Number::New(env, e.buy_px));
+        obj.Set("consolidatedMid", Napi::Number::New(env, e.sell_px));
+    }
+    obj.Set("ts",      Napi::Number::New(env, static_cast<double>(e.ts_ms)));
+    obj.Set("since",   Napi::Number::New(env, static_cast<double>(e.since_ms)));
+    obj.Set("bps",     Napi::Number::New(env, e.bps));
+    obj.Set("peakBps", Napi::Number::New(env, e.peak_bps));
+    return obj;
+}
+
+// Hands the events queued by the update just applied to the callback,
+// before the binding returns; dropped when none is registered
+void notifyBbo(Napi::Env env, SymbolBook& book) {
+    static std::vector<BboEvent> events;
+    if (book.aggregator.takeBboEvents(events) == 0 || g_on_bbo.IsEmpty()) return;
+    auto arr = Napi::Array::New(env, events.size());
+    for (size_t k = 0; k < events.size(); ++k) arr.Set(static_cast<uint32_t>(k), bboEventToJs(env, events[k]));
+    g_on_bbo.Call({ Napi::String::New(env, g_symbols.name(book.id)), arr });
+}
+
 // ─────────────────────────────────────────────────────────────────
-// BINDING: initSnapshot(exchange, updateId, bids, asks)
-// Called once per exchange on REST snapshot load
-// JS: core.initSnapshot('binance', 12345678, [['63500.50','1.23'],...], [...])
+// BINDING: initSnapshot(symbol, exchange, updateId, bids, asks, checksum?)
+// Called once per exchange on REST snapshot load. Deltas buffered by
+// applySequencedDelta are replayed on top → 'applied', or 'gap' /
+// 'checksum' (and the resync callback fires again) if they don't
+// connect to it.
+// JS: core.initSnapshot(btcId, 'binance', 12345678, [['63500.50','1.23'],...], [...])
 // ─────────────────────────────────────────────────────────────────
 Napi::Value InitSnapshot(const Napi::CallbackInfo& info) {
     auto env = info.Env();
     try {
-        if (info.Length() < 3) throw std::invalid_argument("Too few arguments");
-        
-        auto ex        = parseExchange(info[0]);
+        if (info.Length() < 4) throw std::invalid_argument("Too few arguments");
+
+        auto& book     = parseSymbol(info[0]);
+        auto ex        = parseExchange(info[1]);
         if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
+        const InstrumentSpec spec = book.aggregator.spec();
 
-        // Handle case where 3 args (ex, bids, asks) or 4 args (ex, updateId, bids, asks)
-        if (info.Length() == 3) {
-            auto bids = parseLevels(info[1].As<Napi::Array>());
-            auto asks = parseLevels(info[2].As<Napi::Array>());
-            g_aggregator.initSnapshot(ex, 0, bids, asks);
+        // Handle case where 4 args (sym, ex, bids, asks) or 5 args (sym, ex, updateId, bids, asks)
+        if (info.Length() == 4) {
+            auto bids = parseLevels(info[2].As<Napi::Array>(), spec);
+            auto asks = parseLevels(info[3].As<Napi::Array>(), spec);
+            book.aggregator.initSnapshot(ex, 0, bids, asks);
+            notifyBbo(env, book);
         } else {
-            uint64_t uid   = info[1].As<Napi::Number>().Int64Value();
-            auto bids      = parseLevels(info[2].As<Napi::Array>());
-            auto asks      = parseLevels(info[3].As<Napi::Array>());
-            g_aggregator.initSnapshot(ex, uid, bids, asks);
+            uint64_t uid   = info[2].As<Napi::Number>().Int64Value();
+            auto bids      = parseLevels(info[3].As<Napi::Array>(), spec);
+            auto asks      = parseLevels(info[4].As<Napi::Array>(), spec);
+            auto checksum  = info.Length() > 5 ? parseChecksum(info[5]) : std::nullopt;
+            const SeqStatus status = book.aggregator.initSnapshot(ex, uid, bids, asks, checksum);
+            notifyBbo(env, book);
+            if (needsResync(status)) notifyResync(env, book, ex);
+            return Napi::String::New(env, SEQ_STATUS_NAMES[static_cast<size_t>(status)]);
         }
+        return Napi::String::New(env, SEQ_STATUS_NAMES[static_cast<size_t>(SeqStatus::APPLIED)]);
     } catch (const std::exception& e) {
         Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
     }
@@ -128,31 +332,34 @@ Napi::Value InitSnapshot(const Napi::CallbackInfo& info) {
 }
 
 // ─────────────────────────────────────────────────────────────────
-// BINDING: applyDelta(exchange, updateId, bidDeltas, askDeltas)
+// BINDING: applyDelta(symbol, exchange, updateId, bidDeltas, askDeltas)
 // Called on every WS depth update — the hot path
-// JS: core.applyDelta('bybit', 12345679, [['63500.50','0'],...], [...])
+// JS: core.applyDelta(btcId, 'bybit', 12345679, [['63500.50','0'],...], [...])
 // ─────────────────────────────────────────────────────────────────
 Napi::Value ApplyDelta(const Napi::CallbackInfo& info) {
     auto env = info.Env();
     try {
-        if (info.Length() < 3) throw std::invalid_argument("Too few arguments");
-        
-        auto ex = parseExchange(info[0]);
+        if (info.Length() < 4) throw std::invalid_argument("Too few arguments");
+
+        auto& book = parseSymbol(info[0]);
+        auto ex = parseExchange(info[1]);
         if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
+        const InstrumentSpec spec = book.aggregator.spec();
 
-        // Handle case where 3 args (ex, bids, asks) or 4 args (ex, updateId, bids, asks)
-        if (info.Length() == 3 || (info.Length() == 4 && info[3].IsBoolean())) {
-            auto bids = parseLevels(info[1].As<Napi::Array>());
-            auto asks = parseLevels(info[2].As<Napi::Array>());
-            bool is_snap = info.Length() == 4 ? info[3].As<Napi::Boolean>().Value() : false;
-            g_aggregator.applyDelta(ex, 0, bids, asks, is_snap);
-        } else {
-            uint64_t uid = info[1].As<Napi::Number>().Int64Value();
-            auto bids    = parseLevels(info[2].As<Napi::Array>());
-            auto asks    = parseLevels(info[3].As<Napi::Array>());
+        // Handle case where 4 args (sym, ex, bids, asks) or 5 args (sym, ex, updateId, bids, asks)
+        if (info.Length() == 4 || (info.Length() == 5 && info[4].IsBoolean())) {
+            auto bids = parseLevels(info[2].As<Napi::Array>(), spec);
+            auto asks = parseLevels(info[3].As<Napi::Array>(), spec);
             bool is_snap = info.Length() == 5 ? info[4].As<Napi::Boolean>().Value() : false;
-            g_aggregator.applyDelta(ex, uid, bids, asks, is_snap);
+            book.aggregator.applyDelta(ex, 0, bids, asks, is_snap);
+        } else {
+            uint64_t uid = info[2].As<Napi::Number>().Int64Value();
+            auto bids    = parseLevels(info[3].As<Napi::Array>(), spec);
+            auto asks    = parseLevels(info[4].As<Napi::Array>(), spec);
+            bool is_snap = info.Length() == 6 ? info[5].As<Napi::Boolean>().Value() : false;
+            book.aggregator.applyDelta(ex, uid, bids, asks, is_snap);
         }
+        notifyBbo(env, book);
     } catch (const std::exception& e) {
         Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
     }
@@ -160,44 +367,158 @@ Napi::Value ApplyDelta(const Napi::CallbackInfo& info) {
 }
 
 // ─────────────────────────────────────────────────────────────────
-// BINDING: getAggregated(levels?) → JS object
-// Called from broadcast timer — returns merged book as V8 object
+// BINDING: applySequencedDelta(symbol, exchange, { first?, last?, prev?, checksum? }, bids, asks)
+//   → 'applied' | 'stale' | 'buffered' | 'gap' | 'checksum'
+// Venue ids: Binance { first: U, last: u, prev: pu }, Bybit { last: u },
+// OKX { last: seqId, prev: prevSeqId, checksum }, Bitget { checksum }.
+// On 'gap' / 'checksum' the resync callback is called; later deltas are
+// buffered until initSnapshot replays them.
 // ─────────────────────────────────────────────────────────────────
-Napi::Value GetAggregated(const Napi::CallbackInfo& info) {
-    auto env    = info.Env();
-    size_t levels = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : OUTPUT_LEVELS;
+Napi::Value ApplySequencedDelta(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 5 || !info[2].IsObject()) throw std::invalid_argument("Too few arguments");
 
-    const auto snap = g_aggregator.getAggregated(levels);
+        auto& book = parseSymbol(info[0]);
+        auto ex = parseExchange(info[1]);
+        if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
 
-    // Build JS object: { bids, asks, walls, best_bid, best_ask, spread, mid_price, ts }
-    auto obj = Napi::Object::New(env);
-    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(snap.timestamp_ms)));
-    obj.Set("best_bid",  Napi::Number::New(env, snap.best_bid));
-    obj.Set("best_ask",  Napi::Number::New(env, snap.best_ask));
-    obj.Set("spread",    Napi::Number::New(env, snap.spread));
-    obj.Set("mid_price", Napi::Number::New(env, snap.mid_price));
+        auto ids = info[2].As<Napi::Object>();
+        auto id = [&ids](const char* key) -> uint64_t {
+            auto v = ids.Get(key);
+            const double d = v.IsNumber() ? v.As<Napi::Number>().DoubleValue() : 0;
+            return d > 0 ? static_cast<uint64_t>(d) : 0;   // OKX snapshot prevSeqId is -1
+        };
+        const DeltaSeq seq{ id("first"), id("last"), id("prev"), parseChecksum(ids.Get("checksum")) };
 
-    // Bids array
-    auto bids_arr = Napi::Array::New(env, snap.bid_count);
-    for (size_t i = 0; i < snap.bid_count; ++i) {
-        auto level = Napi::Object::New(env);
-        level.Set("price", Napi::Number::New(env, snap.bids[i].price_f()));
-        level.Set("qty",   Napi::Number::New(env, snap.bids[i].qty));
-        bids_arr.Set(static_cast<uint32_t>(i), level);
+        const InstrumentSpec spec = book.aggregator.spec();
+        auto bids = parseLevels(info[3].As<Napi::Array>(), spec);
+        auto asks = parseLevels(info[4].As<Napi::Array>(), spec);
+
+        const SeqStatus status = book.aggregator.applySequenced(ex, seq, bids, asks);
+        notifyBbo(env, book);
+        if (needsResync(status)) notifyResync(env, book, ex);
+        return Napi::String::New(env, SEQ_STATUS_NAMES[static_cast<size_t>(status)]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
     }
-    obj.Set("bids", bids_arr);
+    return env.Undefined();
+}
 
-    // Asks array
-    auto asks_arr = Napi::Array::New(env, snap.ask_count);
-    for (size_t i = 0; i < snap.ask_count; ++i) {
-        auto level = Napi::Object::New(env);
-        level.Set("price", Napi::Number::New(env, snap.asks[i].price_f()));
-        level.Set("qty",   Napi::Number::New(env, snap.asks[i].qty));
-        asks_arr.Set(static_cast<uint32_t>(i), level);
+// ─────────────────────────────────────────────────────────────────
+// BINDING: onResync(fn) — fn(symbol, exchange) when a sequence gap
+// needs a fresh snapshot for that book. Pass null to unregister.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value OnResync(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() > 0 && info[0].IsFunction()) {
+        g_on_resync = Napi::Persistent(info[0].As<Napi::Function>());
+    } else {
+        g_on_resync.Reset();
     }
-    obj.Set("asks", asks_arr);
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: onBboEvent(fn) — fn(symbol, events) right after an update
+// opens or closes a cross-venue cross or a BBO deviation (see
+// getBbo). Pass null to unregister.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value OnBboEvent(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() > 0 && info[0].IsFunction()) {
+        g_on_bbo = Napi::Persistent(info[0].As<Napi::Function>());
+    } else {
+        g_on_bbo.Reset();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getSyncState(symbol) → [{ exchange, last_id, resyncing, pending }]
+// Sequence-tracked exchanges only
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetSyncState(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto arr = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (size_t i = 0; i < N_EXCHANGES; ++i) {
+        const auto st = book->aggregator.syncState(static_cast<ExchangeID>(i));
+        if (st.mode == SeqMode::NONE) continue;
+        auto obj = Napi::Object::New(env);
+        obj.Set("exchange",  Napi::String::New(env, EXCHANGE_NAMES[i]));
+        obj.Set("last_id",   Napi::Number::New(env, static_cast<double>(st.last_id)));
+        obj.Set("resyncing", Napi::Boolean::New(env, st.resyncing));
+        obj.Set("pending",   Napi::Number::New(env, static_cast<double>(st.pending)));
+        arr.Set(count++, obj);
+    }
+    return arr;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: setChecksumVerify(symbol, exchange, enabled)
+// Check the venue's top-25 CRC32 natively after every delta that
+// carries one (OKX, Bitget); a mismatch flags desync and resyncs.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value SetChecksumVerify(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        auto ex = parseExchange(info[1]);
+        if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
+        const bool enabled = info.Length() < 3 || info[2].As<Napi::Boolean>().Value();
+        book.aggregator.setChecksumVerify(ex, enabled);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getChecksumState(symbol)
+//   → [{ exchange, enabled, unsupported, checked, mismatches, last_ok, avg_ns, max_ns }]
+// Exchanges that have verification on, or had it switched off because a
+// snapshot didn't match (unsupported number format).
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetChecksumState(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto arr = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (size_t i = 0; i < N_EXCHANGES; ++i) {
+        const auto cs = book->aggregator.checksumState(static_cast<ExchangeID>(i));
+        if (!cs.enabled && !cs.unsupported) continue;
+        auto obj = Napi::Object::New(env);
+        obj.Set("exchange",    Napi::String::New(env, EXCHANGE_NAMES[i]));
+        obj.Set("enabled",     Napi::Boolean::New(env, cs.enabled));
+        obj.Set("unsupported", Napi::Boolean::New(env, cs.unsupported));
+        obj.Set("checked",     Napi::Number::New(env, static_cast<double>(cs.checked)));
+        obj.Set("mismatches",  Napi::Number::New(env, static_cast<double>(cs.mismatches)));
+        obj.Set("last_ok",     Napi::Boolean::New(env, cs.last_ok));
+        obj.Set("avg_ns",      Napi::Number::New(env, cs.checked ? static_cast<double>(cs.total_ns) / cs.checked : 0.0));
+        obj.Set("max_ns",      Napi::Number::New(env, static_cast<double>(cs.max_ns)));
+        arr.Set(count++, obj);
+    }
+    return arr;
+}
 
-    // Walls
+// ── Helper: snapshot walls → { bid_walls, ask_walls } ─────────────
+Napi::Object wallsToJs(Napi::Env env, const AggregatedSnapshot& snap) {
     auto walls = Napi::Object::New(env);
 
     auto bid_walls = Napi::Array::New(env, snap.bid_wall_count);
@@ -220,114 +541,1640 @@ Napi::Value GetAggregated(const Napi::CallbackInfo& info) {
     }
     walls.Set("ask_walls", ask_walls);
 
-    obj.Set("walls", walls);
+    return walls;
+}
+
+// ── Helper: AggregatedSnapshot → JS object ──────────────────────
+// { timestamp, best_bid, best_ask, spread, mid_price, bids, asks, walls }
+Napi::Object snapshotToJs(Napi::Env env, const AggregatedSnapshot& snap) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(snap.timestamp_ms)));
+    obj.Set("best_bid",  Napi::Number::New(env, snap.best_bid));
+    obj.Set("best_ask",  Napi::Number::New(env, snap.best_ask));
+    obj.Set("spread",    Napi::Number::New(env, snap.spread));
+    obj.Set("mid_price", Napi::Number::New(env, snap.mid_price));
+
+    // Bids array
+    auto bids_arr = Napi::Array::New(env, snap.bid_count);
+    for (size_t i = 0; i < snap.bid_count; ++i) {
+        auto level = Napi::Object::New(env);
+        level.Set("price", Napi::Number::New(env, snap.bids[i].price_f(snap.price_scale)));
+        level.Set("qty",   Napi::Number::New(env, snap.bids[i].qty_f(snap.qty_scale)));
+        bids_arr.Set(static_cast<uint32_t>(i), level);
+    }
+    obj.Set("bids", bids_arr);
+
+    // Asks array
+    auto asks_arr = Napi::Array::New(env, snap.ask_count);
+    for (size_t i = 0; i < snap.ask_count; ++i) {
+        auto level = Napi::Object::New(env);
+        level.Set("price", Napi::Number::New(env, snap.asks[i].price_f(snap.price_scale)));
+        level.Set("qty",   Napi::Number::New(env, snap.asks[i].qty_f(snap.qty_scale)));
+        asks_arr.Set(static_cast<uint32_t>(i), level);
+    }
+    obj.Set("asks", asks_arr);
+
+    obj.Set("walls", wallsToJs(env, snap));
     return obj;
 }
 
 // ─────────────────────────────────────────────────────────────────
-// BINDING: updateFunding(exchange, rate, oi_usd)
-// Called every ~60s from Binance/Bybit/OKX funding pollers
+// BINDING: getAggregated(symbol, levels?) → JS object
+// Called from broadcast timer — returns merged book as V8 object
 // ─────────────────────────────────────────────────────────────────
-Napi::Value UpdateFunding(const Napi::CallbackInfo& info) {
-    auto env = info.Env();
+Napi::Value GetAggregated(const Napi::CallbackInfo& info) {
+    auto env    = info.Env();
     try {
-        auto ex     = parseExchange(info[0]);
-        if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
-        
-        double rate = info[1].As<Napi::Number>().DoubleValue();
-        double oi   = info[2].As<Napi::Number>().DoubleValue();
-        g_vwaf.updateFunding(ex, rate, oi, 
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count());
+        auto& book    = parseSymbol(info[0]);
+        size_t levels = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : OUTPUT_LEVELS;
+        levels = std::min(levels, OUTPUT_LEVELS);
+
+        return snapshotToJs(env, book.aggregator.getAggregated(levels));
     } catch (const std::exception& e) {
         Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
     }
-    return env.Undefined();
+    return env.Null();
 }
 
 // ─────────────────────────────────────────────────────────────────
-// BINDING: getVWAF() → JS object with full VWAF computation
+// BINDING: getAggregatedIfNewer(symbol, sinceVersion) → JS object | null
+// Version-gated read through the StateMirror. Returns null when the book
+// has not changed since `sinceVersion`, so the broadcast timer skips both
+// the merge and the V8 serialization. Result carries `version`.
 // ─────────────────────────────────────────────────────────────────
-Napi::Value GetVWAF(const Napi::CallbackInfo& info) {
+Napi::Value GetAggregatedIfNewer(const Napi::CallbackInfo& info) {
     auto env = info.Env();
-    const auto r = g_vwaf.compute();
-
-    static const char* EXCHANGE_NAMES[] = {
-        "binance","bybit","okx","hyperliquid","gate","mexc","bitget"
-    };
-    static const char* SENTIMENT_LABELS[] = {
-        "extremely_short","short_heavy","neutral","long_heavy","extremely_long"
-    };
-    constexpr size_t N_EX = static_cast<size_t>(ExchangeID::MAX_EXCHANGES);
-
-    auto obj = Napi::Object::New(env);
-    obj.Set("vwaf",        Napi::Number::New(env, r.vwaf));
-    obj.Set("annualized",  Napi::Number::New(env, r.annualized));
-    obj.Set("divergence",  Napi::Number::New(env, r.divergence));
-    obj.Set("total_oi_usd",Napi::Number::New(env, r.total_oi_usd));
-    
-    // Bounds check for sentiment array lookup (sentiment is typically -2 to +2, meaning indices 0 to 4 after adding 2)
-    int sIndex = r.sentiment + 2;
-    if (sIndex < 0) sIndex = 0;
-    if (sIndex > 4) sIndex = 4;
-    obj.Set("sentiment",   Napi::String::New(env, SENTIMENT_LABELS[sIndex]));
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    uint64_t since = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
 
-    auto by_ex = Napi::Array::New(env);
-    uint32_t count = 0;
-    for (size_t i = 0; i < N_EX; ++i) {
-        if (!r.active[i]) continue;
-        auto ex_obj = Napi::Object::New(env);
-        ex_obj.Set("exchange", Napi::String::New(env, EXCHANGE_NAMES[i]));
-        ex_obj.Set("rate",     Napi::Number::New(env, r.rates[i]));
-        ex_obj.Set("oi_usd",   Napi::Number::New(env, r.oi_usd[i]));
-        ex_obj.Set("weight",   Napi::Number::New(env, r.weights[i]));
-        by_ex.Set(count++, ex_obj);
+    // WS deltas land on this thread, so publish here when the book moved
+    // or an exchange dropped in/out of the merge by going stale.
+    auto& agg = book->aggregator;
+    uint8_t active = agg.activeMask();
+    if (agg.isDirty() || active != book->last_active) {
+        agg.clearDirty();
+        book->last_active = active;
+        book->mirror.update(agg.getAggregated());
     }
-    obj.Set("by_exchange", by_ex);
 
+    uint64_t version = 0;
+    const AggregatedSnapshot* snap = book->mirror.readIfNewer(since, version);
+    if (!snap) return env.Null();
+
+    auto obj = snapshotToJs(env, *snap);
+    obj.Set("version", Napi::Number::New(env, static_cast<double>(version)));
     return obj;
 }
 
 // ─────────────────────────────────────────────────────────────────
-// BINDING: clearExchange(exchange)
-// Called when an exchange adapter disconnects
+// BINDING: getAggregatedDiff(symbol, sinceVersion) → JS object | null
+// Consolidated levels changed since `sinceVersion` as [price, qty] pairs,
+// qty 0 = removed. `full: true` means bids/asks are the whole book and
+// must replace, not patch (first call, or client too far behind).
+// `walls` present only when they changed. null when nothing changed.
 // ─────────────────────────────────────────────────────────────────
-Napi::Value ClearExchange(const Napi::CallbackInfo& info) {
+Napi::Value GetAggregatedDiff(const Napi::CallbackInfo& info) {
     auto env = info.Env();
+    SymbolBook* book = nullptr;
     try {
-        auto ex = parseExchange(info[0]);
-        if (ex != ExchangeID::MAX_EXCHANGES) {
-            g_aggregator.clearExchange(ex);
-        }
+        book = &parseSymbol(info[0]);
     } catch (const std::exception& e) {
         Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
     }
-    return env.Undefined();
+    uint64_t since = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
+
+    const auto diff = book->aggregator.getAggregatedDiff(since);
+    book->aggregator.clearDirty();   // tracker has folded in every write so far
+    if (!diff.full && diff.version == since) return env.Null();
+
+    // Keep the mirror (and shm segment, if enabled) in step with broadcasts
+    if (diff.version != book->mirrored_version) {
+        book->mirrored_version = diff.version;
+        book->mirror.update(diff.snap);
+    }
+
+    const auto& snap = diff.snap;
+    auto obj = Napi::Object::New(env);
+    obj.Set("version",   Napi::Number::New(env, static_cast<double>(diff.version)));
+    obj.Set("from",      Napi::Number::New(env, static_cast<double>(diff.from_version)));
+    obj.Set("full",      Napi::Boolean::New(env, diff.full));
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(snap.timestamp_ms)));
+    obj.Set("best_bid",  Napi::Number::New(env, snap.best_bid));
+    obj.Set("best_ask",  Napi::Number::New(env, snap.best_ask));
+    obj.Set("spread",    Napi::Number::New(env, snap.spread));
+    obj.Set("mid_price", Napi::Number::New(env, snap.mid_price));
+
+    auto toPairs = [&env, &snap](const std::vector<LevelChange>& changes) {
+        auto arr = Napi::Array::New(env, changes.size());
+        for (size_t i = 0; i < changes.size(); ++i) {
+            auto pair = Napi::Array::New(env, 2);
+            pair.Set(static_cast<uint32_t>(0), Napi::Number::New(env, changes[i].price_f(snap.price_scale)));
+            pair.Set(static_cast<uint32_t>(1), Napi::Number::New(env, changes[i].qty_f(snap.qty_scale)));
+            arr.Set(static_cast<uint32_t>(i), pair);
+        }
+        return arr;
+    };
+    obj.Set("bids", toPairs(diff.bids));
+    obj.Set("asks", toPairs(diff.asks));
+
+    if (diff.walls_changed) obj.Set("walls", wallsToJs(env, snap));
+    return obj;
 }
 
-// ── BINDING: kalman1D(typedArray, R, Q) ───────────────────────────────────
-Napi::Value Kalman1D(const Napi::CallbackInfo& info) {
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getBucketedDepth(symbol, steps?, bucketsPerSide?) → JS object
+// Consolidated depth from the full per-exchange books, grouped at every
+// step (quote units, default 10/100/500/1000 ticks) in one native pass:
+// { best_bid, best_ask, resolutions: [{ step, bid_start, ask_start,
+//   bids: Float64Array, asks: Float64Array }] }
+// Bid bucket j sits at bid_start - j*step, ask bucket j at ask_start + j*step.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetBucketedDepth(const Napi::CallbackInfo& info) {
     auto env = info.Env();
-    if (!info[0].IsTypedArray()) {
-        Napi::TypeError::New(env, "TypedArray expected").ThrowAsJavaScriptException();
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
         return env.Null();
     }
 
-    auto input = info[0].As<Napi::Float64Array>();
-    double R = info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : 0.1;
-    double Q = info[2].IsNumber() ? info[2].As<Napi::Number>().DoubleValue() : 0.001;
+    double steps[MAX_DEPTH_RESOLUTIONS];
+    size_t n_res = 0;
+    const bool custom_steps = info.Length() > 1 && info[1].IsArray();
+    if (custom_steps) {
+        auto arr = info[1].As<Napi::Array>();
+        n_res = std::min<size_t>(arr.Length(), MAX_DEPTH_RESOLUTIONS);
+        for (size_t r = 0; r < n_res; ++r) {
+            steps[r] = arr.Get(static_cast<uint32_t>(r)).As<Napi::Number>().DoubleValue();
+        }
+    }
+    size_t buckets = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value() : 200;
+    buckets = std::min<size_t>(buckets, 10000);
 
-    size_t len = input.ElementLength();
-    if (len == 0) return Napi::Array::New(env, 0);
+    static BucketedDepth depth;   // reused — vectors keep their capacity
+    book->aggregator.getBucketedDepth(custom_steps ? steps : nullptr, n_res, buckets, depth);
+    n_res = depth.resolutions;
+    const double scale = static_cast<double>(depth.price_scale);
 
-    auto result = Napi::Float64Array::New(env, len);
-    double x = input[0];
-    double P = 1.0;
+    auto obj = Napi::Object::New(env);
+    obj.Set("best_bid", Napi::Number::New(env, static_cast<double>(depth.best_bid_raw) / scale));
+    obj.Set("best_ask", Napi::Number::New(env, static_cast<double>(depth.best_ask_raw) / scale));
 
-    for (size_t i = 0; i < len; i++) {
-        P = P + Q;
-        double K = P / (P + R);
-        x = x + K * (input[i] - x);
+    auto res_arr = Napi::Array::New(env, n_res);
+    for (size_t r = 0; r < n_res; ++r) {
+        auto bids = Napi::Float64Array::New(env, buckets);
+        auto asks = Napi::Float64Array::New(env, buckets);
+        const double lot = 1.0 / static_cast<double>(depth.qty_scale);
+        for (size_t j = 0; j < buckets; ++j) {
+            bids[j] = static_cast<double>(depth.bid_qty[r * buckets + j]) * lot;
+            asks[j] = static_cast<double>(depth.ask_qty[r * buckets + j]) * lot;
+        }
+
+        auto res = Napi::Object::New(env);
+        res.Set("step",      Napi::Number::New(env, static_cast<double>(depth.step_raw[r]) / scale));
+        res.Set("bid_start", Napi::Number::New(env, static_cast<double>(depth.bid_start_raw[r]) / scale));
+        res.Set("ask_start", Napi::Number::New(env, static_cast<double>(depth.ask_start_raw[r]) / scale));
+        res.Set("bids", bids);
+        res.Set("asks", asks);
+        res_arr.Set(static_cast<uint32_t>(r), res);
+    }
+    obj.Set("resolutions", res_arr);
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getCumulativeDepth(symbol, levels?) → JS object
+// Depth-chart series for the consolidated top `levels` per side:
+// { bid_prices, bid_cum, ask_prices, ask_cum } as Float64Arrays, where
+// *_cum[i] is the total size from the touch through level i (exact lot
+// sums, AVX2 where available).
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetCumulativeDepth(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    size_t levels = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : OUTPUT_LEVELS;
+    levels = std::min(levels, OUTPUT_LEVELS);
+
+    const AggregatedSnapshot snap = book->aggregator.getAggregated(levels);
+    int64_t cum[OUTPUT_LEVELS];
+
+    auto side = [&env, &snap, &cum](const Level* lv, size_t n, Napi::Float64Array& prices, Napi::Float64Array& totals) {
+        SimdDepth::cumulativeQty(lv, n, cum);
+        prices = Napi::Float64Array::New(env, n);
+        totals = Napi::Float64Array::New(env, n);
+        for (size_t i = 0; i < n; ++i) {
+            prices[i] = lv[i].price_f(snap.price_scale);
+            totals[i] = static_cast<double>(cum[i]) / snap.qty_scale;
+        }
+    };
+
+    Napi::Float64Array bid_prices, bid_cum, ask_prices, ask_cum;
+    side(snap.bids, snap.bid_count, bid_prices, bid_cum);
+    side(snap.asks, snap.ask_count, ask_prices, ask_cum);
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("bid_prices", bid_prices);
+    obj.Set("bid_cum",    bid_cum);
+    obj.Set("ask_prices", ask_prices);
+    obj.Set("ask_cum",    ask_cum);
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: setDepthBands(symbol, [bps, ...])
+// Distances from the touch the running band depth is kept for,
+// e.g. [10, 50, 100, 200] = within 0.1% / 0.5% / 1% / 2%. Max 8.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value SetDepthBands(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        if (info.Length() < 2 || !info[1].IsArray()) throw std::invalid_argument("Band array expected");
+        auto arr = info[1].As<Napi::Array>();
+
+        DepthBands bands;
+        bands.count = std::min<size_t>(arr.Length(), MAX_DEPTH_BANDS);
+        for (size_t k = 0; k < bands.count; ++k) {
+            Napi::Value v = arr.Get(static_cast<uint32_t>(k));
+            const double bps = v.IsNumber() ? v.As<Napi::Number>().DoubleValue() : -1;
+            if (bps < 0 || bps > 10000) throw std::invalid_argument("Band must be 0..10000 bps");
+            bands.bps[k] = static_cast<int32_t>(bps);
+        }
+        book.aggregator.setDepthBands(bands);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getDepthStats(symbol) → JS object
+// Running depth kept on every delta — free to poll at any rate:
+// { bands_bps, bid: { total, notional, bands }, ask: {...},
+//   by_exchange: [{ exchange, bid, ask }] } for fresh exchanges.
+// total/bands are base units, notional is quote; bands[k] is the size
+// within bands_bps[k] of the touch.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetDepthStats(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    SymbolBook* book = nullptr;
+    try {
+        book = &parseSymbol(info[0]);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    DepthSummary d;
+    book->aggregator.getDepthStats(d);
+    const double qty_scale      = static_cast<double>(d.qty_scale);
+    const double notional_scale = qty_scale * static_cast<double>(d.price_scale);
+
+    auto side = [&env, &d, qty_scale, notional_scale](const DepthStats& s) {
+        auto obj = Napi::Object::New(env);
+        obj.Set("total",    Napi::Number::New(env, static_cast<double>(s.total_lots) / qty_scale));
+        obj.Set("notional", Napi::Number::New(env, s.notional_raw / notional_scale));
+        auto bands = Napi::Array::New(env, d.bands.count);
+        for (size_t k = 0; k < d.bands.count; ++k) {
+            bands.Set(static_cast<uint32_t>(k), Napi::Number::New(env, static_cast<double>(s.band_lots[k]) / qty_scale));
+        }
+        obj.Set("bands", bands);
+        return obj;
+    };
+
+    auto obj = Napi::Object::New(env);
+    auto bps = Napi::Array::New(env, d.bands.count);
+    for (size_t k = 0; k < d.bands.count; ++k) bps.Set(static_cast<uint32_t>(k), Napi::Number::New(env, d.bands.bps[k]));
+    obj.Set("bands_bps", bps);
+    obj.Set("bid", side(d.bids));
+    obj.Set("ask", side(d.asks));
+
+    auto by_ex = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (size_t i = 0; i < N_EXCHANGES; ++i) {
+        if (!(d.active & (1u << i))) continue;
+        auto ex_obj = Napi::Object::New(env);
+        ex_obj.Set("exchange", Napi::String::New(env, EXCHANGE_NAMES[i]));
+        ex_obj.Set("bid", side(d.ex_bids[i]));
+        ex_obj.Set("ask", side(d.ex_asks[i]));
+        by_ex.Set(count++, ex_obj);
+    }
+    obj.Set("by_exchange", by_ex);
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: enableSharedMirror(symbol, name) → bool
+// Ingest process: also publish every mirror update of `symbol` into
+// POSIX shm `name` (one segment per symbol)
+// ─────────────────────────────────────────────────────────────────
+Napi::Value EnableSharedMirror(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        if (info.Length() < 2 || !info[1].IsString()) throw std::invalid_argument("Segment name expected");
+        return Napi::Boolean::New(env, book.mirror.enableShared(info[1].As<Napi::String>().Utf8Value()));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Null();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: attachSharedMirror(name) → readerId | null
+// Fan-out process: map the ingest process's segment read-only. Each
+// segment (one per symbol) gets its own reader; null until the ingest
+// process has created it.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value AttachSharedMirror(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Segment name expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    auto reader = std::make_unique<SharedMirrorReader>();
+    if (!reader->attach(info[0].As<Napi::String>().Utf8Value())) return env.Null();
+    const uint32_t id = g_next_shared_reader++;
+    g_shared_readers.emplace(id, std::move(reader));
+    return Napi::Number::New(env, id);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: readSharedMirror(readerId, sinceVersion) → JS object | null
+// Same shape as getAggregatedIfNewer, read from the reader's segment
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ReadSharedMirror(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto it = info.Length() > 0 && info[0].IsNumber()
+        ? g_shared_readers.find(info[0].As<Napi::Number>().Uint32Value()) : g_shared_readers.end();
+    if (it == g_shared_readers.end()) {
+        Napi::TypeError::New(env, "Unknown shared mirror reader").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    uint64_t since = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
+
+    static AggregatedSnapshot snap;   // 2KB+ — keep it off the stack
+    uint64_t version = 0;
+    if (!it->second->readIfNewer(since, snap, version)) return env.Null();
+
+    auto obj = snapshotToJs(env, snap);
+    obj.Set("version", Napi::Number::New(env, static_cast<double>(version)));
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: detachSharedMirror(readerId) — unmaps the reader's segment
+// ─────────────────────────────────────────────────────────────────
+Napi::Value DetachSharedMirror(const Napi::CallbackInfo& info) {
+    if (info.Length() > 0 && info[0].IsNumber()) g_shared_readers.erase(info[0].As<Napi::Number>().Uint32Value());
+    return info.Env().Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: updateFunding(exchange, rate, oi_usd)
+// Called every ~60s from Binance/Bybit/OKX funding pollers
+// ─────────────────────────────────────────────────────────────────
+Napi::Value UpdateFunding(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto ex     = parseExchange(info[0]);
+        if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Invalid exchange");
+        
+        double rate = info[1].As<Napi::Number>().DoubleValue();
+        double oi   = info[2].As<Napi::Number>().DoubleValue();
+        g_vwaf.updateFunding(ex, rate, oi, Clock::process().nowMs());
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getVWAF() → JS object with full VWAF computation
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetVWAF(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    const auto r = g_vwaf.compute();
+
+    static const char* SENTIMENT_LABELS[] = {
+        "extremely_short","short_heavy","neutral","long_heavy","extremely_long"
+    };
+    constexpr size_t N_EX = static_cast<size_t>(ExchangeID::MAX_EXCHANGES);
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("vwaf",        Napi::Number::New(env, r.vwaf));
+    obj.Set("annualized",  Napi::Number::New(env, r.annualized));
+    obj.Set("divergence",  Napi::Number::New(env, r.divergence));
+    obj.Set("total_oi_usd",Napi::Number::New(env, r.total_oi_usd));
+    
+    // Bounds check for sentiment array lookup (sentiment is typically -2 to +2, meaning indices 0 to 4 after adding 2)
+    int sIndex = r.sentiment + 2;
+    if (sIndex < 0) sIndex = 0;
+    if (sIndex > 4) sIndex = 4;
+    obj.Set("sentiment",   Napi::String::New(env, SENTIMENT_LABELS[sIndex]));
+
+    auto by_ex = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (size_t i = 0; i < N_EX; ++i) {
+        if (!r.active[i]) continue;
+        auto ex_obj = Napi::Object::New(env);
+        ex_obj.Set("exchange", Napi::String::New(env, EXCHANGE_NAMES[i]));
+        ex_obj.Set("rate",     Napi::Number::New(env, r.rates[i]));
+        ex_obj.Set("oi_usd",   Napi::Number::New(env, r.oi_usd[i]));
+        ex_obj.Set("weight",   Napi::Number::New(env, r.weights[i]));
+        by_ex.Set(count++, ex_obj);
+    }
+    obj.Set("by_exchange", by_ex);
+
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: setClock(mode, startMs?) → now (unix ms)
+// Process clock behind book staleness, snapshot timestamps and VWAF
+// freshness (clock.hpp): 'real' (default), 'coarse' (read once per
+// binding call) or 'simulated' (starts at startMs, moved by advanceClock).
+// ─────────────────────────────────────────────────────────────────
+static const char* CLOCK_MODE_NAMES[] = { "real", "coarse", "simulated" };
+
+Napi::Value SetClock(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1 || !info[0].IsString()) throw std::invalid_argument("Expected clock mode");
+        const std::string name = info[0].As<Napi::String>().Utf8Value();
+
+        size_t mode = std::size(CLOCK_MODE_NAMES);
+        for (size_t m = 0; m < std::size(CLOCK_MODE_NAMES); ++m) {
+            if (name == CLOCK_MODE_NAMES[m]) mode = m;
+        }
+        if (mode == std::size(CLOCK_MODE_NAMES)) throw std::invalid_argument("Unknown clock mode");
+
+        const int64_t start_ms = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : 0;
+        Clock::process().setMode(static_cast<ClockMode>(mode), start_ms);
+        return Napi::Number::New(env, static_cast<double>(Clock::process().nowMs()));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: advanceClock(timestampMs) → now (unix ms)
+// Feeds an event timestamp to a simulated clock; never moves it back.
+// Ignored in the other modes, so callers needn't check.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value AdvanceClock(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        Clock::process().advanceTo(info[0].As<Napi::Number>().Int64Value());
+    }
+    return Napi::Number::New(env, static_cast<double>(Clock::process().nowMs()));
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: openJournal(dir, { segmentMB?, ringMB?, checkpointSec? }) → boolean
+// Starts journaling every symbol's book inputs to mmapped segment files
+// in `dir` (book_journal.hpp). Numbering continues after any segments
+// already there. False if the directory or first segment can't be made
+// (always on Windows).
+// ─────────────────────────────────────────────────────────────────
+Napi::Value OpenJournal(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1 || !info[0].IsString()) throw std::invalid_argument("Expected journal directory");
+
+        JournalOptions opts;
+        opts.dir = info[0].As<Napi::String>().Utf8Value();
+        if (info.Length() > 1 && info[1].IsObject()) {
+            auto o = info[1].As<Napi::Object>();
+            auto num = [&o](const char* key, double fallback) {
+                auto v = o.Get(key);
+                return v.IsNumber() && v.As<Napi::Number>().DoubleValue() > 0 ? v.As<Napi::Number>().DoubleValue() : fallback;
+            };
+            opts.segment_bytes = static_cast<size_t>(num("segmentMB", static_cast<double>(opts.segment_bytes >> 20))) << 20;
+            opts.ring_bytes    = static_cast<size_t>(num("ringMB",    static_cast<double>(opts.ring_bytes >> 20))) << 20;
+            opts.checkpoint_ms = static_cast<int64_t>(num("checkpointSec", opts.checkpoint_ms / 1000.0) * 1000.0);
+        }
+
+        g_symbols.setJournal(nullptr);
+        if (!g_journal.open(opts)) return Napi::Boolean::New(env, false);
+        g_symbols.setJournal(&g_journal);
+        return Napi::Boolean::New(env, true);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Object journalStatsToJs(Napi::Env env, const JournalStats& s, bool open) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("open",        Napi::Boolean::New(env, open));
+    obj.Set("records",     Napi::Number::New(env, static_cast<double>(s.records)));
+    obj.Set("bytes",       Napi::Number::New(env, static_cast<double>(s.bytes)));
+    obj.Set("dropped",     Napi::Number::New(env, static_cast<double>(s.dropped)));
+    obj.Set("segments",    Napi::Number::New(env, static_cast<double>(s.segments)));
+    obj.Set("segment",     Napi::Number::New(env, static_cast<double>(s.segment)));
+    obj.Set("checkpoints", Napi::Number::New(env, static_cast<double>(s.checkpoints)));
+    obj.Set("ring_peak",   Napi::Number::New(env, static_cast<double>(s.ring_peak)));
+    obj.Set("busy_ms",     Napi::Number::New(env, s.busy_ns / 1e6));
+    // Copy rate while busy — the ceiling the writer thread could sustain
+    obj.Set("write_mb_s",  Napi::Number::New(env, s.busy_ns > 0 ? (s.bytes / 1048576.0) / (s.busy_ns / 1e9) : 0.0));
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: closeJournal() → stats (as getJournalStats)
+// Detaches every symbol, drains the ring and truncates the last segment.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value CloseJournal(const Napi::CallbackInfo& info) {
+    g_symbols.setJournal(nullptr);
+    g_journal.close();
+    return journalStatsToJs(info.Env(), g_journal.stats(), false);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getJournalStats() → { open, records, bytes, dropped, segments,
+//   segment, checkpoints, ring_peak, busy_ms, write_mb_s }
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetJournalStats(const Napi::CallbackInfo& info) {
+    return journalStatsToJs(info.Env(), g_journal.stats(), g_journal.isOpen());
+}
+
+Napi::Object stateStatsToJs(Napi::Env env, const StateFileStats& s) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("ok",       Napi::Boolean::New(env, s.ok));
+    obj.Set("error",    Napi::String::New(env, s.error));
+    obj.Set("symbols",  Napi::Number::New(env, static_cast<double>(s.symbols)));
+    obj.Set("books",    Napi::Number::New(env, static_cast<double>(s.books)));
+    obj.Set("bytes",    Napi::Number::New(env, static_cast<double>(s.bytes)));
+    obj.Set("saved_ms", Napi::Number::New(env, static_cast<double>(s.saved_ms)));
+    obj.Set("ms",       Napi::Number::New(env, s.elapsed_ns / 1e6));
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: saveState(path) → { ok, error, symbols, books, bytes, saved_ms, ms }
+// Writes every symbol's in-sync books (with venue sequence ids) and the
+// VWAF inputs to one file, atomically (state_snapshot.hpp).
+// ─────────────────────────────────────────────────────────────────
+Napi::Value SaveState(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1 || !info[0].IsString()) throw std::invalid_argument("Expected state file path");
+        return stateStatsToJs(env, StateSnapshot::save(info[0].As<Napi::String>().Utf8Value(), g_symbols, g_vwaf,
+                                                       Clock::process().nowMs()));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: restoreState(path) → as saveState (saved_ms = when written)
+// Call before the feeds connect: restored books replace the live ones
+// and are served until their venues' own data takes over. error is
+// "missing" on a first start.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value RestoreState(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1 || !info[0].IsString()) throw std::invalid_argument("Expected state file path");
+        return stateStatsToJs(env, StateSnapshot::load(info[0].As<Napi::String>().Utf8Value(), g_symbols, g_vwaf));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getJournalInfo(dir) → { segments, symbols: [{ name, first_ms,
+//   last_ms, checkpoints }] } | null
+// What a journal directory can replay: checkpoint times per symbol.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetJournalInfo(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1 || !info[0].IsString()) throw std::invalid_argument("Expected journal directory");
+        JournalReader reader;
+        if (!reader.open(info[0].As<Napi::String>().Utf8Value())) return env.Null();
+
+        auto syms = Napi::Array::New(env);
+        for (size_t s = 0; s < reader.symbols().size(); ++s) {
+            int64_t first = INT64_MAX, last = INT64_MIN;
+            uint32_t n = 0;
+            for (const auto& cp : reader.checkpoints()) {
+                if (cp.symbol != s) continue;
+                first = std::min(first, cp.ts_ms);
+                last  = std::max(last, cp.ts_ms);
+                ++n;
+            }
+            auto o = Napi::Object::New(env);
+            o.Set("name",        reader.symbols()[s]);
+            o.Set("first_ms",    Napi::Number::New(env, static_cast<double>(first)));
+            o.Set("last_ms",     Napi::Number::New(env, static_cast<double>(last)));
+            o.Set("checkpoints", Napi::Number::New(env, n));
+            syms.Set(static_cast<uint32_t>(s), o);
+        }
+        auto obj = Napi::Object::New(env);
+        obj.Set("segments", Napi::Number::New(env, static_cast<double>(reader.segments())));
+        obj.Set("symbols",  syms);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: openReplay(dir, symbol, fromMs, toMs?) → replayId | null
+// Rebuilds `symbol`'s books at fromMs from the journal in `dir` — from
+// the nearest checkpoint, fast-forwarded — into a private aggregator on
+// a simulated clock (journal_replay.hpp). Null if the symbol was never
+// journaled there.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value OpenReplay(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsString() || !info[2].IsNumber()) {
+            throw std::invalid_argument("Expected (dir, symbol, fromMs, toMs?)");
+        }
+        auto reader = std::make_shared<JournalReader>();
+        if (!reader->open(info[0].As<Napi::String>().Utf8Value())) return env.Null();
+
+        const int64_t from_ms = info[2].As<Napi::Number>().Int64Value();
+        const int64_t to_ms   = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Int64Value() : INT64_MAX;
+        auto replay = std::make_unique<JournalReplay>(std::move(reader));
+        if (!replay->start(info[1].As<Napi::String>().Utf8Value(), from_ms, to_ms)) return env.Null();
+
+        const uint32_t id = g_next_replay++;
+        g_replays.emplace(id, std::move(replay));
+        return Napi::Number::New(env, id);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+JournalReplay& parseReplay(const Napi::Value& v) {
+    if (!v.IsNumber()) throw std::invalid_argument("Expected replay id");
+    auto it = g_replays.find(v.As<Napi::Number>().Uint32Value());
+    if (it == g_replays.end()) throw std::invalid_argument("Unknown replay id");
+    return *it->second;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: replayAdvance(replayId, untilMs?, maxEvents?) → { applied,
+//   time, done, events_per_sec }
+// Paced replay passes the next simulated time; as-fast-as-possible
+// passes untilMs = null with an event budget per call, so the JS loop
+// can yield between chunks.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ReplayAdvance(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& replay = parseReplay(info[0]);
+        const int64_t until_ms  = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Int64Value() : INT64_MAX;
+        const size_t max_events = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value() : SIZE_MAX;
+        if (until_ms == INT64_MAX && max_events == SIZE_MAX) throw std::invalid_argument("Expected untilMs or maxEvents");
+
+        const size_t applied = replay.advance(until_ms, max_events);
+        const auto& st = replay.stats();
+        auto obj = Napi::Object::New(env);
+        obj.Set("applied", Napi::Number::New(env, static_cast<double>(applied)));
+        obj.Set("time",    Napi::Number::New(env, static_cast<double>(replay.timeMs())));
+        obj.Set("done",    Napi::Boolean::New(env, replay.done()));
+        // Rate while busy, over the whole session
+        obj.Set("events_per_sec", Napi::Number::New(env, st.busy_ns > 0 ? st.applied / (st.busy_ns / 1e9) : 0.0));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getReplayBook(replayId, levels?) → JS object (as getAggregated)
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetReplayBook(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& replay  = parseReplay(info[0]);
+        size_t levels = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : OUTPUT_LEVELS;
+        levels = std::min(levels, OUTPUT_LEVELS);
+        return snapshotToJs(env, replay.aggregator().getAggregated(levels));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Null();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: closeReplay(replayId) — unmaps the session's segments
+// ─────────────────────────────────────────────────────────────────
+Napi::Value CloseReplay(const Napi::CallbackInfo& info) {
+    if (info.Length() > 0 && info[0].IsNumber()) g_replays.erase(info[0].As<Napi::Number>().Uint32Value());
+    return info.Env().Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: enableDepthHistory(symbol, dir, { intervalMs?, step?,
+//   rowsPerSide?, quantum? }?) → boolean
+// Starts recording the symbol's consolidated depth into daily heatmap
+// files under dir (depth_history.hpp). Columns are taken by
+// recordDepthHistory(); step defaults to 10 ticks.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value EnableDepthHistory(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 2 || !info[1].IsString()) throw std::invalid_argument("Expected (symbol, dir, options?)");
+        auto& book = parseSymbol(info[0]);
+
+        DepthHistoryOptions opts;
+        opts.dir = info[1].As<Napi::String>().Utf8Value();
+        if (info.Length() > 2 && info[2].IsObject()) {
+            auto o = info[2].As<Napi::Object>();
+            if (o.Has("intervalMs"))  opts.interval_ms   = o.Get("intervalMs").As<Napi::Number>().Int64Value();
+            if (o.Has("step"))        opts.step          = o.Get("step").As<Napi::Number>().DoubleValue();
+            if (o.Has("rowsPerSide")) opts.rows_per_side = o.Get("rowsPerSide").As<Napi::Number>().Uint32Value();
+            if (o.Has("quantum"))     opts.quantum       = o.Get("quantum").As<Napi::Number>().DoubleValue();
+        }
+        if (opts.interval_ms <= 0 || opts.step < 0 || opts.rows_per_side == 0 ||
+            opts.rows_per_side > DepthHistoryReader::MAX_ROWS / 2 || !(opts.quantum > 0)) {
+            throw std::invalid_argument("Invalid depth history options");
+        }
+        return Napi::Boolean::New(env, book.history.enable(opts, g_symbols.name(book.id)));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: recordDepthHistory() → columns written
+// Samples every recording symbol whose interval has elapsed; call it at
+// least as often as the shortest intervalMs.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value RecordDepthHistory(const Napi::CallbackInfo& info) {
+    const int64_t now_ms = Clock::process().nowMs();
+    uint32_t written = 0;
+    for (size_t id = 0; id < g_symbols.size(); ++id) {
+        SymbolBook* book = g_symbols.get(static_cast<SymbolID>(id));
+        if (book && book->history.enabled() && book->history.sample(book->aggregator, now_ms)) ++written;
+    }
+    return Napi::Number::New(info.Env(), written);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getDepthHistoryStats(symbol) → { columns, bytes, keyframes,
+//   files, encode_us } | null when not recording
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetDepthHistoryStats(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        if (!book.history.enabled()) return env.Null();
+        const auto& s = book.history.stats();
+        auto obj = Napi::Object::New(env);
+        obj.Set("columns",   Napi::Number::New(env, static_cast<double>(s.columns)));
+        obj.Set("bytes",     Napi::Number::New(env, static_cast<double>(s.bytes)));
+        obj.Set("keyframes", Napi::Number::New(env, static_cast<double>(s.keyframes)));
+        obj.Set("files",     Napi::Number::New(env, static_cast<double>(s.files)));
+        obj.Set("encode_us", Napi::Number::New(env, s.columns ? s.encode_ns / 1e3 / s.columns : 0.0));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: readDepthHistory(dir, symbol, fromMs, toMs, priceLo, priceHi,
+//   maxBins?) → { from, bin_ms, bins, rows, price0, step, columns,
+//   qty: Float32Array } | null
+// Heatmap window from the recorded files: qty[bin * rows + row] is the
+// largest resting size (base units) in row's price band during the bin;
+// row 0 is price0. Reads the mapped files directly — no live state.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ReadDepthHistory(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 6 || !info[0].IsString() || !info[1].IsString()) {
+            throw std::invalid_argument("Expected (dir, symbol, fromMs, toMs, priceLo, priceHi, maxBins?)");
+        }
+        const size_t max_bins = info.Length() > 6 && info[6].IsNumber() ? info[6].As<Napi::Number>().Uint32Value() : 0;
+        DepthSlice slice;
+        if (!DepthHistoryReader::slice(info[0].As<Napi::String>().Utf8Value(), info[1].As<Napi::String>().Utf8Value(),
+                                       info[2].As<Napi::Number>().Int64Value(), info[3].As<Napi::Number>().Int64Value(),
+                                       info[4].As<Napi::Number>().DoubleValue(), info[5].As<Napi::Number>().DoubleValue(),
+                                       max_bins, slice)) {
+            return env.Null();
+        }
+
+        auto qty = Napi::Float32Array::New(env, slice.qty.size());
+        std::memcpy(qty.Data(), slice.qty.data(), slice.qty.size() * sizeof(float));
+        auto obj = Napi::Object::New(env);
+        obj.Set("from",    Napi::Number::New(env, static_cast<double>(slice.from_ms)));
+        obj.Set("bin_ms",  Napi::Number::New(env, static_cast<double>(slice.bin_ms)));
+        obj.Set("bins",    Napi::Number::New(env, static_cast<double>(slice.bins)));
+        obj.Set("rows",    Napi::Number::New(env, static_cast<double>(slice.rows)));
+        obj.Set("price0",  Napi::Number::New(env, slice.price0));
+        obj.Set("step",    Napi::Number::New(env, slice.step));
+        obj.Set("columns", Napi::Number::New(env, static_cast<double>(slice.columns)));
+        obj.Set("qty",     qty);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// "buy" / "sell" (the aggressor) or ±1; anything else is unknown
+TradeSide parseSide(const Napi::Value& val) {
+    if (val.IsNumber()) {
+        const double v = val.As<Napi::Number>().DoubleValue();
+        return v > 0 ? TradeSide::BUY : v < 0 ? TradeSide::SELL : TradeSide::UNKNOWN;
+    }
+    if (val.IsString()) {
+        const std::string s = val.As<Napi::String>().Utf8Value();
+        if (s == "buy")  return TradeSide::BUY;
+        if (s == "sell") return TradeSide::SELL;
+    }
+    return TradeSide::UNKNOWN;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: ingestTrade(symbol, exchange, price, qty, tsMs, side?)
+// One trade into every interval's candle and footprint
+// (candle_engine.hpp), the symbol's trade flow (trade_flow.hpp) and its
+// tape when enabled (trade_tape.hpp), and the walls it hits on its venue
+// (wall_tracker.hpp). symbol is the registerSymbol() id; venues without
+// an ExchangeID still count, trades without a side skip the footprint,
+// the flow and the walls.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value IngestTrade(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 5) throw std::invalid_argument("Expected (symbol, exchange, price, qty, tsMs, side?)");
+        auto& book = parseSymbol(info[0]);
+        const ExchangeID ex = parseExchange(info[1]);
+        const double  price = info[2].As<Napi::Number>().DoubleValue();
+        const double  qty   = info[3].As<Napi::Number>().DoubleValue();
+        const int64_t ts_ms = info[4].As<Napi::Number>().Int64Value();
+        const TradeSide side = info.Length() > 5 ? parseSide(info[5]) : TradeSide::UNKNOWN;
+        g_candles.ingest(book.id, ex, price, qty, ts_ms, side);
+        if (side != TradeSide::UNKNOWN) book.flow.add(ex, price, qty, side == TradeSide::BUY, ts_ms);
+        book.tape.append(ts_ms, price, qty, static_cast<int8_t>(side), ex);
+        if (side != TradeSide::UNKNOWN) book.aggregator.onTrade(ex, price, qty, static_cast<int8_t>(side));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: drainCandles(footprints?) → { closed, live, dropped, stride,
+//   data: Float64Array, rows, footprint?: Float32Array }
+// data holds `closed` finished candles (oldest first) then `live` current
+// ones touched since the last drain, `stride` doubles each: symbol id,
+// interval sec, open time sec, open, high, low, close, volume,
+// quote volume, trades, buy volume, sell volume, POC, value area low /
+// high, footprint price0 / step, then volume per exchange id. With
+// footprints, footprint holds each candle's `rows` (buy, sell) pairs.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value DrainCandles(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    static std::vector<double> buf;
+    static std::vector<float>  fp;
+    const bool with_fp = info.Length() > 0 && info[0].IsBoolean() && info[0].As<Napi::Boolean>().Value();
+    const CandleDrainStats st = g_candles.drain(buf, with_fp ? &fp : nullptr);
+
+    auto data = Napi::Float64Array::New(env, buf.size());
+    std::copy(buf.begin(), buf.end(), data.Data());
+    auto obj = Napi::Object::New(env);
+    obj.Set("closed",  Napi::Number::New(env, st.closed));
+    obj.Set("live",    Napi::Number::New(env, st.live));
+    obj.Set("dropped", Napi::Number::New(env, static_cast<double>(st.dropped)));
+    obj.Set("stride",  Napi::Number::New(env, static_cast<double>(CANDLE_FIELDS)));
+    obj.Set("data",    data);
+    obj.Set("rows",    Napi::Number::New(env, static_cast<double>(FOOTPRINT_BUCKETS)));
+    if (with_fp) {
+        auto rows = Napi::Float32Array::New(env, fp.size());
+        std::copy(fp.begin(), fp.end(), rows.Data());
+        obj.Set("footprint", rows);
+    }
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getFootprint(symbol, intervalSec) → { time, price0, step, poc,
+//   val, vah, buy: Float32Array, sell: Float32Array } | null
+// The open candle's footprint; at 86400 this is the UTC session's
+// volume profile.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetFootprint(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const int64_t interval = info.Length() > 1 ? info[1].As<Napi::Number>().Int64Value() : 86400;
+        const auto k = static_cast<size_t>(std::find(CANDLE_INTERVAL_SEC.begin(), CANDLE_INTERVAL_SEC.end(), interval) -
+                                           CANDLE_INTERVAL_SEC.begin());
+        const CandleAccumulator* c = g_candles.live(book.id, k);
+        if (!c) return env.Null();
+
+        const FootprintBlock& fp = g_candles.footprint(*c);
+        size_t lo, hi;
+        CandleEngine::valueArea(*c, fp, lo, hi);
+        auto buy  = Napi::Float32Array::New(env, FOOTPRINT_BUCKETS);
+        auto sell = Napi::Float32Array::New(env, FOOTPRINT_BUCKETS);
+        for (size_t r = 0; r < FOOTPRINT_BUCKETS; ++r) {
+            buy[r]  = static_cast<float>(fp[r].buy);
+            sell[r] = static_cast<float>(fp[r].sell);
+        }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("time",   Napi::Number::New(env, static_cast<double>(c->open_time)));
+        obj.Set("price0", Napi::Number::New(env, c->fp_price0));
+        obj.Set("step",   Napi::Number::New(env, c->fp_step));
+        obj.Set("poc",    Napi::Number::New(env, c->fp_price0 + (c->poc + 0.5) * c->fp_step));
+        obj.Set("val",    Napi::Number::New(env, c->fp_price0 + lo * c->fp_step));
+        obj.Set("vah",    Napi::Number::New(env, c->fp_price0 + (hi + 1) * c->fp_step));
+        obj.Set("buy",    buy);
+        obj.Set("sell",   sell);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Object flowWindowToJs(Napi::Env env, const FlowWindow& w) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("buy",       Napi::Number::New(env, w.buy));
+    obj.Set("sell",      Napi::Number::New(env, w.sell));
+    obj.Set("trades",    Napi::Number::New(env, w.trades));
+    obj.Set("imbalance", Napi::Number::New(env, w.imbalance()));
+    return obj;
+}
+
+Napi::Object flowTotalsToJs(Napi::Env env, const FlowTotals& t) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("cvd",         Napi::Number::New(env, t.cvd));
+    obj.Set("cvd_quote",   Napi::Number::New(env, t.cvd_quote));
+    obj.Set("buy_volume",  Napi::Number::New(env, t.buy_volume));
+    obj.Set("sell_volume", Napi::Number::New(env, t.sell_volume));
+    obj.Set("buys",        Napi::Number::New(env, static_cast<double>(t.buys)));
+    obj.Set("sells",       Napi::Number::New(env, static_cast<double>(t.sells)));
+    auto counts  = Napi::Array::New(env, FLOW_SIZE_BUCKETS);
+    auto volumes = Napi::Array::New(env, FLOW_SIZE_BUCKETS);
+    for (size_t b = 0; b < FLOW_SIZE_BUCKETS; ++b) {
+        counts.Set(static_cast<uint32_t>(b),  Napi::Number::New(env, static_cast<double>(t.size_count[b])));
+        volumes.Set(static_cast<uint32_t>(b), Napi::Number::New(env, t.size_volume[b]));
+    }
+    obj.Set("size_count",  counts);
+    obj.Set("size_volume", volumes);
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getTradeFlow(symbol) → { ts, total, exchanges: { [id]: totals },
+//   windows: [{ ms, total, exchanges: { [id]: window } }] }
+// totals: { cvd, cvd_quote, buy_volume, sell_volume, buys, sells,
+// size_count[6], size_volume[6] } with notional buckets <100 … ≥1M;
+// window: { buy, sell, trades, imbalance } over 1s / 10s / 60s / 300s.
+// Venues that never traded are left out.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetTradeFlow(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const TradeFlowSnapshot s = book.flow.snapshot(Clock::process().nowMs());
+
+        auto exchanges = Napi::Object::New(env);
+        for (size_t v = 0; v < FLOW_ALL; ++v) {
+            if (s.totals[v].buys + s.totals[v].sells == 0) continue;
+            exchanges.Set(static_cast<uint32_t>(v), flowTotalsToJs(env, s.totals[v]));
+        }
+        auto windows = Napi::Array::New(env, FLOW_WINDOWS);
+        for (size_t w = 0; w < FLOW_WINDOWS; ++w) {
+            auto win = Napi::Object::New(env);
+            auto per = Napi::Object::New(env);
+            for (size_t v = 0; v < FLOW_ALL; ++v) {
+                if (s.totals[v].buys + s.totals[v].sells == 0) continue;
+                per.Set(static_cast<uint32_t>(v), flowWindowToJs(env, s.windows[w][v]));
+            }
+            win.Set("ms",        Napi::Number::New(env, static_cast<double>(FLOW_WINDOW_MS[w])));
+            win.Set("total",     flowWindowToJs(env, s.windows[w][FLOW_ALL]));
+            win.Set("exchanges", per);
+            windows.Set(static_cast<uint32_t>(w), win);
+        }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("ts",        Napi::Number::New(env, static_cast<double>(s.ts_ms)));
+        obj.Set("total",     flowTotalsToJs(env, s.totals[FLOW_ALL]));
+        obj.Set("exchanges", exchanges);
+        obj.Set("windows",   windows);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: enableTradeTape(symbol, retentionHours)
+// Keep the symbol's last retentionHours of ingestTrade() trades in
+// memory (trade_tape.hpp); 0 stops recording and frees the tape.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value EnableTradeTape(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 2) throw std::invalid_argument("Expected (symbol, retentionHours)");
+        auto& book = parseSymbol(info[0]);
+        const double hours = info[1].As<Napi::Number>().DoubleValue();
+        if (!(hours >= 0)) throw std::invalid_argument("Invalid retention");
+        book.tape.setRetention(static_cast<int64_t>(hours * 3'600'000));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getTapeTrades(symbol, fromMs, toMs, limit?, latest?) →
+//   { count, truncated, time: Float64Array, price: Float64Array,
+//     qty: Float64Array, side: Int8Array, exchange: Uint8Array }
+// Trades in [fromMs, toMs], oldest first; past `limit` (default 10000)
+// the oldest are kept, or the newest when latest. side is +1 buy,
+// −1 sell, 0 unknown; exchange is the ExchangeID, 7 for other venues.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetTapeTrades(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 3) throw std::invalid_argument("Expected (symbol, fromMs, toMs, limit?, latest?)");
+        auto& book = parseSymbol(info[0]);
+        const int64_t from_ms = info[1].As<Napi::Number>().Int64Value();
+        const int64_t to_ms   = info[2].As<Napi::Number>().Int64Value();
+        const size_t  limit   = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 10000;
+        const bool    latest  = info.Length() > 4 && info[4].IsBoolean() && info[4].As<Napi::Boolean>().Value();
+
+        static TapeTrades t;
+        book.tape.range(from_ms, to_ms, limit, latest, t);
+        const size_t n = t.size();
+        auto time     = Napi::Float64Array::New(env, n);
+        auto price    = Napi::Float64Array::New(env, n);
+        auto qty      = Napi::Float64Array::New(env, n);
+        auto side     = Napi::Int8Array::New(env, n);
+        auto exchange = Napi::Uint8Array::New(env, n);
+        std::transform(t.ts.begin(), t.ts.end(), time.Data(), [](int64_t v) { return static_cast<double>(v); });
+        std::copy(t.price.begin(), t.price.end(), price.Data());
+        std::copy(t.qty.begin(), t.qty.end(), qty.Data());
+        std::copy(t.side.begin(), t.side.end(), side.Data());
+        std::copy(t.exchange.begin(), t.exchange.end(), exchange.Data());
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("count",     Napi::Number::New(env, static_cast<double>(n)));
+        obj.Set("truncated", Napi::Boolean::New(env, t.truncated));
+        obj.Set("time",      time);
+        obj.Set("price",     price);
+        obj.Set("qty",       qty);
+        obj.Set("side",      side);
+        obj.Set("exchange",  exchange);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getTapeCandles(symbol, fromMs, toMs, intervalMs) →
+//   { count, stride, data: Float64Array }
+// The tape resampled to any interval (epoch-aligned), `stride` doubles
+// per candle: open time ms, open, high, low, close, volume,
+// quote volume, buy volume, sell volume, trades. Empty intervals are
+// left out.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetTapeCandles(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 4) throw std::invalid_argument("Expected (symbol, fromMs, toMs, intervalMs)");
+        auto& book = parseSymbol(info[0]);
+        const int64_t from_ms     = info[1].As<Napi::Number>().Int64Value();
+        const int64_t to_ms       = info[2].As<Napi::Number>().Int64Value();
+        const int64_t interval_ms = info[3].As<Napi::Number>().Int64Value();
+        if (interval_ms <= 0) throw std::invalid_argument("Invalid interval");
+
+        static std::vector<double> buf;
+        const size_t n = book.tape.resample(from_ms, to_ms, interval_ms, buf);
+        auto data = Napi::Float64Array::New(env, buf.size());
+        std::copy(buf.begin(), buf.end(), data.Data());
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("count",  Napi::Number::New(env, static_cast<double>(n)));
+        obj.Set("stride", Napi::Number::New(env, static_cast<double>(TAPE_CANDLE_FIELDS)));
+        obj.Set("data",   data);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getTapeStats(symbol) → { enabled, trades, chunks, bytes,
+//   firstMs, lastMs, appended }
+// firstMs is the oldest trade held: ranges from there on are complete.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetTapeStats(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const TapeStats s = book.tape.stats();
+        auto obj = Napi::Object::New(env);
+        obj.Set("enabled",  Napi::Boolean::New(env, book.tape.enabled()));
+        obj.Set("trades",   Napi::Number::New(env, static_cast<double>(s.trades)));
+        obj.Set("chunks",   Napi::Number::New(env, static_cast<double>(s.chunks)));
+        obj.Set("bytes",    Napi::Number::New(env, static_cast<double>(s.bytes)));
+        obj.Set("firstMs",  Napi::Number::New(env, static_cast<double>(s.first_ms)));
+        obj.Set("lastMs",   Napi::Number::New(env, static_cast<double>(s.last_ms)));
+        obj.Set("appended", Napi::Number::New(env, static_cast<double>(s.appended)));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: encodeCopy(rows, columns) → Buffer
+// One PostgreSQL binary COPY payload (pg_copy.hpp) for
+// `COPY t (cols) FROM STDIN (FORMAT binary)`, built from columns:
+//   { type: 'timestamptz', values: Float64Array }   epoch ms
+//   { type: 'float8',      values: Float64Array }
+//   { type: 'text', dict: string[], index?: Uint8Array | Uint16Array }
+// Text is dictionary-coded: row i gets dict[index[i]], dict[0] for every
+// row without an index, NULL when the index is past the dict.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value EncodeCopy(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 2 || !info[1].IsArray()) throw std::invalid_argument("Expected (rows, columns)");
+        const size_t rows = info[0].As<Napi::Number>().Uint32Value();
+        auto specs = info[1].As<Napi::Array>();
+        if (specs.Length() == 0 || specs.Length() > UINT16_MAX) throw std::invalid_argument("Invalid column count");
+
+        enum class Kind { TIMESTAMPTZ, FLOAT8, TEXT };
+        struct Column {
+            Kind                     kind;
+            const double*            values = nullptr;
+            std::vector<std::string> dict;
+            const uint8_t*           index8  = nullptr;
+            const uint16_t*          index16 = nullptr;
+        };
+        std::vector<Column> cols(specs.Length());
+        for (uint32_t c = 0; c < specs.Length(); ++c) {
+            auto o = specs.Get(c).As<Napi::Object>();
+            const std::string type = o.Get("type").As<Napi::String>().Utf8Value();
+            Column& col = cols[c];
+            if (type == "timestamptz" || type == "float8") {
+                col.kind = type == "float8" ? Kind::FLOAT8 : Kind::TIMESTAMPTZ;
+                auto values = o.Get("values").As<Napi::Float64Array>();
+                if (values.ElementLength() < rows) throw std::invalid_argument("Column shorter than rows");
+                col.values = values.Data();
+            } else if (type == "text") {
+                col.kind = Kind::TEXT;
+                auto dict = o.Get("dict").As<Napi::Array>();
+                for (uint32_t i = 0; i < dict.Length(); ++i) col.dict.push_back(dict.Get(i).As<Napi::String>().Utf8Value());
+                if (o.Has("index") && o.Get("index").IsTypedArray()) {
+                    auto index = o.Get("index").As<Napi::TypedArray>();
+                    if (index.ElementLength() < rows) throw std::invalid_argument("Column shorter than rows");
+                    if (index.TypedArrayType() == napi_uint8_array)       col.index8  = index.As<Napi::Uint8Array>().Data();
+                    else if (index.TypedArrayType() == napi_uint16_array) col.index16 = index.As<Napi::Uint16Array>().Data();
+                    else throw std::invalid_argument("Text index must be a Uint8Array or Uint16Array");
+                }
+            } else {
+                throw std::invalid_argument("Unknown column type: " + type);
+            }
+        }
+
+        static PgCopyWriter copy;
+        copy.reset();
+        copy.reserve(rows * (2 + cols.size() * 16));
+        for (size_t r = 0; r < rows; ++r) {
+            copy.beginRow(static_cast<uint16_t>(cols.size()));
+            for (const Column& col : cols) {
+                switch (col.kind) {
+                    case Kind::TIMESTAMPTZ: copy.timestamptz(static_cast<int64_t>(col.values[r])); break;
+                    case Kind::FLOAT8:      copy.float8(col.values[r]); break;
+                    case Kind::TEXT: {
+                        const size_t k = col.index8 ? col.index8[r] : col.index16 ? col.index16[r] : 0;
+                        if (k < col.dict.size()) copy.text(col.dict[k]);
+                        else copy.null();
+                        break;
+                    }
+                }
+            }
+        }
+        copy.finish();
+        return Napi::Buffer<uint8_t>::Copy(env, copy.data(), copy.size());
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Object bookSignalToJs(Napi::Env env, const BookSignal& s, const BookSignalsSnapshot& snap, size_t v) {
+    auto imbalance = Napi::Float32Array::New(env, SIGNAL_IMBALANCES);
+    std::copy(s.imbalance.begin(), s.imbalance.end(), imbalance.Data());
+    auto windows = Napi::Array::New(env, SIGNAL_WINDOWS);
+    for (size_t w = 0; w < SIGNAL_WINDOWS; ++w) {
+        auto win = Napi::Float32Array::New(env, SIGNAL_IMBALANCES);
+        std::copy(snap.windows[v][w].begin(), snap.windows[v][w].end(), win.Data());
+        windows.Set(static_cast<uint32_t>(w), win);
+    }
+    auto obj = Napi::Object::New(env);
+    obj.Set("ts",         Napi::Number::New(env, static_cast<double>(s.ts_ms)));
+    obj.Set("bid",        Napi::Number::New(env, s.bid));
+    obj.Set("ask",        Napi::Number::New(env, s.ask));
+    obj.Set("mid",        Napi::Number::New(env, s.mid()));
+    obj.Set("microprice", Napi::Number::New(env, s.microprice));
+    obj.Set("imbalance",  imbalance);
+    obj.Set("windows",    windows);
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getBookSignals(symbol) → { ts, depths, bands, windowMs,
+//   total, exchanges: { [id]: signal } } | null
+// signal: { ts, bid, ask, mid, microprice, imbalance: Float32Array,
+// windows: Float32Array[] } — imbalance (bid − ask) / (bid + ask) at each
+// of `depths` levels then each `bands` bps, and its EMA over each of
+// `windowMs` (book_signals.hpp). Sampled on every book change; venues
+// never sampled are left out, null before the first book.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetBookSignals(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const BookSignalsSnapshot snap = book.aggregator.getSignals();
+        if (snap.latest[SIGNAL_ALL].ts_ms == 0) return env.Null();
+
+        auto depths = Napi::Array::New(env, SIGNAL_DEPTHS.size());
+        for (size_t d = 0; d < SIGNAL_DEPTHS.size(); ++d) depths.Set(static_cast<uint32_t>(d), Napi::Number::New(env, static_cast<double>(SIGNAL_DEPTHS[d])));
+        auto bands = Napi::Array::New(env, snap.bands.count);
+        for (size_t k = 0; k < snap.bands.count; ++k) bands.Set(static_cast<uint32_t>(k), Napi::Number::New(env, snap.bands.bps[k]));
+        auto window_ms = Napi::Array::New(env, SIGNAL_WINDOWS);
+        for (size_t w = 0; w < SIGNAL_WINDOWS; ++w) window_ms.Set(static_cast<uint32_t>(w), Napi::Number::New(env, static_cast<double>(SIGNAL_WINDOW_MS[w])));
+        auto exchanges = Napi::Object::New(env);
+        for (size_t v = 0; v < SIGNAL_ALL; ++v) {
+            if (snap.latest[v].ts_ms == 0) continue;
+            exchanges.Set(static_cast<uint32_t>(v), bookSignalToJs(env, snap.latest[v], snap, v));
+        }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("ts",        Napi::Number::New(env, static_cast<double>(snap.ts_ms)));
+        obj.Set("depths",    depths);
+        obj.Set("bands",     bands);
+        obj.Set("windowMs",  window_ms);
+        obj.Set("total",     bookSignalToJs(env, snap.latest[SIGNAL_ALL], snap, SIGNAL_ALL));
+        obj.Set("exchanges", exchanges);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getBookSignalSeries(symbol, exchange?, sinceMs?) →
+//   { count, stride, data: Float64Array }
+// The last samples (up to 2048, one per millisecond) of one venue, or
+// the consolidated book without an exchange, newer than sinceMs; `stride`
+// doubles each: ts ms, bid, ask, microprice, then the imbalances in
+// getBookSignals() order.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetBookSignalSeries(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        size_t venue = SIGNAL_ALL;
+        if (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsNull()) {
+            const ExchangeID ex = parseExchange(info[1]);
+            if (ex == ExchangeID::MAX_EXCHANGES) throw std::invalid_argument("Unknown exchange");
+            venue = static_cast<size_t>(ex);
+        }
+        const int64_t since_ms = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Int64Value() : 0;
+
+        static std::vector<double> buf;
+        const size_t n = book.aggregator.getSignalSeries(venue, since_ms, buf);
+        auto data = Napi::Float64Array::New(env, buf.size());
+        std::copy(buf.begin(), buf.end(), data.Data());
+        auto obj = Napi::Object::New(env);
+        obj.Set("count",  Napi::Number::New(env, static_cast<double>(n)));
+        obj.Set("stride", Napi::Number::New(env, static_cast<double>(SIGNAL_FIELDS)));
+        obj.Set("data",   data);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getBbo(symbol) → { ts, bid, ask, exchanges: { [name]:
+//   { bid, bidQty, ask, askQty, seen, live } }, open: [event], dropped }
+// Best bid / ask of every venue with a book, the consolidated touch
+// over the live ones, and the crosses / deviations in progress as the
+// events that opened them.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetBbo(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const BboTable<N_EXCHANGES> t = book.aggregator.getBbo();
+
+        auto exchanges = Napi::Object::New(env);
+        for (size_t v = 0; v < N_EXCHANGES; ++v) {
+            const BboQuote& q = t.quotes[v];
+            if (q.seen_ms == 0) continue;
+            auto row = Napi::Object::New(env);
+            row.Set("bid",    Napi::Number::New(env, q.bid));
+            row.Set("bidQty", Napi::Number::New(env, q.bid_qty));
+            row.Set("ask",    Napi::Number::New(env, q.ask));
+            row.Set("askQty", Napi::Number::New(env, q.ask_qty));
+            row.Set("seen",   Napi::Number::New(env, static_cast<double>(q.seen_ms)));
+            row.Set("live",   Napi::Boolean::New(env, t.live[v]));
+            exchanges.Set(EXCHANGE_NAMES[v], row);
+        }
+        auto open = Napi::Array::New(env, t.open.size());
+        for (size_t k = 0; k < t.open.size(); ++k) open.Set(static_cast<uint32_t>(k), bboEventToJs(env, t.open[k]));
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("ts",        Napi::Number::New(env, static_cast<double>(t.ts_ms)));
+        obj.Set("bid",       Napi::Number::New(env, t.bid));
+        obj.Set("ask",       Napi::Number::New(env, t.ask));
+        obj.Set("exchanges", exchanges);
+        obj.Set("open",      open);
+        obj.Set("dropped",   Napi::Number::New(env, static_cast<double>(t.dropped)));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: setBboConfig(symbol, { feesBps?: { [exchange]: bps },
+//   minEdgeBps?, deviationBps? }) → the applied config, same shape
+// Taker fees per venue (default 5bps), the after-fee edge a cross must
+// exceed, and the distance from the consolidated mid that counts as a
+// deviation. Omitted fields keep their current value.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value SetBboConfig(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        BboConfig<N_EXCHANGES> config = book.aggregator.bboConfig();
+        if (info.Length() > 1 && info[1].IsObject()) {
+            auto opts = info[1].As<Napi::Object>();
+            auto number = [](const Napi::Value& v, double lo, double hi) {
+                const double d = v.IsNumber() ? v.As<Napi::Number>().DoubleValue() : NAN;
+                if (!(d >= lo && d <= hi)) throw std::invalid_argument("BBO config value out of range");
+                return d;
+            };
+            if (opts.Has("feesBps") && opts.Get("feesBps").IsObject()) {
+                auto fees = opts.Get("feesBps").As<Napi::Object>();
+                for (size_t v = 0; v < N_EXCHANGES; ++v) {
+                    if (fees.Has(EXCHANGE_NAMES[v])) config.fee_bps[v] = number(fees.Get(EXCHANGE_NAMES[v]), -100, 100);
+                }
+            }
+            if (opts.Has("minEdgeBps"))   config.min_edge_bps  = number(opts.Get("minEdgeBps"), -1000, 1000);
+            if (opts.Has("deviationBps")) config.deviation_bps = number(opts.Get("deviationBps"), 0, 10000);
+            book.aggregator.setBboConfig(config);
+        }
+
+        auto fees = Napi::Object::New(env);
+        for (size_t v = 0; v < N_EXCHANGES; ++v) fees.Set(EXCHANGE_NAMES[v], Napi::Number::New(env, config.fee_bps[v]));
+        auto obj = Napi::Object::New(env);
+        obj.Set("feesBps",      fees);
+        obj.Set("minEdgeBps",   Napi::Number::New(env, config.min_edge_bps));
+        obj.Set("deviationBps", Napi::Number::New(env, config.deviation_bps));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getLeadLag(symbol) → { ts, binMs, maxLagMs, windowMs,
+//   exchanges, moves, leadMs, peak, ratio, curves } | null
+// Cross-venue lead-lag over the last windowMs, republished every second.
+// leadMs / peak / ratio are N×N Float64Arrays over `exchanges`, row a
+// column b: ms a leads b at the peak correlation (negative = lags), that
+// correlation, and the lead-lag ratio (> 1 = a leads). moves: bins with
+// a mid change per venue. curves["a/b"]: Float32Array of the correlation
+// with a leading b by (i − maxLag) bins, for pairs that both moved.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetLeadLag(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        const LeadLagMatrix<N_EXCHANGES> m = book.aggregator.getLeadLag();
+        if (m.ts_ms == 0) return env.Null();
+
+        auto exchanges = Napi::Array::New(env, N_EXCHANGES);
+        auto moves     = Napi::Object::New(env);
+        auto lead_ms   = Napi::Float64Array::New(env, N_EXCHANGES * N_EXCHANGES);
+        auto peak      = Napi::Float64Array::New(env, N_EXCHANGES * N_EXCHANGES);
+        auto ratio     = Napi::Float64Array::New(env, N_EXCHANGES * N_EXCHANGES);
+        for (size_t a = 0; a < N_EXCHANGES; ++a) {
+            exchanges.Set(static_cast<uint32_t>(a), Napi::String::New(env, EXCHANGE_NAMES[a]));
+            moves.Set(EXCHANGE_NAMES[a], Napi::Number::New(env, m.moves[a]));
+            for (size_t b = 0; b < N_EXCHANGES; ++b) {
+                lead_ms[a * N_EXCHANGES + b] = m.lead_ms[a][b];
+                peak[a * N_EXCHANGES + b]    = m.peak[a][b];
+                ratio[a * N_EXCHANGES + b]   = m.ratio[a][b];
+            }
+        }
+        auto curves = Napi::Object::New(env);
+        size_t p = 0;
+        for (size_t a = 0; a < N_EXCHANGES; ++a) {
+            for (size_t b = a + 1; b < N_EXCHANGES; ++b, ++p) {
+                if (m.moves[a] == 0 || m.moves[b] == 0) continue;
+                auto curve = Napi::Float32Array::New(env, LEADLAG_LAGS);
+                std::copy(m.curve[p].begin(), m.curve[p].end(), curve.Data());
+                curves.Set(std::string(EXCHANGE_NAMES[a]) + "/" + EXCHANGE_NAMES[b], curve);
+            }
+        }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("ts",        Napi::Number::New(env, static_cast<double>(m.ts_ms)));
+        obj.Set("binMs",     Napi::Number::New(env, static_cast<double>(LEADLAG_BIN_MS)));
+        obj.Set("maxLagMs",  Napi::Number::New(env, static_cast<double>(LEADLAG_MAX_LAG * LEADLAG_BIN_MS)));
+        obj.Set("windowMs",  Napi::Number::New(env, static_cast<double>(LEADLAG_WINDOW * LEADLAG_BIN_MS)));
+        obj.Set("exchanges", exchanges);
+        obj.Set("moves",     moves);
+        obj.Set("leadMs",    lead_ms);
+        obj.Set("peak",      peak);
+        obj.Set("ratio",     ratio);
+        obj.Set("curves",    curves);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getWalls(symbol) → { ts, live, recent, counts }
+// Per-venue wall lifecycles (wall_tracker.hpp). live: walls resting now,
+// with ageMs and their size history as [tsMs, qty] pairs; recent: the
+// latest deaths, oldest first, with diedMs, lifetimeMs and fate
+// ('filled' | 'pulled' | 'spoofed' | 'out_of_range' | 'reset').
+// counts[exchange][fate]: deaths since the symbol was last cleared. Distances are bps behind
+// the venue's own touch.
+// ─────────────────────────────────────────────────────────────────
+static const char* WALL_FATE_NAMES[] = { "live", "filled", "pulled", "spoofed", "out_of_range", "reset" };
+
+Napi::Object wallToJs(Napi::Env env, const WallRecord& w, const InstrumentSpec& spec, int64_t now_ms) {
+    auto history = Napi::Array::New(env, w.history.size());
+    for (size_t k = 0; k < w.history.size(); ++k) {
+        auto point = Napi::Array::New(env, 2);
+        point.Set(0u, Napi::Number::New(env, static_cast<double>(w.history[k].ts_ms)));
+        point.Set(1u, Napi::Number::New(env, spec.toQty(w.history[k].lots)));
+        history.Set(static_cast<uint32_t>(k), point);
+    }
+    auto obj = Napi::Object::New(env);
+    obj.Set("id",         Napi::Number::New(env, static_cast<double>(w.id)));
+    obj.Set("exchange",   Napi::String::New(env, EXCHANGE_NAMES[w.exchange]));
+    obj.Set("side",       Napi::String::New(env, w.is_bid ? "bid" : "ask"));
+    obj.Set("price",      Napi::Number::New(env, spec.toPrice(w.price_raw)));
+    obj.Set("qty",        Napi::Number::New(env, spec.toQty(w.lots)));
+    obj.Set("peakQty",    Napi::Number::New(env, spec.toQty(w.peak_lots)));
+    obj.Set("bornMs",     Napi::Number::New(env, static_cast<double>(w.born_ms)));
+    obj.Set("atTouchQty", Napi::Number::New(env, spec.toQty(w.at_touch_lots)));
+    obj.Set("behindQty",  Napi::Number::New(env, spec.toQty(w.behind_lots)));
+    obj.Set("tradedQty",  Napi::Number::New(env, spec.toQty(w.traded_lots)));
+    obj.Set("birthBps",   Napi::Number::New(env, w.birth_bps));
+    obj.Set("minBps",     Napi::Number::New(env, w.min_bps));
+    obj.Set("history",    history);
+    if (w.fate == WallFate::LIVE) {
+        obj.Set("ageMs", Napi::Number::New(env, static_cast<double>(now_ms - w.born_ms)));
+    } else {
+        obj.Set("diedMs",     Napi::Number::New(env, static_cast<double>(w.died_ms)));
+        obj.Set("lifetimeMs", Napi::Number::New(env, static_cast<double>(w.died_ms - w.born_ms)));
+        obj.Set("fate",       Napi::String::New(env, WALL_FATE_NAMES[static_cast<size_t>(w.fate)]));
+        obj.Set("deathBps",   Napi::Number::New(env, w.death_bps));
+        obj.Set("filledQty",  Napi::Number::New(env, spec.toQty(w.filledLots())));
+    }
+    return obj;
+}
+
+Napi::Value GetWalls(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        static std::vector<WallRecord> live, dead;
+        std::array<std::array<uint64_t, WALL_FATES>, N_EXCHANGES> fates;
+        const int64_t now_ms = book.aggregator.getWalls(live, dead, fates);
+        const InstrumentSpec spec = book.aggregator.spec();
+
+        auto live_arr = Napi::Array::New(env, live.size());
+        for (size_t k = 0; k < live.size(); ++k) live_arr.Set(static_cast<uint32_t>(k), wallToJs(env, live[k], spec, now_ms));
+        auto dead_arr = Napi::Array::New(env, dead.size());
+        for (size_t k = 0; k < dead.size(); ++k) dead_arr.Set(static_cast<uint32_t>(k), wallToJs(env, dead[k], spec, now_ms));
+        auto counts = Napi::Object::New(env);
+        for (size_t v = 0; v < N_EXCHANGES; ++v) {
+            auto row = Napi::Object::New(env);
+            for (size_t f = 1; f < WALL_FATES; ++f) row.Set(WALL_FATE_NAMES[f], Napi::Number::New(env, static_cast<double>(fates[v][f])));
+            counts.Set(EXCHANGE_NAMES[v], row);
+        }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("ts",     Napi::Number::New(env, static_cast<double>(now_ms)));
+        obj.Set("live",   live_arr);
+        obj.Set("recent", dead_arr);
+        obj.Set("counts", counts);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: clearExchange(symbol, exchange)
+// Called when an exchange adapter disconnects
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ClearExchange(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        auto ex = parseExchange(info[1]);
+        if (ex != ExchangeID::MAX_EXCHANGES) {
+            book.aggregator.clearExchange(ex);
+            notifyBbo(env, book);
+        }
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: clearSymbol(symbol)
+// Drops every exchange book of one symbol; the id stays registered
+// ─────────────────────────────────────────────────────────────────
+Napi::Value ClearSymbol(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        auto& book = parseSymbol(info[0]);
+        book.aggregator.clearAll();
+        notifyBbo(env, book);
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ── BINDING: kalman1D(typedArray, R, Q) ───────────────────────────────────
+Napi::Value Kalman1D(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (!info[0].IsTypedArray()) {
+        Napi::TypeError::New(env, "TypedArray expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto input = info[0].As<Napi::Float64Array>();
+    double R = info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : 0.1;
+    double Q = info[2].IsNumber() ? info[2].As<Napi::Number>().DoubleValue() : 0.001;
+
+    size_t len = input.ElementLength();
+    if (len == 0) return Napi::Array::New(env, 0);
+
+    auto result = Napi::Float64Array::New(env, len);
+    double x = input[0];
+    double P = 1.0;
+
+    for (size_t i = 0; i < len; i++) {
+        P = P + Q;
+        double K = P / (P + R);
+        x = x + K * (input[i] - x);
         P = (1.0 - K) * P;
         result[i] = x;
     }
@@ -362,16 +2209,369 @@ Napi::Value NormalPdf(const Napi::CallbackInfo& info) { return Napi::Number::New
 Napi::Value NormalCdf(const Napi::CallbackInfo& info) { return Napi::Number::New(info.Env(), normalCdf(info[0].As<Napi::Number>().DoubleValue())); }
 Napi::Value NormalPpf(const Napi::CallbackInfo& info) { return Napi::Number::New(info.Env(), normalPpf(info[0].As<Napi::Number>().DoubleValue())); }
 
+// ─────────────────────────────────────────────────────────────────
+// BINDING: submitOrder(orderId, accountId, side, price, qty, liquidation?)
+//   → { status, fills: [{ taker, maker, takerAccount, makerAccount,
+//       price, qty, side }] }
+// A user order into the internal price-time CLOB (matching_engine.hpp).
+// price and qty are integer-scaled ticks / lots; price 0 (or liquidation)
+// is a market order. status: 'resting' | 'partial' | 'filled' |
+// 'cancelled' (market remainder without liquidity) | 'rejected'. fills:
+// the matches this order made, oldest first, at the makers' prices —
+// each also booked on both accounts by the RiskEngine (getRiskAccount).
+// ─────────────────────────────────────────────────────────────────
+static const char* ORDER_STATUS_NAMES[] = { "resting", "partial", "filled", "cancelled", "rejected" };
+
+MatchingEngine& matching() {
+    if (!g_matching) {
+        g_fills       = std::make_unique<FillRing>();
+        g_matching    = std::make_unique<MatchingEngine>(*g_fills);
+        g_risk_events = std::make_unique<RingBuffer<RingBufferEvent, 65536>>();
+        g_risk        = std::make_unique<RiskEngine>(*g_risk_events);
+    }
+    return *g_matching;
+}
+
+Napi::Value SubmitOrder(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 5) throw std::invalid_argument("Expected (orderId, accountId, side, price, qty, liquidation?)");
+        const TradeSide side = parseSide(info[2]);
+        if (side == TradeSide::UNKNOWN) throw std::invalid_argument("side must be 'buy' or 'sell'");
+        OrderPayload o{};
+        o.order_id       = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+        o.account_id     = static_cast<uint64_t>(info[1].As<Napi::Number>().Int64Value());
+        o.is_buy         = side == TradeSide::BUY;
+        o.price          = info[3].As<Napi::Number>().Int64Value();
+        o.quantity       = info[4].As<Napi::Number>().Int64Value();
+        o.is_liquidation = info.Length() > 5 && info[5].IsBoolean() && info[5].As<Napi::Boolean>().Value();
+        const OrderStatus status = matching().submit(o);
+
+        auto fills = Napi::Array::New(env);
+        Fill f;
+        for (uint32_t k = 0; g_fills->pop(f); ++k) {
+            g_risk->onFill(f);
+            auto fill = Napi::Object::New(env);
+            fill.Set("taker",        Napi::Number::New(env, static_cast<double>(f.taker_order_id)));
+            fill.Set("maker",        Napi::Number::New(env, static_cast<double>(f.maker_order_id)));
+            fill.Set("takerAccount", Napi::Number::New(env, static_cast<double>(f.taker_account_id)));
+            fill.Set("makerAccount", Napi::Number::New(env, static_cast<double>(f.maker_account_id)));
+            fill.Set("price",        Napi::Number::New(env, static_cast<double>(f.price)));
+            fill.Set("qty",          Napi::Number::New(env, static_cast<double>(f.quantity)));
+            fill.Set("side",         Napi::String::New(env, f.taker_is_buy ? "buy" : "sell"));
+            fills.Set(k, fill);
+        }
+        auto obj = Napi::Object::New(env);
+        obj.Set("status", Napi::String::New(env, ORDER_STATUS_NAMES[static_cast<size_t>(status)]));
+        obj.Set("fills",  fills);
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: cancelOrder(orderId) → boolean
+// false when the order is unknown, already filled or cancelled.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value CancelOrder(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1) throw std::invalid_argument("Expected (orderId)");
+        const uint64_t id = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+        return Napi::Boolean::New(env, matching().cancel(id));
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getMatchingBook(side?, price?) → { bestBid, bestAsk, resting,
+//   matches, cancels, droppedFills, depth? }
+// The internal book's touch (ticks, 0 = side empty) and counters; with
+// side ('buy' = bids) and price, depth = resting lots at that level.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetMatchingBook(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        const MatchingEngine& m = matching();
+        auto obj = Napi::Object::New(env);
+        obj.Set("bestBid",      Napi::Number::New(env, static_cast<double>(m.bestBid())));
+        obj.Set("bestAsk",      Napi::Number::New(env, static_cast<double>(m.bestAsk())));
+        obj.Set("resting",      Napi::Number::New(env, static_cast<double>(m.restingOrders())));
+        obj.Set("matches",      Napi::Number::New(env, static_cast<double>(m.matchCount())));
+        obj.Set("cancels",      Napi::Number::New(env, static_cast<double>(m.cancelCount())));
+        obj.Set("droppedFills", Napi::Number::New(env, static_cast<double>(m.droppedFills())));
+        if (info.Length() > 1) {
+            const TradeSide side = parseSide(info[0]);
+            if (side == TradeSide::UNKNOWN) throw std::invalid_argument("side must be 'buy' or 'sell'");
+            const int64_t depth = m.depthAt(side == TradeSide::BUY, info[1].As<Napi::Number>().Int64Value());
+            obj.Set("depth", Napi::Number::New(env, static_cast<double>(depth)));
+        }
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: getRiskAccount(accountId) → { position, entryPrice, balance,
+//   frozen } | null
+// The account the RiskEngine books fills on: signed position (lots),
+// volume-weighted entry (ticks) and wallet balance with realised PnL.
+// null before the account's first fill.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value GetRiskAccount(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    try {
+        if (info.Length() < 1) throw std::invalid_argument("Expected (accountId)");
+        matching();
+        const Account* acc = g_risk->find(static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value()));
+        if (!acc) return env.Null();
+        auto obj = Napi::Object::New(env);
+        obj.Set("position",   Napi::Number::New(env, static_cast<double>(acc->position_size)));
+        obj.Set("entryPrice", Napi::Number::New(env, static_cast<double>(acc->entry_price)));
+        obj.Set("balance",    Napi::Number::New(env, static_cast<double>(acc->wallet_balance)));
+        obj.Set("frozen",     Napi::Boolean::New(env, acc->is_frozen));
+        return obj;
+    } catch (const std::exception& e) {
+        Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: benchMatching(ops?) → { orders_per_sec, p50_ns, p99_ns, ... }
+// Synthetic load on a private MatchingEngine: ~75% limit orders around a
+// fixed mid (10% of them marketable), ~25% cancels of earlier ids.
+// Latency is per submit/cancel incl. draining its fills.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value BenchMatching(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    size_t ops = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 1000000;
+    if (ops == 0) ops = 1;
+
+    auto fills = std::make_unique<FillRing>();
+    auto engine = std::make_unique<MatchingEngine>(*fills, 1u << 18, 1u << 14);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return rng; };
+
+    constexpr int64_t MID = 6000000;   // $60,000.00
+    std::vector<uint64_t> ids;
+    ids.reserve(ops);
+    std::vector<uint32_t> lat_ns(ops);
+    uint64_t fill_count = 0;
+    uint64_t next_id = 1;
+
+    using clock = std::chrono::steady_clock;
+    const auto t_start = clock::now();
+
+    for (size_t i = 0; i < ops; ++i) {
+        uint64_t r = next();
+        const auto t0 = clock::now();
+
+        if (r % 100 < 25 && !ids.empty()) {
+            engine->cancel(ids[(r >> 8) % ids.size()]);
+        } else {
+            OrderPayload o{};
+            o.order_id   = next_id++;
+            o.account_id = 1 + (r >> 16) % 1000;
+            o.is_buy     = (r >> 8) & 1;
+            o.quantity   = 1 + (r >> 24) % 10;
+            int64_t offset = 1 + static_cast<int64_t>((r >> 32) % 50);
+            bool marketable = (r >> 40) % 10 == 0;
+            if (marketable) offset = -offset;
+            o.price = o.is_buy ? MID - offset : MID + offset;
+            engine->submit(o);
+            ids.push_back(o.order_id);
+        }
+
+        Fill f;
+        while (fills->pop(f)) ++fill_count;
+
+        lat_ns[i] = static_cast<uint32_t>(std::min<int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count(), UINT32_MAX));
+    }
+
+    const double elapsed_s = std::chrono::duration<double>(clock::now() - t_start).count();
+    std::sort(lat_ns.begin(), lat_ns.end());
+    auto pct = [&lat_ns](double p) { return static_cast<double>(lat_ns[static_cast<size_t>(p * (lat_ns.size() - 1))]); };
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("ops",            Napi::Number::New(env, static_cast<double>(ops)));
+    obj.Set("orders_per_sec", Napi::Number::New(env, ops / elapsed_s));
+    obj.Set("p50_ns",         Napi::Number::New(env, pct(0.50)));
+    obj.Set("p99_ns",         Napi::Number::New(env, pct(0.99)));
+    obj.Set("p999_ns",        Napi::Number::New(env, pct(0.999)));
+    obj.Set("max_ns",         Napi::Number::New(env, static_cast<double>(lat_ns.back())));
+    obj.Set("fills",          Napi::Number::New(env, static_cast<double>(fill_count)));
+    obj.Set("resting",        Napi::Number::New(env, static_cast<double>(engine->restingOrders())));
+    return obj;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// BINDING: benchJournal(dir, events?) → { events_per_sec, mb_per_sec, ... }
+// Sustained journal load on a private aggregator + journal: 3 exchanges
+// seeded with 500-level books, then deltas of 1–4 levels per side near
+// the touch (~20% deletes). Latency is per applyDelta incl. encoding;
+// mb_per_sec is record bytes over the time until close() has drained
+// everything to disk. The segment files are removed afterwards.
+// ─────────────────────────────────────────────────────────────────
+Napi::Value BenchJournal(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected journal directory").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    size_t events = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : 1000000;
+    if (events == 0) events = 1;
+
+    auto journal = std::make_unique<BookJournal>();
+    JournalOptions opts;
+    opts.dir = info[0].As<Napi::String>().Utf8Value();
+    if (!journal->open(opts)) {
+        Napi::Error::New(env, "Cannot open journal in " + opts.dir).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    auto agg = std::make_unique<CrossExchangeAggregator>();
+    agg->setJournal(journal.get(), 0, "BENCH");
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return rng; };
+
+    constexpr int64_t MID = 6000000;   // $60,000.00
+    constexpr ExchangeID EXCHANGES[] = { ExchangeID::BINANCE, ExchangeID::BYBIT, ExchangeID::OKX };
+    for (ExchangeID ex : EXCHANGES) {
+        LevelDeltas bids, asks;
+        for (int64_t k = 0; k < 500; ++k) {
+            bids.emplace_back(MID - 1 - k, static_cast<int64_t>(1 + next() % 5000000));
+            asks.emplace_back(MID + 1 + k, static_cast<int64_t>(1 + next() % 5000000));
+        }
+        agg->initSnapshot(ex, 0, bids, asks);
+    }
+
+    std::vector<uint32_t> lat_ns(events);
+    LevelDeltas bids, asks;
+    using clock = std::chrono::steady_clock;
+    const auto t_start = clock::now();
+
+    for (size_t i = 0; i < events; ++i) {
+        uint64_t r = next();
+        bids.clear();
+        asks.clear();
+        for (uint64_t k = 0, n = 1 + (r >> 8) % 4; k < n; ++k) {
+            const uint64_t q = next();
+            const int64_t lots = q % 5 == 0 ? 0 : static_cast<int64_t>(1 + (q >> 8) % 5000000);
+            bids.emplace_back(MID - 1 - static_cast<int64_t>((q >> 32) % 20), lots);
+        }
+        for (uint64_t k = 0, n = 1 + (r >> 16) % 4; k < n; ++k) {
+            const uint64_t q = next();
+            const int64_t lots = q % 5 == 0 ? 0 : static_cast<int64_t>(1 + (q >> 8) % 5000000);
+            asks.emplace_back(MID + 1 + static_cast<int64_t>((q >> 32) % 20), lots);
+        }
+
+        const auto t0 = clock::now();
+        agg->applyDelta(EXCHANGES[r % 3], 0, bids, asks);
+        lat_ns[i] = static_cast<uint32_t>(std::min<int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count(), UINT32_MAX));
+    }
+
+    const double produce_s = std::chrono::duration<double>(clock::now() - t_start).count();
+    agg->setJournal(nullptr);
+    journal->close();
+    const double elapsed_s = std::chrono::duration<double>(clock::now() - t_start).count();
+    const JournalStats st = journal->stats();
+    for (const auto& path : journal->segmentPaths()) std::remove(path.c_str());
+
+    std::sort(lat_ns.begin(), lat_ns.end());
+    auto pct = [&lat_ns](double p) { return static_cast<double>(lat_ns[static_cast<size_t>(p * (lat_ns.size() - 1))]); };
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("events",          Napi::Number::New(env, static_cast<double>(events)));
+    obj.Set("events_per_sec",  Napi::Number::New(env, events / elapsed_s));
+    obj.Set("produce_per_sec", Napi::Number::New(env, events / produce_s));
+    obj.Set("mb_per_sec",      Napi::Number::New(env, (st.bytes / 1048576.0) / elapsed_s));
+    obj.Set("bytes_per_event", Napi::Number::New(env, static_cast<double>(st.bytes) / events));
+    obj.Set("p50_ns",          Napi::Number::New(env, pct(0.50)));
+    obj.Set("p99_ns",          Napi::Number::New(env, pct(0.99)));
+    obj.Set("p999_ns",         Napi::Number::New(env, pct(0.999)));
+    obj.Set("segments",        Napi::Number::New(env, static_cast<double>(st.segments)));
+    obj.Set("dropped",         Napi::Number::New(env, static_cast<double>(st.dropped)));
+    obj.Set("ring_peak",       Napi::Number::New(env, static_cast<double>(st.ring_peak)));
+    return obj;
+}
+
 // ─────────────────────────────────────────────────────────────────
 // MODULE INIT — register all exported functions
 // ─────────────────────────────────────────────────────────────────
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("registerSymbol", Napi::Function::New(env, RegisterSymbol));
+    exports.Set("listSymbols",    Napi::Function::New(env, ListSymbols));
+    exports.Set("setInstrument",  Napi::Function::New(env, SetInstrument));
     exports.Set("initSnapshot",   Napi::Function::New(env, InitSnapshot));
     exports.Set("applyDelta",     Napi::Function::New(env, ApplyDelta));
+    exports.Set("applySequencedDelta",  Napi::Function::New(env, ApplySequencedDelta));
+    exports.Set("onResync",             Napi::Function::New(env, OnResync));
+    exports.Set("onBboEvent",           Napi::Function::New(env, OnBboEvent));
+    exports.Set("getSyncState",         Napi::Function::New(env, GetSyncState));
+    exports.Set("setChecksumVerify",    Napi::Function::New(env, SetChecksumVerify));
+    exports.Set("getChecksumState",     Napi::Function::New(env, GetChecksumState));
     exports.Set("getAggregated",  Napi::Function::New(env, GetAggregated));
+    exports.Set("getAggregatedIfNewer", Napi::Function::New(env, GetAggregatedIfNewer));
+    exports.Set("getAggregatedDiff",    Napi::Function::New(env, GetAggregatedDiff));
+    exports.Set("getBucketedDepth",     Napi::Function::New(env, GetBucketedDepth));
+    exports.Set("getCumulativeDepth",   Napi::Function::New(env, GetCumulativeDepth));
+    exports.Set("getDepthStats",        Napi::Function::New(env, GetDepthStats));
+    exports.Set("setDepthBands",        Napi::Function::New(env, SetDepthBands));
+    exports.Set("enableSharedMirror",   Napi::Function::New(env, EnableSharedMirror));
+    exports.Set("attachSharedMirror",   Napi::Function::New(env, AttachSharedMirror));
+    exports.Set("readSharedMirror",     Napi::Function::New(env, ReadSharedMirror));
+    exports.Set("detachSharedMirror",   Napi::Function::New(env, DetachSharedMirror));
     exports.Set("updateFunding",  Napi::Function::New(env, UpdateFunding));
     exports.Set("getVWAF",        Napi::Function::New(env, GetVWAF));
     exports.Set("clearExchange",  Napi::Function::New(env, ClearExchange));
+    exports.Set("clearSymbol",    Napi::Function::New(env, ClearSymbol));
+    exports.Set("setClock",       Napi::Function::New(env, SetClock));
+    exports.Set("advanceClock",   Napi::Function::New(env, AdvanceClock));
+    exports.Set("openJournal",    Napi::Function::New(env, OpenJournal));
+    exports.Set("closeJournal",   Napi::Function::New(env, CloseJournal));
+    exports.Set("getJournalStats", Napi::Function::New(env, GetJournalStats));
+    exports.Set("saveState",      Napi::Function::New(env, SaveState));
+    exports.Set("restoreState",   Napi::Function::New(env, RestoreState));
+    exports.Set("getJournalInfo", Napi::Function::New(env, GetJournalInfo));
+    exports.Set("openReplay",     Napi::Function::New(env, OpenReplay));
+    exports.Set("replayAdvance",  Napi::Function::New(env, ReplayAdvance));
+    exports.Set("getReplayBook",  Napi::Function::New(env, GetReplayBook));
+    exports.Set("closeReplay",    Napi::Function::New(env, CloseReplay));
+    exports.Set("enableDepthHistory",   Napi::Function::New(env, EnableDepthHistory));
+    exports.Set("recordDepthHistory",   Napi::Function::New(env, RecordDepthHistory));
+    exports.Set("getDepthHistoryStats", Napi::Function::New(env, GetDepthHistoryStats));
+    exports.Set("readDepthHistory",     Napi::Function::New(env, ReadDepthHistory));
+    exports.Set("ingestTrade",    Napi::Function::New(env, IngestTrade));
+    exports.Set("drainCandles",   Napi::Function::New(env, DrainCandles));
+    exports.Set("getFootprint",   Napi::Function::New(env, GetFootprint));
+    exports.Set("getTradeFlow",   Napi::Function::New(env, GetTradeFlow));
+    exports.Set("enableTradeTape", Napi::Function::New(env, EnableTradeTape));
+    exports.Set("getTapeTrades",  Napi::Function::New(env, GetTapeTrades));
+    exports.Set("getTapeCandles", Napi::Function::New(env, GetTapeCandles));
+    exports.Set("getTapeStats",   Napi::Function::New(env, GetTapeStats));
+    exports.Set("encodeCopy",     Napi::Function::New(env, EncodeCopy));
+    exports.Set("getBookSignals", Napi::Function::New(env, GetBookSignals));
+    exports.Set("getBookSignalSeries", Napi::Function::New(env, GetBookSignalSeries));
+    exports.Set("getBbo",              Napi::Function::New(env, GetBbo));
+    exports.Set("setBboConfig",        Napi::Function::New(env, SetBboConfig));
+    exports.Set("getLeadLag",          Napi::Function::New(env, GetLeadLag));
+    exports.Set("getWalls",            Napi::Function::New(env, GetWalls));
+    exports.Set("submitOrder",    Napi::Function::New(env, SubmitOrder));
+    exports.Set("cancelOrder",    Napi::Function::New(env, CancelOrder));
+    exports.Set("getMatchingBook", Napi::Function::New(env, GetMatchingBook));
+    exports.Set("getRiskAccount", Napi::Function::New(env, GetRiskAccount));
+    exports.Set("benchMatching",  Napi::Function::New(env, BenchMatching));
+    exports.Set("benchJournal",   Napi::Function::New(env, BenchJournal));
 
     // Math exports
     exports.Set("kalman1D",           Napi::Function::New(env, Kalman1D));
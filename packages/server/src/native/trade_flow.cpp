@@ -0,0 +1,2 @@
+#include "trade_flow.hpp"
+// Implementation is inline in header.
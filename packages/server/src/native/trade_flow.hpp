@@ -0,0 +1,165 @@
+#pragma once
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+// ── Trade flow ────────────────────────────────────────────────
+// Aggressor-side flow for one symbol, per venue and consolidated:
+// cumulative volume delta, trade counts, a histogram of trade notional,
+// and buy / sell volume over rolling windows for imbalance.
+//
+// Every update is O(1). A window is a ring of FLOW_SLOTS time slots with
+// running sums: a trade adds to the current slot, and moving into a new
+// slot subtracts and clears the ones that fell out — at most FLOW_SLOTS
+// of them however long the gap. Sums are therefore over the window
+// rounded to whole slots (window / FLOW_SLOTS resolution). Trades
+// stamped before the newest slot (a lagging venue) count in it.
+//
+// Fed by the ingestTrade binding, the one trade path into the addon; a
+// mutex covers it and the reads.
+
+constexpr size_t FLOW_VENUES  = static_cast<size_t>(ExchangeID::MAX_EXCHANGES) + 1;   // + consolidated
+constexpr size_t FLOW_ALL     = FLOW_VENUES - 1;
+constexpr size_t FLOW_WINDOWS = 4;
+constexpr size_t FLOW_SLOTS   = 50;   // divides every window evenly
+constexpr std::array<int64_t, FLOW_WINDOWS> FLOW_WINDOW_MS = { 1'000, 10'000, 60'000, 300'000 };
+
+// Trade notional (quote) histogram: < 100, < 1k, < 10k, < 100k, < 1M, ≥ 1M
+constexpr size_t FLOW_SIZE_BUCKETS = 6;
+
+struct FlowTotals {
+    double   cvd        = 0;   // Σ buy qty − Σ sell qty, base
+    double   cvd_quote  = 0;   // same in quote
+    double   buy_volume = 0;
+    double   sell_volume = 0;
+    uint64_t buys  = 0;
+    uint64_t sells = 0;
+    std::array<uint64_t, FLOW_SIZE_BUCKETS> size_count{};
+    std::array<double,   FLOW_SIZE_BUCKETS> size_volume{};   // base
+};
+
+struct FlowWindow {
+    double   buy    = 0;
+    double   sell   = 0;
+    uint32_t trades = 0;
+
+    // (buy − sell) / (buy + sell), 0 when idle
+    double imbalance() const { return buy + sell > 0 ? (buy - sell) / (buy + sell) : 0; }
+};
+
+struct TradeFlowSnapshot {
+    int64_t ts_ms = 0;
+    std::array<FlowTotals, FLOW_VENUES> totals;
+    std::array<std::array<FlowWindow, FLOW_VENUES>, FLOW_WINDOWS> windows;   // [window][venue]
+};
+
+class TradeFlowEngine {
+public:
+    // Venues without an ExchangeID count in the consolidated flow only
+    void add(ExchangeID ex, double price, double qty, bool is_buy, int64_t ts_ms) {
+        if (!(price > 0) || !(qty > 0) || !std::isfinite(price * qty)) return;
+        std::lock_guard lock(mutex_);
+        const size_t v = static_cast<size_t>(ex);
+        const double notional = price * qty;
+        size_t bucket = 0;
+        for (double edge = 100; bucket + 1 < FLOW_SIZE_BUCKETS && notional >= edge; edge *= 10) ++bucket;
+
+        count(totals_[FLOW_ALL], price, qty, is_buy, bucket);
+        if (v < FLOW_ALL) count(totals_[v], price, qty, is_buy, bucket);
+
+        for (size_t w = 0; w < FLOW_WINDOWS; ++w) {
+            Ring& ring = rings_[w];
+            advance(ring, w, ts_ms);
+            Slot& slot = ring.slots[ring.head % FLOW_SLOTS];
+            auto bump = [&](size_t at) {
+                (is_buy ? slot.buy[at] : slot.sell[at]) += qty;
+                (is_buy ? ring.sum.buy[at] : ring.sum.sell[at]) += qty;
+                ++slot.trades[at];
+                ++ring.sum.trades[at];
+            };
+            bump(FLOW_ALL);
+            if (v < FLOW_ALL) bump(v);
+        }
+    }
+
+    // Windows are expired up to now_ms first
+    TradeFlowSnapshot snapshot(int64_t now_ms) {
+        std::lock_guard lock(mutex_);
+        TradeFlowSnapshot s;
+        s.ts_ms  = now_ms;
+        s.totals = totals_;
+        for (size_t w = 0; w < FLOW_WINDOWS; ++w) {
+            advance(rings_[w], w, now_ms);
+            const Slot& sum = rings_[w].sum;
+            for (size_t v = 0; v < FLOW_VENUES; ++v) {
+                // Floating sums drift; a window that emptied reads as zero
+                s.windows[w][v] = sum.trades[v] ? FlowWindow{ std::max(0.0, sum.buy[v]), std::max(0.0, sum.sell[v]), sum.trades[v] }
+                                                : FlowWindow{};
+            }
+        }
+        return s;
+    }
+
+    void reset() {
+        std::lock_guard lock(mutex_);
+        totals_ = {};
+        rings_  = {};
+    }
+
+private:
+    struct Slot {
+        std::array<double,   FLOW_VENUES> buy{};
+        std::array<double,   FLOW_VENUES> sell{};
+        std::array<uint32_t, FLOW_VENUES> trades{};
+    };
+
+    struct Ring {
+        std::array<Slot, FLOW_SLOTS> slots{};
+        Slot    sum;
+        int64_t head = -1;   // absolute slot number of the newest slot
+    };
+
+    static void count(FlowTotals& t, double price, double qty, bool is_buy, size_t bucket) {
+        const double sign = is_buy ? 1.0 : -1.0;
+        t.cvd       += sign * qty;
+        t.cvd_quote += sign * qty * price;
+        if (is_buy) {
+            t.buy_volume += qty;
+            ++t.buys;
+        } else {
+            t.sell_volume += qty;
+            ++t.sells;
+        }
+        ++t.size_count[bucket];
+        t.size_volume[bucket] += qty;
+    }
+
+    // Move the ring's head to ts_ms's slot, retiring what fell out
+    static void advance(Ring& ring, size_t w, int64_t ts_ms) {
+        const int64_t slot_ms = FLOW_WINDOW_MS[w] / static_cast<int64_t>(FLOW_SLOTS);
+        const int64_t n = ts_ms / slot_ms;
+        if (ring.head < 0) {
+            ring.head = n;
+            return;
+        }
+        if (n <= ring.head) return;
+        const int64_t steps = std::min<int64_t>(n - ring.head, FLOW_SLOTS);
+        for (int64_t i = 1; i <= steps; ++i) {
+            Slot& old = ring.slots[(ring.head + i) % FLOW_SLOTS];
+            for (size_t v = 0; v < FLOW_VENUES; ++v) {
+                ring.sum.buy[v]    -= old.buy[v];
+                ring.sum.sell[v]   -= old.sell[v];
+                ring.sum.trades[v] -= old.trades[v];
+            }
+            old = Slot{};
+        }
+        ring.head = n;
+    }
+
+    std::mutex mutex_;
+    std::array<FlowTotals, FLOW_VENUES> totals_;
+    std::array<Ring, FLOW_WINDOWS>      rings_;
+};
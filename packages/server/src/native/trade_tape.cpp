@@ -0,0 +1,2 @@
+#include "trade_tape.hpp"
+// Implementation is inline in header.
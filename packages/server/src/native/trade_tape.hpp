@@ -0,0 +1,233 @@
+#pragma once
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// ── Trade tape ────────────────────────────────────────────────
+// The last few hours of a symbol's trades, all venues, in memory, so
+// recent-history queries (trade lists, candles at any interval) never go
+// to the database.
+//
+// Trades are stored column-wise in fixed chunks of TAPE_CHUNK rows —
+// time, price, qty, side, venue — appended in arrival order. Times are
+// kept non-decreasing: a trade stamped before the previous one (a venue
+// lagging another) takes the previous time, as the candle engine folds
+// it into the open candle. Each chunk's time column is therefore sorted,
+// and the chunks' first / last times are the sparse index: a range query
+// binary-searches the chunk list, then the time column of the edge
+// chunks. Chunks older than the retention are recycled.
+//
+// Single-threaded: appends and queries both run on the JS thread.
+
+constexpr size_t TAPE_CHUNK = 16384;
+
+// One resampled candle, TAPE_CANDLE_FIELDS doubles:
+//   [open_time_ms, open, high, low, close, volume, quote_volume,
+//    buy_volume, sell_volume, trades]
+constexpr size_t TAPE_CANDLE_FIELDS = 10;
+
+struct TapeChunk {
+    size_t size = 0;
+    std::array<int64_t, TAPE_CHUNK> ts;
+    std::array<double,  TAPE_CHUNK> price;
+    std::array<double,  TAPE_CHUNK> qty;
+    std::array<int8_t,  TAPE_CHUNK> side;       // +1 aggressive buy, −1 sell, 0 unknown
+    std::array<uint8_t, TAPE_CHUNK> exchange;   // ExchangeID; MAX_EXCHANGES = other venue
+
+    int64_t firstMs() const { return ts[0]; }
+    int64_t lastMs()  const { return ts[size - 1]; }
+};
+
+// Columns of a range query
+struct TapeTrades {
+    std::vector<int64_t> ts;
+    std::vector<double>  price;
+    std::vector<double>  qty;
+    std::vector<int8_t>  side;
+    std::vector<uint8_t> exchange;
+    bool truncated = false;   // more trades in range than the limit
+
+    size_t size() const { return ts.size(); }
+};
+
+struct TapeStats {
+    size_t   trades   = 0;
+    size_t   chunks   = 0;
+    size_t   bytes    = 0;
+    int64_t  first_ms = 0;    // oldest trade held, 0 when empty
+    int64_t  last_ms  = 0;
+    uint64_t appended = 0;    // all time
+};
+
+class TradeTape {
+public:
+    // Keep `retention_ms` of trades; 0 stops recording and frees the tape
+    void setRetention(int64_t retention_ms) {
+        retention_ms_ = std::max<int64_t>(0, retention_ms);
+        if (retention_ms_ == 0) {
+            chunks_.clear();
+            spare_.reset();
+        }
+    }
+    bool enabled() const { return retention_ms_ > 0; }
+
+    void append(int64_t ts_ms, double price, double qty, int8_t side, ExchangeID ex) {
+        if (!enabled() || !(price > 0) || !(qty >= 0)) return;
+        if (!chunks_.empty()) ts_ms = std::max(ts_ms, chunks_.back()->lastMs());
+        if (chunks_.empty() || chunks_.back()->size == TAPE_CHUNK) {
+            chunks_.push_back(newChunk());
+            expire(ts_ms);
+        }
+        TapeChunk& c = *chunks_.back();
+        const size_t i = c.size++;
+        c.ts[i]       = ts_ms;
+        c.price[i]    = price;
+        c.qty[i]      = qty;
+        c.side[i]     = side;
+        c.exchange[i] = static_cast<uint8_t>(ex);
+        ++appended_;
+    }
+
+    // Trades with from_ms ≤ time ≤ to_ms, oldest first, at most `limit`
+    // (the newest `limit` when `latest`)
+    void range(int64_t from_ms, int64_t to_ms, size_t limit, bool latest, TapeTrades& out) const {
+        out = TapeTrades{};
+        Cursor lo = lowerBound(from_ms), hi = lowerBound(to_ms + 1);
+        const size_t n = count(lo, hi);
+        if (n > limit) {
+            out.truncated = true;
+            if (latest) lo = advance(lo, n - limit);
+            else        hi = advance(lo, limit);
+        }
+        const size_t take = std::min(n, limit);
+        out.ts.reserve(take);
+        out.price.reserve(take);
+        out.qty.reserve(take);
+        out.side.reserve(take);
+        out.exchange.reserve(take);
+        forEachSpan(lo, hi, [&](const TapeChunk& c, size_t b, size_t e) {
+            out.ts.insert(out.ts.end(), c.ts.begin() + b, c.ts.begin() + e);
+            out.price.insert(out.price.end(), c.price.begin() + b, c.price.begin() + e);
+            out.qty.insert(out.qty.end(), c.qty.begin() + b, c.qty.begin() + e);
+            out.side.insert(out.side.end(), c.side.begin() + b, c.side.begin() + e);
+            out.exchange.insert(out.exchange.end(), c.exchange.begin() + b, c.exchange.begin() + e);
+        });
+    }
+
+    // Candles of `interval_ms` (aligned to the epoch) over [from_ms, to_ms],
+    // TAPE_CANDLE_FIELDS doubles each; intervals without trades are left out.
+    size_t resample(int64_t from_ms, int64_t to_ms, int64_t interval_ms, std::vector<double>& out) const {
+        out.clear();
+        if (interval_ms <= 0) return 0;
+        // The open bar lives in locals; times are sorted, so the division
+        // only runs on leaving a bar
+        int64_t open = 0, bar_end = INT64_MIN;
+        double o = 0, h = 0, l = 0, cl = 0, vol = 0, quote = 0, buy = 0, sell = 0, n = 0;
+        auto flush = [&] {
+            if (n > 0) out.insert(out.end(), { static_cast<double>(open), o, h, l, cl, vol, quote, buy, sell, n });
+        };
+        forEachSpan(lowerBound(from_ms), lowerBound(to_ms + 1), [&](const TapeChunk& c, size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const double p = c.price[i], q = c.qty[i];
+                if (c.ts[i] >= bar_end) {
+                    flush();
+                    open    = floorDiv(c.ts[i], interval_ms) * interval_ms;
+                    bar_end = open + interval_ms;
+                    o = h = l = p;
+                    vol = quote = buy = sell = n = 0;
+                }
+                h = std::max(h, p);
+                l = std::min(l, p);
+                cl = p;
+                vol   += q;
+                quote += p * q;
+                buy   += c.side[i] > 0 ? q : 0;
+                sell  += c.side[i] < 0 ? q : 0;
+                n     += 1;
+            }
+        });
+        flush();
+        return out.size() / TAPE_CANDLE_FIELDS;
+    }
+
+    TapeStats stats() const {
+        TapeStats s;
+        for (const auto& c : chunks_) s.trades += c->size;
+        s.chunks   = chunks_.size();
+        s.bytes    = (chunks_.size() + (spare_ ? 1 : 0)) * sizeof(TapeChunk);
+        s.first_ms = chunks_.empty() ? 0 : chunks_.front()->firstMs();
+        s.last_ms  = chunks_.empty() ? 0 : chunks_.back()->lastMs();
+        s.appended = appended_;
+        return s;
+    }
+
+private:
+    // Position in the tape: chunk, row within it
+    struct Cursor {
+        size_t chunk = 0;
+        size_t row   = 0;
+    };
+
+    static int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+    // First trade with time ≥ ts_ms (one past the end if none)
+    Cursor lowerBound(int64_t ts_ms) const {
+        const auto it = std::partition_point(chunks_.begin(), chunks_.end(),
+                                             [ts_ms](const auto& c) { return c->lastMs() < ts_ms; });
+        if (it == chunks_.end()) return Cursor{ chunks_.size(), 0 };
+        const TapeChunk& c = **it;
+        const size_t row = static_cast<size_t>(std::lower_bound(c.ts.begin(), c.ts.begin() + c.size, ts_ms) - c.ts.begin());
+        return Cursor{ static_cast<size_t>(it - chunks_.begin()), row };
+    }
+
+    size_t count(Cursor lo, Cursor hi) const {
+        size_t n = 0;
+        forEachSpan(lo, hi, [&n](const TapeChunk&, size_t b, size_t e) { n += e - b; });
+        return n;
+    }
+
+    Cursor advance(Cursor at, size_t n) const {
+        while (at.chunk < chunks_.size()) {
+            const size_t left = chunks_[at.chunk]->size - at.row;
+            if (n < left) return Cursor{ at.chunk, at.row + n };
+            n -= left;
+            at = Cursor{ at.chunk + 1, 0 };
+        }
+        return at;
+    }
+
+    // fn(chunk, begin row, end row) over [lo, hi)
+    template <typename Fn>
+    void forEachSpan(Cursor lo, Cursor hi, Fn&& fn) const {
+        for (size_t k = lo.chunk; k < chunks_.size() && k <= hi.chunk; ++k) {
+            const TapeChunk& c = *chunks_[k];
+            const size_t b = k == lo.chunk ? lo.row : 0;
+            const size_t e = k == hi.chunk ? hi.row : c.size;
+            if (b < e) fn(c, b, e);
+        }
+    }
+
+    // Drop whole chunks that ended before the retention window; the
+    // newest dropped one is kept as the next chunk's storage.
+    void expire(int64_t now_ms) {
+        while (chunks_.size() > 1 && chunks_.front()->lastMs() < now_ms - retention_ms_) {
+            spare_ = std::move(chunks_.front());
+            chunks_.pop_front();
+        }
+    }
+
+    std::unique_ptr<TapeChunk> newChunk() {
+        std::unique_ptr<TapeChunk> c = spare_ ? std::move(spare_) : std::make_unique<TapeChunk>();
+        c->size = 0;
+        return c;
+    }
+
+    std::deque<std::unique_ptr<TapeChunk>> chunks_;
+    std::unique_ptr<TapeChunk> spare_;
+    int64_t  retention_ms_ = 0;
+    uint64_t appended_     = 0;
+};
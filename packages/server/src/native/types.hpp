@@ -1,14 +1,24 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+#include <cmath>
 #include <string>
 #include <array>
+#include <type_traits>
 
 // Represent price as integer to avoid float comparison issues.
-// All prices multiplied by PRICE_SCALE = 100 (2 decimal places for BTC).
-// e.g. $63,500.50 → 6350050
-// For SOL/ETH with more decimals, use PRICE_SCALE = 10000
+// Prices are multiplied by a per-instrument scale (see InstrumentSpec);
+// PRICE_SCALE = 100 is the default (2 decimal places for BTC).
+// e.g. $63,500.50 → 6350050; SOL at scale 10000: $142.1234 → 1421234
 
-constexpr int64_t PRICE_SCALE = 100;
+constexpr int64_t PRICE_SCALE     = 100;
+constexpr int64_t MAX_PRICE_SCALE = 1000000000000LL;   // 1e12 — room for sub-satoshi alts
+
+// Quantities are fixed-point too: int64 lots, QTY_SCALE lots per unit by
+// default (6 decimals). Sums stay exact under incremental add/remove, and
+// 9.2e12 units of headroom cover even 1000PEPE-sized books.
+constexpr int64_t QTY_SCALE     = 1000000;
+constexpr int64_t MAX_QTY_SCALE = 1000000000LL;        // 1e9
 constexpr size_t  MAX_LEVELS  = 1000;  // max tracked levels per side per exchange
 constexpr size_t  OUTPUT_LEVELS = 50;  // how many levels we return to Node.js
 
@@ -26,11 +36,64 @@ enum class ExchangeID : uint8_t {
 // A single price level — 16 bytes, cache-line friendly
 struct Level {
     int64_t price_raw;  // integer-scaled price
-    double  qty;        // float is fine for qty — no comparison needed
+    int64_t qty_lots;   // fixed-point quantity (InstrumentSpec::qty_scale per unit)
+
+    double price_f(int64_t scale) const { return static_cast<double>(price_raw) / scale; }
+    double qty_f(int64_t scale)   const { return static_cast<double>(qty_lots) / scale; }
+};
+
+// ── Per-instrument price / quantity scaling ──────────────────────
+// Each book carries its own scales so integer keys and sums are exact for
+// every instrument: a scale is the power of ten that makes the tick (or
+// lot) integral (BTC tick 0.1 → 100, SOL 0.0001 → 10000, PEPE 1e-10 → 1e10).
+struct InstrumentSpec {
+    int64_t price_scale = PRICE_SCALE;   // raw units per 1.0 quote
+    int64_t tick_raw    = 1;             // minimum price increment, raw units
+    int64_t qty_scale   = QTY_SCALE;     // lots per 1.0 base unit
+
+    int64_t toRaw(double price)   const { return static_cast<int64_t>(std::llround(price * price_scale)); }
+    double  toPrice(int64_t raw)  const { return static_cast<double>(raw) / price_scale; }
+    double  tickSize()            const { return toPrice(tick_raw); }
+    int64_t toLots(double qty)    const { return static_cast<int64_t>(std::llround(qty * qty_scale)); }
+    double  toQty(int64_t lots)   const { return static_cast<double>(lots) / qty_scale; }
+
+    // Smallest power of ten in [min_scale, max_scale] with unit * scale integral
+    static int64_t exactScale(double unit, int64_t min_scale, int64_t max_scale) {
+        int64_t scale = min_scale;
+        while (scale < max_scale) {
+            double units = unit * scale;
+            if (units >= 1 && std::abs(units - std::round(units)) < 1e-6 * units) break;
+            scale *= 10;
+        }
+        return scale;
+    }
 
-    double price_f() const { return static_cast<double>(price_raw) / PRICE_SCALE; }
+    // Price scale from `tick`; qty scale from `lot` when given (> 0)
+    static InstrumentSpec fromTick(double tick, double lot = 0) {
+        InstrumentSpec spec;
+        if (tick > 0) {
+            spec.price_scale = exactScale(tick, PRICE_SCALE, MAX_PRICE_SCALE);
+            spec.tick_raw = std::max<int64_t>(1, spec.toRaw(tick));
+        }
+        if (lot > 0) spec.qty_scale = exactScale(lot, 1, MAX_QTY_SCALE);
+        return spec;
+    }
 };
 
+// Runs `f` with the scale as a compile-time constant for the common
+// powers of ten, so per-level conversion loops specialise on it; any
+// other scale is passed through as a plain runtime int64_t.
+template<typename F>
+decltype(auto) withPriceScale(int64_t scale, F&& f) {
+    switch (scale) {
+        case 100:       return f(std::integral_constant<int64_t, 100>{});
+        case 10000:     return f(std::integral_constant<int64_t, 10000>{});
+        case 1000000:   return f(std::integral_constant<int64_t, 1000000>{});
+        case 100000000: return f(std::integral_constant<int64_t, 100000000>{});
+        default:        return f(scale);
+    }
+}
+
 // A wall detection result
 struct Wall {
     double price;
@@ -58,6 +121,9 @@ struct AggregatedSnapshot {
     double  best_ask;
     double  spread;
     double  mid_price;
+
+    int64_t price_scale;   // scale of bids/asks price_raw (self-describing for shm readers)
+    int64_t qty_scale;     // scale of bids/asks qty_lots
 };
 
 // Funding data per exchange — fed from JS adapters
@@ -81,3 +147,58 @@ struct VWAFResult {
     bool   active[static_cast<size_t>(ExchangeID::MAX_EXCHANGES)];
     int    sentiment;  // -2=extreme_short, -1=short, 0=neutral, 1=long, 2=extreme_long
 };
+
+// ── Ring buffer events ───────────────────────────────────────────
+// Fixed-size POD events passed ingestor → execution engine through the
+// SPSC RingBuffer. Payload is a union so every event is one slot.
+
+enum class EventType : uint8_t {
+    MARKET_UPDATE = 0,
+    TRADE         = 1,
+    ORACLE_TICK   = 2,
+    USER_ORDER    = 3,
+    CANCEL_ORDER  = 4,
+    LIQUIDATION   = 5
+};
+
+struct MarketPayload {
+    ExchangeID source;
+    bool       is_bid;        // for TRADE: true = aggressive buy
+    bool       is_snapshot;
+    int64_t    price;         // integer-scaled (PRICE_SCALE)
+    double     qty;
+    int64_t    timestamp;     // unix ms, 0 = stamped by engine
+};
+
+struct OraclePayload {
+    int64_t price;            // integer-scaled mark price
+    int64_t timestamp;
+};
+
+struct OrderPayload {
+    uint64_t order_id;
+    uint64_t account_id;
+    int64_t  price;           // integer-scaled limit price, 0 = market
+    int64_t  quantity;        // contracts (integer lots)
+    bool     is_buy;
+    bool     is_liquidation;
+};
+
+struct RingBufferEvent {
+    EventType type;
+    union {
+        MarketPayload market;
+        OraclePayload oracle;
+        OrderPayload  order;
+    } payload;
+};
+
+// Internal margin account — owned by RiskEngine
+struct Account {
+    uint64_t account_id             = 0;
+    int64_t  wallet_balance         = 0;   // integer-scaled quote
+    int64_t  position_size          = 0;   // signed contracts
+    int64_t  entry_price            = 0;   // integer-scaled
+    int64_t  maintenance_margin_bps = 0;
+    bool     is_frozen              = false;
+};
@@ -1,9 +1,10 @@
 #pragma once
 #include "types.hpp"
+#include "clock.hpp"
+#include "book_journal.hpp"
 #include <array>
 #include <mutex>
 #include <cmath>
-#include <chrono>
 
 // Move VWAF computation from JS into C++ alongside the orderbook.
 // Node.js calls updateFunding() from each exchange adapter's funding poll.
@@ -11,6 +12,12 @@
 
 class VWAFEngine {
 public:
+    // Freshness is judged on this clock (clock.hpp); not owned
+    void setClock(Clock& clock) {
+        std::lock_guard lock(mutex_);
+        clock_ = &clock;
+    }
+
     void updateFunding(ExchangeID ex, double rate, double oi_usd, int64_t ts_ms) {
         std::lock_guard lock(mutex_);
         size_t i = static_cast<size_t>(ex);
@@ -25,7 +32,7 @@ public:
 
         VWAFResult r{};
         double total_oi = 0;
-        int64_t now_ms = currentMs();
+        int64_t now_ms = clock_->nowMs();
 
         // Sum OI from exchanges with fresh data (< 90s old)
         for (size_t i = 0; i < N_EX; ++i) {
@@ -79,6 +86,42 @@ public:
         return r;
     }
 
+    // Warm restart (state_snapshot.hpp): the last funding report per
+    // exchange, with its original timestamp — freshness still ages out
+    // anything the restart outlived.
+    void saveState(JournalCodec::Buffer& out) const {
+        std::lock_guard lock(mutex_);
+        out.varint(N_EX);
+        for (size_t i = 0; i < N_EX; ++i) {
+            out.u8(active_[i] ? 1 : 0);
+            out.f64(rates_[i]);
+            out.f64(oi_usd_[i]);
+            out.zz(ts_[i]);
+        }
+    }
+
+    bool restoreState(const uint8_t*& p, const uint8_t* end) {
+        using namespace JournalCodec;
+        uint64_t n;
+        if (!getVarint(p, end, n) || n > N_EX) return false;
+        std::array<double,  N_EX> rates{}, oi{};
+        std::array<int64_t, N_EX> ts{};
+        std::array<bool,    N_EX> active{};
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t t;
+            if (p >= end) return false;
+            active[i] = *p++ != 0;
+            if (!getF64(p, end, rates[i]) || !getF64(p, end, oi[i]) || !getVarint(p, end, t)) return false;
+            ts[i] = unzigzag(t);
+        }
+        std::lock_guard lock(mutex_);
+        rates_ = rates;
+        oi_usd_ = oi;
+        ts_ = ts;
+        active_ = active;
+        return true;
+    }
+
     void clear() {
         std::lock_guard lock(mutex_);
         active_.fill(false);
@@ -92,9 +135,5 @@ private:
     std::array<double,  N_EX> oi_usd_{};
     std::array<int64_t, N_EX> ts_{};
     std::array<bool,    N_EX> active_{};
-
-    static int64_t currentMs() {
-        using namespace std::chrono;
-        return duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-    }
+    Clock* clock_ = &Clock::process();
 };
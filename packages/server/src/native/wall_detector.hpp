@@ -7,31 +7,29 @@
 namespace WallDetector {
     constexpr double WALL_THRESHOLD_PCT = 0.03;  // level > 3% of total depth = wall
 
-    inline void detect(AggregatedSnapshot& snap) {
-        double total_bid_qty = 0, total_ask_qty = 0;
-        for (size_t i = 0; i < snap.bid_count; ++i) total_bid_qty += snap.bids[i].qty;
-        for (size_t i = 0; i < snap.ask_count; ++i) total_ask_qty += snap.asks[i].qty;
-
+    // Totals are the lots summed over snap.bids / snap.asks, which the
+    // aggregator accumulates while filling them.
+    inline void detect(AggregatedSnapshot& snap, int64_t total_bid_lots, int64_t total_ask_lots) {
         snap.bid_wall_count = 0;
         snap.ask_wall_count = 0;
 
-        if (total_bid_qty > 0) {
+        if (total_bid_lots > 0) {
             for (size_t i = 0; i < snap.bid_count && snap.bid_wall_count < 8; ++i) {
-                double pct = snap.bids[i].qty / total_bid_qty;
+                double pct = static_cast<double>(snap.bids[i].qty_lots) / total_bid_lots;
                 if (pct >= WALL_THRESHOLD_PCT) {
                     snap.bid_walls[snap.bid_wall_count++] = Wall{
-                        snap.bids[i].price_f(), snap.bids[i].qty, pct, true
+                        snap.bids[i].price_f(snap.price_scale), snap.bids[i].qty_f(snap.qty_scale), pct, true
                     };
                 }
             }
         }
 
-        if (total_ask_qty > 0) {
+        if (total_ask_lots > 0) {
             for (size_t i = 0; i < snap.ask_count && snap.ask_wall_count < 8; ++i) {
-                double pct = snap.asks[i].qty / total_ask_qty;
+                double pct = static_cast<double>(snap.asks[i].qty_lots) / total_ask_lots;
                 if (pct >= WALL_THRESHOLD_PCT) {
                     snap.ask_walls[snap.ask_wall_count++] = Wall{
-                        snap.asks[i].price_f(), snap.asks[i].qty, pct, false
+                        snap.asks[i].price_f(snap.price_scale), snap.asks[i].qty_f(snap.qty_scale), pct, false
                     };
                 }
             }
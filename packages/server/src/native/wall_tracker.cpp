@@ -0,0 +1,2 @@
+#include "wall_tracker.hpp"
+// Implementation is inline in header.
@@ -0,0 +1,303 @@
+#pragma once
+#include "orderbook.hpp"
+#include "sequence_guard.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// ── Wall tracker ──────────────────────────────────────────────
+// Follows each venue's large resting levels ("walls") from birth to
+// death at delta resolution, where WallDetector only sees the merged
+// snapshot of the moment.
+//
+//   birth  a level within WALL_RANGE_BPS of its touch reaches
+//          WALL_MULTIPLE × the mean size of the side's top WALL_SCAN levels
+//   life   every size change is recorded (first + latest WALL_HISTORY
+//          points), split into decreases at the touch (nothing better
+//          quoted) and behind it, alongside the traded volume at or
+//          through the price
+//   death  the level falls below WALL_DEATH_FRACTION of its peak or is
+//          removed; leaves the range; or the book is reset / resnapshotted
+//          without it
+//
+// How a wall went: FILLED when at least half of what left it traded —
+// measured against the venue's trades while they are being ingested
+// (a trade up to WALL_FILL_GRACE_MS after the death still counts), by
+// the decreases at the touch otherwise; SPOOFED when it was mostly
+// cancelled with the price closing in (within WALL_APPROACH_BPS at
+// death, nearer than at birth); PULLED when cancelled otherwise.
+//
+// Called by CrossExchangeAggregator with its write lock held.
+
+constexpr size_t  WALL_SCAN           = 20;
+constexpr int64_t WALL_MULTIPLE       = 5;
+constexpr double  WALL_RANGE_BPS      = 100;
+constexpr double  WALL_DEATH_FRACTION = 0.4;
+constexpr double  WALL_APPROACH_BPS   = 10;
+constexpr size_t  WALL_MAX_LIVE       = 16;       // per venue and side
+constexpr size_t  WALL_HISTORY        = 64;
+constexpr size_t  WALL_DEATHS         = 256;      // recent deaths kept, all venues
+constexpr int64_t WALL_FILL_GRACE_MS  = 1'000;
+constexpr int64_t WALL_TRADE_FEED_MS  = 60'000;   // trades this recent = the venue's feed is live
+
+enum class WallFate : uint8_t { LIVE, FILLED, PULLED, SPOOFED, OUT_OF_RANGE, RESET };
+constexpr size_t WALL_FATES = 6;
+
+struct WallPoint {
+    int64_t ts_ms;
+    int64_t lots;
+};
+
+struct WallRecord {
+    uint64_t id            = 0;
+    uint8_t  exchange      = 0;
+    bool     is_bid        = true;
+    int64_t  price_raw     = 0;
+    int64_t  born_ms       = 0;
+    int64_t  died_ms       = 0;   // 0 = live
+    int64_t  lots          = 0;
+    int64_t  peak_lots     = 0;
+    int64_t  at_touch_lots = 0;   // decreases with nothing better quoted
+    int64_t  behind_lots   = 0;   // decreases behind the touch
+    int64_t  traded_lots   = 0;   // venue trades at or through the price
+    bool     trade_fed     = false;   // venue trades were flowing at death
+    double   birth_bps     = 0;   // distance from the touch
+    double   min_bps       = 0;
+    double   death_bps     = 0;
+    WallFate fate          = WallFate::LIVE;
+    std::vector<WallPoint> history;
+
+    int64_t removedLots() const { return at_touch_lots + behind_lots; }
+    int64_t filledLots() const { return std::min(removedLots(), trade_fed ? traded_lots : at_touch_lots); }
+};
+
+template <size_t N>
+class WallTracker {
+public:
+    // Deltas just applied to venue v's book; touch_moved = its best moved
+    void onDeltas(size_t v, const ExchangeBook& book, const LevelDeltas& bids, const LevelDeltas& asks,
+                  bool touch_moved, int64_t now_ms) {
+        if (v >= N) return;
+        int64_t bid_thr = -1, ask_thr = -1;
+        for (const auto& [px, lots] : bids) level(v, true, px, lots, book, bid_thr, now_ms);
+        for (const auto& [px, lots] : asks) level(v, false, px, lots, book, ask_thr, now_ms);
+        if (touch_moved) touchMoved(v, book, now_ms);
+    }
+
+    // One level of venue v (the ingestor path)
+    void onLevel(size_t v, bool is_bid, int64_t px, int64_t lots, const ExchangeBook& book,
+                 bool touch_moved, int64_t now_ms) {
+        if (v >= N) return;
+        int64_t thr = -1;
+        level(v, is_bid, px, lots, book, thr, now_ms);
+        if (touch_moved) touchMoved(v, book, now_ms);
+    }
+
+    // Venue v's book was replaced: walls missing from it are reset, the
+    // rest carry on, and the new book is scanned for walls
+    void onSnapshot(size_t v, const ExchangeBook& book, int64_t now_ms) {
+        if (v >= N) return;
+        rescan(v, true, book.bids, book, now_ms);
+        rescan(v, false, book.asks, book, now_ms);
+        touchMoved(v, book, now_ms);
+    }
+
+    void onClear(size_t v, int64_t now_ms) {
+        if (v >= N) return;
+        for (int s = 0; s < 2; ++s) {
+            auto& walls = live_[v][s];
+            while (!walls.empty()) die(walls, walls.size() - 1, WallFate::RESET, now_ms);
+        }
+        last_trade_ms_[v] = 0;
+    }
+
+    // A trade on venue v; side +1 = buyer lifted asks, −1 = seller hit bids
+    void onTrade(size_t v, int64_t px, int64_t lots, int8_t side, int64_t now_ms) {
+        if (v >= N || side == 0) return;
+        last_trade_ms_[v] = now_ms;
+        const bool hits_bids = side < 0;
+        auto through = [&](const WallRecord& w) { return hits_bids ? px <= w.price_raw : px >= w.price_raw; };
+        for (auto& w : live_[v][hits_bids ? 0 : 1]) {
+            if (through(w)) w.traded_lots += lots;
+        }
+        // Trades reported after the delta that removed the wall
+        for (auto it = deaths_.rbegin(); it != deaths_.rend() && it->died_ms >= now_ms - WALL_FILL_GRACE_MS; ++it) {
+            WallRecord& w = *it;
+            if (w.exchange != v || w.is_bid != hits_bids || !through(w)) continue;
+            if (w.fate != WallFate::PULLED && w.fate != WallFate::SPOOFED && w.fate != WallFate::FILLED) continue;
+            w.traded_lots += lots;
+            w.trade_fed = true;
+            recount(w, classify(w));
+        }
+    }
+
+    // Live walls (ages from born_ms) and the most recent deaths, oldest first
+    void collect(std::vector<WallRecord>& live, std::vector<WallRecord>& dead) const {
+        live.clear();
+        dead.assign(deaths_.begin(), deaths_.end());
+        for (const auto& venue : live_) {
+            for (const auto& side : venue) live.insert(live.end(), side.begin(), side.end());
+        }
+    }
+
+    // Deaths by fate per venue since the last reset: [venue][fate]
+    const std::array<std::array<uint64_t, WALL_FATES>, N>& counts() const { return counts_; }
+
+    // Forget every wall, death and trade time; ids keep counting up
+    void reset() {
+        for (auto& venue : live_) for (auto& side : venue) side.clear();
+        deaths_.clear();
+        for (auto& venue : counts_) venue.fill(0);
+        last_trade_ms_.fill(0);
+    }
+
+private:
+    std::array<std::array<std::vector<WallRecord>, 2>, N> live_;   // [venue][0 bid, 1 ask]
+    std::deque<WallRecord> deaths_;
+    std::array<std::array<uint64_t, WALL_FATES>, N> counts_{};
+    std::array<int64_t, N> last_trade_ms_{};
+    uint64_t next_id_ = 1;
+
+    // Minimum wall size: WALL_MULTIPLE × the mean of the top WALL_SCAN levels
+    template <typename Side>
+    static int64_t threshold(const Side& side) {
+        const size_t n = std::min(side.size(), WALL_SCAN);
+        if (n == 0) return INT64_MAX;
+        int64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += side.data()[i].qty_lots;
+        return std::max<int64_t>(1, sum * WALL_MULTIPLE / static_cast<int64_t>(n));
+    }
+
+    // bps from the touch of the wall's own side; 0 at (or through) it
+    static double distanceBps(const ExchangeBook& book, bool is_bid, int64_t px) {
+        const int64_t best = is_bid ? book.bids.bestPrice() : book.asks.bestPrice();
+        if (best <= 0) return 0;
+        const int64_t behind = is_bid ? best - px : px - best;
+        return behind > 0 ? static_cast<double>(behind) / static_cast<double>(best) * 1e4 : 0;
+    }
+
+    // thr: the side's threshold, computed on the first level that could be
+    // a new wall (−1 until then) and reused for the rest of the batch
+    void level(size_t v, bool is_bid, int64_t px, int64_t lots, const ExchangeBook& book, int64_t& thr, int64_t now_ms) {
+        auto& walls = live_[v][is_bid ? 0 : 1];
+        for (size_t k = 0; k < walls.size(); ++k) {
+            WallRecord& w = walls[k];
+            if (w.price_raw != px) continue;
+            const int64_t next = std::max<int64_t>(0, lots);
+            if (next < w.lots) {
+                const int64_t best = is_bid ? book.bids.bestPrice() : book.asks.bestPrice();
+                const bool at_touch = best == 0 || (is_bid ? px >= best : px <= best);
+                (at_touch ? w.at_touch_lots : w.behind_lots) += w.lots - next;
+            }
+            resize(w, next, now_ms);
+            if (next < static_cast<int64_t>(static_cast<double>(w.peak_lots) * WALL_DEATH_FRACTION)) {
+                w.death_bps = distanceBps(book, is_bid, px);
+                die(walls, k, WallFate::LIVE, now_ms);
+            }
+            return;
+        }
+        if (lots <= 0 || walls.size() >= WALL_MAX_LIVE) return;
+        if (thr < 0) thr = is_bid ? threshold(book.bids) : threshold(book.asks);
+        if (lots >= thr) {
+            const double bps = distanceBps(book, is_bid, px);
+            if (bps <= WALL_RANGE_BPS) born(walls, v, is_bid, px, lots, bps, now_ms);
+        }
+    }
+
+    template <typename Side>
+    void rescan(size_t v, bool is_bid, const Side& side, const ExchangeBook& book, int64_t now_ms) {
+        auto& walls = live_[v][is_bid ? 0 : 1];
+        const Level* levels = side.data();
+        const size_t n = side.size();
+        auto find = [&](int64_t px) -> int64_t {
+            for (size_t i = 0; i < n; ++i) {
+                if (levels[i].price_raw == px) return levels[i].qty_lots;
+                if (is_bid ? levels[i].price_raw < px : levels[i].price_raw > px) break;
+            }
+            return 0;
+        };
+        for (size_t k = walls.size(); k-- > 0;) {
+            WallRecord& w = walls[k];
+            const int64_t lots = find(w.price_raw);
+            if (lots < static_cast<int64_t>(static_cast<double>(w.peak_lots) * WALL_DEATH_FRACTION)) {
+                die(walls, k, WallFate::RESET, now_ms);
+            } else if (lots != w.lots) {
+                resize(w, lots, now_ms);
+            }
+        }
+        const int64_t thr = threshold(side);
+        for (size_t i = 0; i < n && walls.size() < WALL_MAX_LIVE; ++i) {
+            const double bps = distanceBps(book, is_bid, levels[i].price_raw);
+            if (bps > WALL_RANGE_BPS) break;
+            if (levels[i].qty_lots < thr) continue;
+            const bool known = std::any_of(walls.begin(), walls.end(),
+                                           [&](const WallRecord& w) { return w.price_raw == levels[i].price_raw; });
+            if (!known) born(walls, v, is_bid, levels[i].price_raw, levels[i].qty_lots, bps, now_ms);
+        }
+    }
+
+    // Distances follow the touch; walls it has left behind are dropped
+    void touchMoved(size_t v, const ExchangeBook& book, int64_t now_ms) {
+        for (int s = 0; s < 2; ++s) {
+            auto& walls = live_[v][s];
+            for (size_t k = walls.size(); k-- > 0;) {
+                WallRecord& w = walls[k];
+                const double bps = distanceBps(book, w.is_bid, w.price_raw);
+                w.min_bps = std::min(w.min_bps, bps);
+                if (bps > WALL_RANGE_BPS) {
+                    w.death_bps = bps;
+                    die(walls, k, WallFate::OUT_OF_RANGE, now_ms);
+                }
+            }
+        }
+    }
+
+    void born(std::vector<WallRecord>& walls, size_t v, bool is_bid, int64_t px, int64_t lots, double bps, int64_t now_ms) {
+        WallRecord w;
+        w.id        = next_id_++;
+        w.exchange  = static_cast<uint8_t>(v);
+        w.is_bid    = is_bid;
+        w.price_raw = px;
+        w.born_ms   = now_ms;
+        w.lots      = w.peak_lots = lots;
+        w.birth_bps = w.min_bps = bps;
+        w.history.push_back(WallPoint{ now_ms, lots });
+        walls.push_back(std::move(w));
+    }
+
+    static void resize(WallRecord& w, int64_t lots, int64_t now_ms) {
+        if (lots == w.lots) return;
+        w.lots      = lots;
+        w.peak_lots = std::max(w.peak_lots, lots);
+        if (w.history.size() >= WALL_HISTORY) w.history.erase(w.history.begin() + 1);   // keep the birth point
+        w.history.push_back(WallPoint{ now_ms, lots });
+    }
+
+    // fate LIVE = classify from how the size left
+    void die(std::vector<WallRecord>& walls, size_t k, WallFate fate, int64_t now_ms) {
+        WallRecord w = std::move(walls[k]);
+        walls.erase(walls.begin() + static_cast<std::ptrdiff_t>(k));
+        w.died_ms   = now_ms;
+        w.trade_fed = last_trade_ms_[w.exchange] != 0 && now_ms - last_trade_ms_[w.exchange] <= WALL_TRADE_FEED_MS;
+        w.fate      = fate == WallFate::LIVE ? classify(w) : fate;
+        ++counts_[w.exchange][static_cast<size_t>(w.fate)];
+        if (deaths_.size() >= WALL_DEATHS) deaths_.pop_front();
+        deaths_.push_back(std::move(w));
+    }
+
+    static WallFate classify(const WallRecord& w) {
+        const int64_t removed = w.removedLots();
+        if (removed > 0 && w.filledLots() * 2 >= removed) return WallFate::FILLED;
+        if (w.death_bps <= WALL_APPROACH_BPS && w.death_bps < w.birth_bps) return WallFate::SPOOFED;
+        return WallFate::PULLED;
+    }
+
+    void recount(WallRecord& w, WallFate fate) {
+        if (fate == w.fate) return;
+        --counts_[w.exchange][static_cast<size_t>(w.fate)];
+        ++counts_[w.exchange][static_cast<size_t>(fate)];
+        w.fate = fate;
+    }
+};
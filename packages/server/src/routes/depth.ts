@@ -0,0 +1,60 @@
+import type { FastifyInstance } from 'fastify';
+import { orderbookEngine } from '../engines/signals/orderbook.js';
+
+export async function depthRoutes(app: FastifyInstance): Promise<void> {
+    /**
+     * GET /api/depth-history?symbol=BTCUSDT&from=..&to=..&lo=..&hi=..&bins=1000
+     *
+     * Liquidity heatmap window from the native depth history: the body is
+     * the raw little-endian float32 grid [bin * rows + row], dimensions in
+     * the X-Depth-* headers. 404 when nothing in range was recorded.
+     */
+    app.get('/api/depth-history', async (req, reply) => {
+        const { symbol = 'BTCUSDT', from, to, lo, hi, bins = '1000' } = req.query as Record<string, string>;
+        const fromMs = Number(from), toMs = Number(to), priceLo = Number(lo), priceHi = Number(hi);
+        if (![fromMs, toMs, priceLo, priceHi].every(Number.isFinite)) {
+            return reply.code(400).send({ error: 'from, to, lo and hi are required' });
+        }
+
+        const slice = orderbookEngine.readDepthHistory(symbol, fromMs, toMs, priceLo, priceHi,
+            Math.min(parseInt(bins) || 1000, 10000));
+        if (!slice) return reply.code(404).send({ error: 'No depth history in range' });
+
+        return reply
+            .header('X-Depth-From', slice.from)
+            .header('X-Depth-Bin-Ms', slice.bin_ms)
+            .header('X-Depth-Bins', slice.bins)
+            .header('X-Depth-Rows', slice.rows)
+            .header('X-Depth-Price0', slice.price0)
+            .header('X-Depth-Step', slice.step)
+            .type('application/octet-stream')
+            .send(Buffer.from(slice.qty.buffer, slice.qty.byteOffset, slice.qty.byteLength));
+    });
+
+    /**
+     * GET /api/lead-lag?symbol=BTCUSDT
+     *
+     * Cross-exchange lead-lag matrix over the last minute (see
+     * OrderbookEngine.getLeadLag). 404 until the first estimate, a second
+     * after the symbol first quoted.
+     */
+    app.get('/api/lead-lag', async (req, reply) => {
+        const { symbol = 'BTCUSDT' } = req.query as Record<string, string>;
+        const leadLag = orderbookEngine.getLeadLag(symbol);
+        if (!leadLag) return reply.code(404).send({ error: 'No lead-lag estimate yet' });
+        return leadLag;
+    });
+
+    /**
+     * GET /api/walls?symbol=BTCUSDT
+     *
+     * Live walls per exchange with their ages and size history, the most
+     * recent deaths and how each went (see OrderbookEngine.getWalls).
+     */
+    app.get('/api/walls', async (req, reply) => {
+        const { symbol = 'BTCUSDT' } = req.query as Record<string, string>;
+        const walls = orderbookEngine.getWalls(symbol);
+        if (!walls) return reply.code(500).send({ error: 'Wall tracker unavailable' });
+        return walls;
+    });
+}
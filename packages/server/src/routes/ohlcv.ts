@@ -3,6 +3,15 @@ import { binanceAdapter } from '../adapters/binance.js';
 import { query } from '../db/timescale.js';
 import { redis } from '../db/redis.js';
 import { logger } from '../logger.js';
+import { aggregatedCandleEngine } from '../engines/core/AggregatedCandleEngine.js';
+
+const UNIT_SEC: Record<string, number> = { s: 1, m: 60, h: 3600, d: 86400 };
+
+// "1m", "15s", "4h" … → seconds, 0 when malformed
+function intervalSeconds(interval: string): number {
+    const m = /^(\d+)([smhd])$/.exec(interval);
+    return m ? parseInt(m[1]) * UNIT_SEC[m[2]] : 0;
+}
 
 export async function ohlcvRoutes(app: FastifyInstance): Promise<void> {
     /**
@@ -99,6 +108,10 @@ export async function ohlcvRoutes(app: FastifyInstance): Promise<void> {
 
     /**
      * GET /api/ohlcv/aggregated?symbol=BTCUSDT&interval=1m&limit=500
+     *
+     * The part of the window the native trade tape still holds is resampled
+     * from it at any interval ("30s", "2m", "3h" …); only the older rest
+     * comes from aggregated_candles.
      */
     app.get('/api/ohlcv/aggregated', async (req, reply) => {
         const { symbol = 'BTCUSDT', interval = '1m', limit = '500' } = req.query as Record<string, string>;
@@ -113,7 +126,24 @@ export async function ohlcvRoutes(app: FastifyInstance): Promise<void> {
             '4h': 14400,
             '1d': 86400
         };
+
         const intervalSec = intervalMap[interval] || 60;
+        let dbLimit = numLimit;
+        let beforeMs: number | null = null;
+        let tapeCandles: ReturnType<typeof aggregatedCandleEngine.getTapeCandles> = [];
+        const tapeSec = intervalSeconds(interval);
+        const startMs = tapeSec > 0 ? aggregatedCandleEngine.tapeStartMs(symbol) : null;
+        if (startMs !== null) {
+            const bucketMs = tapeSec * 1000;
+            const now = Date.now();
+            const fromMs = (Math.floor(now / bucketMs) - numLimit + 1) * bucketMs;
+            // First bucket the tape holds whole; the DB answers for older ones
+            const tapeFromMs = Math.max(fromMs, Math.ceil(startMs / bucketMs) * bucketMs);
+            tapeCandles = aggregatedCandleEngine.getTapeCandles(symbol, tapeFromMs, now, tapeSec);
+            if (tapeFromMs === fromMs || !(interval in intervalMap)) return reply.send(tapeCandles);
+            dbLimit = (tapeFromMs - fromMs) / bucketMs;
+            beforeMs = tapeFromMs;
+        }
 
         try {
             const dbResult = await query(
@@ -122,12 +152,13 @@ export async function ohlcvRoutes(app: FastifyInstance): Promise<void> {
                   open, high, low, close, volume, vwap, trade_count
                  FROM aggregated_candles 
                  WHERE symbol = $1 AND interval_sec = $2
+                   AND ($4::bigint IS NULL OR time < to_timestamp($4::bigint / 1000.0))
                  ORDER BY time DESC
                  LIMIT $3`,
-                [symbol.toUpperCase(), intervalSec, numLimit],
+                [symbol.toUpperCase(), intervalSec, dbLimit, beforeMs],
             );
 
-            return reply.send(dbResult.rows.reverse());
+            return reply.send([...dbResult.rows.reverse(), ...tapeCandles]);
         } catch (err) {
             logger.error({ err, symbol, interval }, 'Aggregated OHLCV route error');
             return reply.code(500).send({
@@ -136,4 +167,23 @@ export async function ohlcvRoutes(app: FastifyInstance): Promise<void> {
             });
         }
     });
+
+    /**
+     * GET /api/trades?symbol=BTCUSDT&from=..&to=..&limit=1000
+     *
+     * Recent trades across exchanges from the native trade tape, oldest
+     * first; past `limit` the newest are returned. `from` defaults to the
+     * last minute, `to` to now. Only the tape's window (TRADE_TAPE_HOURS)
+     * is available.
+     */
+    app.get('/api/trades', async (req, reply) => {
+        const { symbol = 'BTCUSDT', from, to, limit = '1000' } = req.query as Record<string, string>;
+        const toMs = to ? Number(to) : Date.now();
+        const fromMs = from ? Number(from) : toMs - 60_000;
+        if (!Number.isFinite(fromMs) || !Number.isFinite(toMs)) {
+            return reply.code(400).send({ error: 'from and to must be epoch milliseconds' });
+        }
+        const numLimit = Math.min(parseInt(limit) || 1000, 100000);
+        return reply.send(aggregatedCandleEngine.getTapeTrades(symbol, fromMs, toMs, numLimit));
+    });
 }
@@ -192,6 +192,23 @@ export class ClientHub {
         logger.info({ clientId, ip: client.ip }, 'Client disconnected');
     }
 
+    /**
+     * Whether anyone is subscribed — lets producers skip building payloads.
+     */
+    hasSubscribers(topic: WSTopic): boolean {
+        return (this.topicSubscribers.get(topic)?.size ?? 0) > 0;
+    }
+
+    /**
+     * Whether any topic starting with `prefix` has a subscriber.
+     */
+    hasSubscribersWithPrefix(prefix: string): boolean {
+        for (const [topic, subs] of this.topicSubscribers) {
+            if (subs.size > 0 && topic.startsWith(prefix)) return true;
+        }
+        return false;
+    }
+
     /**
      * Broadcast a message to all clients subscribed to a topic.
      * Implements backpressure: drops messages if the client socket
@@ -0,0 +1,50 @@
+import bindings from 'bindings';
+import { logger } from '../logger.js';
+
+const core = bindings('terminus_core');
+
+// ══════════════════════════════════════════════════════════════
+//  Shared Book Reader — for WS fan-out processes
+//  Attaches to the ingest process's shared-memory book mirror
+//  (`${ORDERBOOK_SHM_NAME}_${SYMBOL}`) and reads the latest aggregated snapshot
+//  straight out of the mapping, only when its version moved.
+// ══════════════════════════════════════════════════════════════
+
+export class SharedBookReader {
+    private lastVersion = 0;
+    private reader: number | null = null;   // native reader id, one per segment
+
+    constructor(private readonly segment: string) { }
+
+    /**
+     * Map the segment. Fails until the ingest process has created it,
+     * so callers may retry.
+     */
+    attach(): boolean {
+        this.reader = core.attachSharedMirror(this.segment);
+        if (this.reader !== null) {
+            logger.info({ segment: this.segment }, 'Attached to shared orderbook mirror');
+        }
+        return this.reader !== null;
+    }
+
+    /**
+     * Unmap the segment; the next poll attaches again.
+     */
+    detach(): void {
+        if (this.reader === null) return;
+        core.detachSharedMirror(this.reader);
+        this.reader = null;
+    }
+
+    /**
+     * Latest aggregated snapshot, or null if unchanged since the last poll.
+     */
+    poll(): any | null {
+        if (this.reader === null && !this.attach()) return null;
+        const snap = core.readSharedMirror(this.reader, this.lastVersion);
+        if (!snap) return null;
+        this.lastVersion = snap.version;
+        return snap;
+    }
+}
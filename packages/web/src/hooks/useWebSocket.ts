@@ -4,6 +4,7 @@ import { usePerfStore } from '../stores/usePerfStore';
 import { useRef, useEffect, useCallback } from 'react';
 import { createWorker } from '../engines/websocketWorker';
 import { CandleData } from '../types';
+import { applyOrderbookDiff, VersionedOrderbook } from '../lib/orderbookDiff';
 
 interface WSMessage {
     topic: string;
@@ -33,6 +34,7 @@ export function useWebSocket() {
     const activeCandleTopic = useRef<string | null>(null);
 
     const pendingOrderbook = useRef<any>(null);
+    const orderbookBase = useRef<VersionedOrderbook | null>(null);   // last applied version
     const pendingLiquidations = useRef<any>(null);
     const pendingConfluence = useRef<any>(null);
     const pendingQuant = useRef<any>(null);
@@ -141,6 +143,7 @@ export function useWebSocket() {
                         initialTopic,
                         `candles.aggregated.${symbol.toUpperCase()}.${timeframe}`,
                         'orderbook.aggregated',
+                        'orderbook.aggregated.diff',
                         'orderbook.deep',
                         'options.analytics',
                         'liquidations',
@@ -283,8 +286,18 @@ export function useWebSocket() {
 
                 switch (msg.topic) {
                     case 'orderbook.aggregated':
+                        orderbookBase.current = msg.data;
                         pendingOrderbook.current = msg.data;
                         break;
+                    case 'orderbook.aggregated.diff': {
+                        // Ignored (null) if we missed one — next full snapshot resyncs
+                        const next = applyOrderbookDiff(orderbookBase.current, msg.data);
+                        if (next) {
+                            orderbookBase.current = next;
+                            pendingOrderbook.current = next;
+                        }
+                        break;
+                    }
                     case 'orderbook.deep':
                         setDeepOrderbook(msg.data as any);
                         break;
@@ -0,0 +1,59 @@
+import { OrderbookData, OrderbookLevel } from '../types';
+
+// ── Incremental aggregated-orderbook updates ─────────────────────────────────
+// The server sends a full `orderbook.aggregated` snapshot (with `version`)
+// every few seconds and `orderbook.aggregated.diff` messages in between.
+// A diff only applies on top of the exact version it was cut from; on a
+// mismatch (dropped message) it is ignored until the next full snapshot.
+
+export interface OrderbookDiff {
+    version: number;
+    from: number;
+    time: number;
+    best_bid: number;
+    best_ask: number;
+    spread: number;
+    mid_price: number;
+    bids: [number, number][];   // [price, qty], qty 0 = remove
+    asks: [number, number][];
+    walls?: OrderbookData['walls'];
+}
+
+export type VersionedOrderbook = OrderbookData & { version: number; [key: string]: unknown };
+
+function patchSide(levels: OrderbookLevel[], changes: [number, number][], descending: boolean): OrderbookLevel[] {
+    if (changes.length === 0) return levels;
+
+    const byPrice = new Map<number, number>();
+    for (const l of levels) byPrice.set(l.price, l.qty);
+    for (const [price, qty] of changes) {
+        if (qty === 0) byPrice.delete(price);
+        else byPrice.set(price, qty);
+    }
+
+    const out: OrderbookLevel[] = [];
+    for (const [price, qty] of byPrice) out.push({ price, qty });
+    out.sort(descending ? (a, b) => b.price - a.price : (a, b) => a.price - b.price);
+    return out;
+}
+
+/**
+ * Apply a diff to the book it was cut from. Returns null if `base` is not
+ * at `diff.from` — caller should wait for the next full snapshot.
+ */
+export function applyOrderbookDiff(base: VersionedOrderbook | null, diff: OrderbookDiff): VersionedOrderbook | null {
+    if (!base || base.version !== diff.from) return null;
+
+    return {
+        ...base,
+        version: diff.version,
+        time: diff.time,
+        best_bid: diff.best_bid,
+        best_ask: diff.best_ask,
+        spread: diff.spread,
+        mid_price: diff.mid_price,
+        bids: patchSide(base.bids, diff.bids, true),
+        asks: patchSide(base.asks, diff.asks, false),
+        walls: diff.walls ?? base.walls,
+    };
+}